@@ -2,6 +2,7 @@
 #include "screen.h"
 #include "configs.h"
 #include "keys.h"
+#include "profiler.h"
 
 #if !defined PBL_PLATFORM_APLITE
 static bool initialized;
@@ -36,61 +37,99 @@ void reset_tap_handler() {
     redraw_screen(watchface_ref);
 }
 
+// the high-pass filter divides by FACTOR, so while it is below HIGH_THRESHOLD a
+// step smaller than QUIET_STEP can never push it over the threshold
+#define FACTOR 4
+#define HIGH_THRESHOLD 40
+#define LOW_THRESHOLD 10
+#define THRESHOLD_OTHER_AXIS 15
+#define RANGE 2
+#define X_THRESHOLD 350
+#define Y_THRESHOLD 150
+#define QUIET_STEP ((FACTOR - 1) * HIGH_THRESHOLD)
+
+static bool is_quiet_batch(AccelData *data, uint32_t num_samples) {
+    if (begin_tap || abs(lastPassZ) >= HIGH_THRESHOLD) {
+        return false;
+    }
+
+    int prev_z = lastZ;
+    for (int i = 0; i < (int)num_samples; ++i) {
+        int step = data[i].z - prev_z;
+        if (data[i].did_vibrate || step >= QUIET_STEP || step <= -QUIET_STEP) {
+            return false;
+        }
+        prev_z = data[i].z;
+    }
+    return true;
+}
+
+static void filter_batch(AccelData *data, uint32_t num_samples) {
+    int pass_x = lastPassX;
+    int pass_y = lastPassY;
+    int pass_z = lastPassZ;
+    int prev_x = lastX;
+    int prev_y = lastY;
+    int prev_z = lastZ;
+    for (int i = 0; i < (int)num_samples; ++i) {
+        pass_x = (pass_x + data[i].x - prev_x) / FACTOR;
+        pass_y = (pass_y + data[i].y - prev_y) / FACTOR;
+        pass_z = (pass_z + data[i].z - prev_z) / FACTOR;
+        prev_x = data[i].x;
+        prev_y = data[i].y;
+        prev_z = data[i].z;
+    }
+
+    lastPassX = pass_x;
+    lastPassY = pass_y;
+    lastPassZ = pass_z;
+    lastX = prev_x;
+    lastY = prev_y;
+    lastZ = prev_z;
+}
+
 void accel_data_handler(AccelData *data, uint32_t num_samples) {
     if (show_tap_mode) {
         return;
     }
-
-    int passX[2];
-    int passY[2];
-    int passZ[2];
-    int Z[2];
-    int X[2];
-    int Y[2];
+    profile_begin(PROFILE_ACCEL);
+    profile_count(COUNTER_ACCEL_SAMPLES, num_samples);
 
     if (!initialized) {
-        passX[0] = passX[1] = data[0].x;
-        passY[0] = passY[1] = data[0].y;
-        passZ[0] = passZ[1] = data[0].z;
-        Z[0] = Z[1] = data[0].z;
-        X[0] = X[1] = data[0].x;
-        Y[0] = Y[1] = data[0].y;
+        lastPassX = lastX = data[0].x;
+        lastPassY = lastY = data[0].y;
+        lastPassZ = lastZ = data[0].z;
         initialized = true;
         show_tap_mode = false;
         reset_tap();
-    } else {
-        passX[0] = passX[1] = lastPassX;
-        passY[0] = passY[1] = lastPassY;
-        passZ[0] = passZ[1] = lastPassZ;
-        X[0] = X[1] = lastX;
-        Y[0] = Y[1] = lastY;
-        Z[0] = Z[1] = lastZ;
     }
 
-    int factor = 4;
-    int high_threshold = 40;
-    int low_threshold = 10;
-    int threshold_other_axis = 15;
-    int range = 2;
-    int x_threshold = 350;
-    int y_threshold = 150;
+    // nothing in this batch can start a tap, so only the filter state has to advance
+    if (is_quiet_batch(data, num_samples)) {
+        filter_batch(data, num_samples);
+        profile_count(COUNTER_ACCEL_QUIET, num_samples);
+        profile_end(PROFILE_ACCEL);
+        return;
+    }
+
+    int pass_x = lastPassX;
+    int pass_y = lastPassY;
+    int pass_z = lastPassZ;
+    int prev_x = lastX;
+    int prev_y = lastY;
+    int prev_z = lastZ;
     for (int i = 0; i < (int)num_samples; ++i) {
         if (data[i].did_vibrate) {
             reset_tap();
             continue;
         }
-        Z[1] = data[i].z;
-        X[1] = data[i].x;
-        Y[1] = data[i].y;
 
-        passX[1] = (int) ((passX[0] + X[1] - X[0])/factor);
-        passY[1] = (int) ((passY[0] + Y[1] - Y[0])/factor);
-        passZ[1] = (int) ((passZ[0] + Z[1] - Z[0])/factor);
+        int next_z = (pass_z + data[i].z - prev_z) / FACTOR;
 
         if (!end_tap && mid_tap) {
-            if (end_tap_count < 3*range) {
+            if (end_tap_count < 3*RANGE) {
                 end_tap_count++;
-                if (abs(passZ[1]) <= abs(low_threshold)) {
+                if (abs(next_z) <= LOW_THRESHOLD) {
                     end_tap = true;
                 }
             } else {
@@ -99,9 +138,9 @@ void accel_data_handler(AccelData *data, uint32_t num_samples) {
         }
 
         if (!mid_tap && begin_tap) {
-            if (mid_tap_count < range) {
+            if (mid_tap_count < RANGE) {
                 mid_tap_count++;
-                if ((neg && passZ[1] >= high_threshold) || (!neg && passZ[1] <= -1*high_threshold)) {
+                if ((neg && next_z >= HIGH_THRESHOLD) || (!neg && next_z <= -HIGH_THRESHOLD)) {
                     mid_tap = true;
                 }
             } else {
@@ -110,37 +149,40 @@ void accel_data_handler(AccelData *data, uint32_t num_samples) {
         }
 
         if (
-            (abs(passZ[0]) <= low_threshold) &&
-            ((abs(X[0]) <= x_threshold &&
-                Y[0] <= y_threshold)) &&
-            ((abs(passX[0]) <= threshold_other_axis &&
-                abs(passY[0]) <= threshold_other_axis)) &&
-            abs(passZ[1]) >= high_threshold &&
-            !begin_tap
+            !begin_tap &&
+            abs(pass_z) <= LOW_THRESHOLD &&
+            abs(next_z) >= HIGH_THRESHOLD &&
+            abs(prev_x) <= X_THRESHOLD &&
+            prev_y <= Y_THRESHOLD &&
+            abs(pass_x) <= THRESHOLD_OTHER_AXIS &&
+            abs(pass_y) <= THRESHOLD_OTHER_AXIS
         ) {
             begin_tap = true;
-            neg = passZ[1] < 0;
+            neg = next_z < 0;
         }
 
         if (begin_tap && mid_tap && end_tap) {
             show_tap_mode = true;
             reset_tap();
+            profile_count(COUNTER_TAPS, 1);
             redraw_screen(watchface_ref);
         }
-        passX[0] = passX[1];
-        passY[0] = passY[1];
-        passZ[0] = passZ[1];
-        Z[0] = Z[1];
-        X[0] = X[1];
-        Y[0] = Y[1];
+
+        pass_x = (pass_x + data[i].x - prev_x) / FACTOR;
+        pass_y = (pass_y + data[i].y - prev_y) / FACTOR;
+        pass_z = next_z;
+        prev_x = data[i].x;
+        prev_y = data[i].y;
+        prev_z = data[i].z;
     }
 
-    lastPassX = passX[1];
-    lastPassY = passY[1];
-    lastPassZ = passZ[1];
-    lastX = X[1];
-    lastY = Y[1];
-    lastZ = Z[1];
+    lastPassX = pass_x;
+    lastPassY = pass_y;
+    lastPassZ = pass_z;
+    lastX = prev_x;
+    lastY = prev_y;
+    lastZ = prev_z;
+    profile_end(PROFILE_ACCEL);
 }
 
 
@@ -169,7 +211,7 @@ void shake_data_handler(AccelAxisType axis, int32_t direction) {
 }
 
 void init_accel_service(Window * watchface) {
-    timeout_sec = persist_exists(KEY_TAPTIME) ? persist_read_int(KEY_TAPTIME) : 7;
+    timeout_sec = get_tap_timeout();
     watchface_ref = watchface;
 
     #if !defined PBL_PLATFORM_APLITE
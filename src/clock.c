@@ -4,6 +4,7 @@
 #include "locales.h"
 #include "configs.h"
 #include "keys.h"
+#include "accel.h"
 
 static signed int tz_hour;
 static uint8_t tz_minute;
@@ -14,6 +15,9 @@ static uint8_t tz_minute_b;
 static char tz_name_b[TZ_LEN];
 #endif
 
+static TickHandler tick_handler_ref;
+static TimeUnits tick_units;
+
 void set_hours(struct tm* tick_time, char* hour_text, int hour_text_len) {
     if (!is_leading_zero_disabled()) {
         strftime(hour_text, hour_text_len, (clock_is_24h_style() ? "%H:%M" : "%I:%M"), tick_time);
@@ -92,7 +96,7 @@ void update_time() {
     #endif
 
     set_hours_layer_text(hour_text);
-    get_current_date(tick_time, date_text, sizeof(date_text), persist_exists(KEY_DATESEPARATOR) ? persist_read_int(KEY_DATESEPARATOR) : 1);
+    get_current_date(tick_time, date_text, sizeof(date_text), get_date_separator());
     set_date_layer_text(date_text);
 }
 
@@ -112,20 +116,6 @@ void load_timezone_from_storage() {
     #endif
 }
 
-void set_timezone(char *name, int hour, int minute) {
-   strcpy(tz_name, name);
-   tz_hour = hour;
-   tz_minute = minute;
-}
-
-#if !defined PBL_PLATFORM_APLITE
-void set_timezone_b(char *name, int hour, int minute) {
-   strcpy(tz_name_b, name);
-   tz_hour_b = hour;
-   tz_minute_b = minute;
-}
-#endif
-
 void update_seconds(struct tm* tick_time) {
     if (is_module_enabled(MODULE_SECONDS)) {
         char seconds_text[4];
@@ -135,3 +125,26 @@ void update_seconds(struct tm* tick_time) {
         set_seconds_layer_text("");
     }
 }
+
+void init_tick_service(TickHandler handler) {
+    tick_handler_ref = handler;
+    tick_units = 0;
+    update_tick_service();
+}
+
+void update_tick_service() {
+    if (!tick_handler_ref) {
+        return;
+    }
+
+    // second ticks only while the seconds module or the tap/wrist countdown is on screen
+    TimeUnits units = MINUTE_UNIT;
+    if (is_module_enabled(MODULE_SECONDS) || tap_mode_visible() || wrist_mode_visible()) {
+        units = SECOND_UNIT;
+    }
+
+    if (units != tick_units) {
+        tick_units = units;
+        tick_timer_service_subscribe(units, tick_handler_ref);
+    }
+}
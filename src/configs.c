@@ -3,154 +3,415 @@
 #include "keys.h"
 #include "health.h"
 #include "accel.h"
-
-static bool configs_loaded;
-static bool modules_loaded;
-static int configs;
-static uint8_t modules[6];
-#if !defined PBL_PLATFORM_APLITE
-static uint8_t modules_sleep[6];
-static uint8_t modules_tap[6];
-static uint8_t modules_wrist[6];
-#endif
+#include "profiler.h"
+
+#define SETTINGS_VERSION 1
+
+// everything the config page sets, stored as a single record under KEY_SETTINGS;
+// must stay below PERSIST_DATA_MAX_LENGTH (256 bytes)
+struct Settings {
+    uint8_t version;
+    uint8_t font_type;
+    uint8_t text_align;
+    uint8_t locale;
+    uint8_t date_format;
+    uint8_t date_separator;
+    uint8_t speed_unit;
+    uint8_t tap_timeout;
+    int16_t weather_interval;
+    int16_t crypto_interval;
+    int16_t phonebattery_interval;
+    int16_t heart_low;
+    int16_t heart_high;
+    int32_t toggles;
+    uint8_t modules[4][6];
+    uint64_t colors_stored;
+    int32_t colors[NUM_COLORS];
+};
+
+static bool settings_loaded;
+static bool settings_dirty;
+static struct Settings settings;
+
+// reverse lookup of settings.modules: slot of each module per state, -1 when unused
+static int8_t module_slots[4][NUM_MODULES];
+static uint32_t module_masks[4];
 static bool center_slots_enabled = true;
 
+static uint8_t color_keys[NUM_COLORS] = {
+    KEY_BGCOLOR,
+    KEY_HOURSCOLOR,
+    KEY_ALTHOURSCOLOR,
+    KEY_ALTHOURSBCOLOR,
+    KEY_DATECOLOR,
+    KEY_BLUETOOTHCOLOR,
+    KEY_UPDATECOLOR,
+    KEY_QUIETTIMECOLOR,
+    KEY_BATTERYCOLOR,
+    KEY_BATTERYLOWCOLOR,
+    KEY_PHONEBATTERYCOLOR,
+    KEY_PHONEBATTERYLOWCOLOR,
+    KEY_TEMPCOLOR,
+    KEY_WEATHERCOLOR,
+    KEY_MINCOLOR,
+    KEY_MAXCOLOR,
+    KEY_WINDDIRCOLOR,
+    KEY_WINDSPEEDCOLOR,
+    KEY_COMPASSCOLOR,
+    KEY_SUNRISECOLOR,
+    KEY_SUNSETCOLOR,
+    KEY_SECONDSCOLOR,
+    KEY_CRYPTOCOLOR,
+    KEY_CRYPTOBCOLOR,
+    KEY_CRYPTOCCOLOR,
+    KEY_CRYPTODCOLOR,
+    KEY_CUSTOMTEXTACOLOR,
+    KEY_CUSTOMTEXTBCOLOR,
+    KEY_STEPSCOLOR,
+    KEY_STEPSBEHINDCOLOR,
+    KEY_DISTCOLOR,
+    KEY_DISTBEHINDCOLOR,
+    KEY_CALCOLOR,
+    KEY_CALBEHINDCOLOR,
+    KEY_SLEEPCOLOR,
+    KEY_SLEEPBEHINDCOLOR,
+    KEY_DEEPCOLOR,
+    KEY_DEEPBEHINDCOLOR,
+    KEY_ACTIVECOLOR,
+    KEY_ACTIVEBEHINDCOLOR,
+    KEY_HEARTCOLOR,
+    KEY_HEARTCOLOROFF,
+};
+
+static uint8_t slot_keys[4][6] = {
+    { KEY_SLOTA, KEY_SLOTB, KEY_SLOTC, KEY_SLOTD, KEY_SLOTE, KEY_SLOTF },
+    { KEY_SLEEPSLOTA, KEY_SLEEPSLOTB, KEY_SLEEPSLOTC, KEY_SLEEPSLOTD, KEY_SLEEPSLOTE, KEY_SLEEPSLOTF },
+    { KEY_TAPSLOTA, KEY_TAPSLOTB, KEY_TAPSLOTC, KEY_TAPSLOTD, KEY_TAPSLOTE, KEY_TAPSLOTF },
+    { KEY_WRISTSLOTA, KEY_WRISTSLOTB, KEY_WRISTSLOTC, KEY_WRISTSLOTD, KEY_WRISTSLOTE, KEY_WRISTSLOTF },
+};
+
+static uint8_t int_keys[] = {
+    KEY_FONTTYPE,
+    KEY_TEXTALIGN,
+    KEY_LOCALE,
+    KEY_DATEFORMAT,
+    KEY_DATESEPARATOR,
+    KEY_SPEEDUNIT,
+    KEY_TAPTIME,
+    KEY_WEATHERTIME,
+    KEY_CRYPTOTIME,
+    KEY_PHONEBATTERYTIME,
+    KEY_HEARTLOW,
+    KEY_HEARTHIGH,
+    KEY_CONFIGS,
+};
+static uint8_t num_int_keys = 13;
+
+static int read_setting(uint32_t key, int default_value) {
+    return persist_exists(key) ? persist_read_int(key) : default_value;
+}
+
+static void load_legacy_settings() {
+    settings.font_type = read_setting(KEY_FONTTYPE, LECO_FONT);
+    settings.text_align = read_setting(KEY_TEXTALIGN, ALIGN_RIGHT);
+    settings.locale = read_setting(KEY_LOCALE, LC_ENGLISH);
+    settings.date_format = read_setting(KEY_DATEFORMAT, FORMAT_WMD);
+    settings.date_separator = read_setting(KEY_DATESEPARATOR, 1);
+    settings.speed_unit = read_setting(KEY_SPEEDUNIT, UNIT_MPH);
+    settings.tap_timeout = read_setting(KEY_TAPTIME, 7);
+    settings.weather_interval = read_setting(KEY_WEATHERTIME, 30);
+    settings.crypto_interval = read_setting(KEY_CRYPTOTIME, 15);
+    settings.phonebattery_interval = read_setting(KEY_PHONEBATTERYTIME, 5);
+    settings.heart_low = read_setting(KEY_HEARTLOW, 0);
+    settings.heart_high = read_setting(KEY_HEARTHIGH, 0);
+    settings.toggles = read_setting(KEY_CONFIGS, 0);
+
+    for (int state = 0; state < 4; ++state) {
+        for (int slot = 0; slot < 6; ++slot) {
+            settings.modules[state][slot] = persist_read_int(slot_keys[state][slot]);
+        }
+    }
+
+    settings.colors_stored = 0;
+    for (int i = 0; i < NUM_COLORS; ++i) {
+        if (persist_exists(color_keys[i])) {
+            settings.colors_stored |= (uint64_t)1 << i;
+            settings.colors[i] = persist_read_int(color_keys[i]);
+        }
+    }
+}
+
+static void delete_legacy_settings() {
+    for (int i = 0; i < num_int_keys; ++i) {
+        persist_delete(int_keys[i]);
+    }
+    for (int state = 0; state < 4; ++state) {
+        for (int slot = 0; slot < 6; ++slot) {
+            persist_delete(slot_keys[state][slot]);
+        }
+    }
+    for (int i = 0; i < NUM_COLORS; ++i) {
+        persist_delete(color_keys[i]);
+    }
+}
+
+void save_settings() {
+    if (!settings_dirty) {
+        return;
+    }
+    settings.version = SETTINGS_VERSION;
+    persist_write_data(KEY_SETTINGS, &settings, sizeof(settings));
+    settings_dirty = false;
+}
+
+// the phone tags each config it sends with a generation; the watch keeps the
+// last one it saved and reports it, so the phone knows when to send everything
+int32_t get_config_generation() {
+    return persist_exists(KEY_CONFIGDONE) ? persist_read_int(KEY_CONFIGDONE) : 0;
+}
+
+void set_config_generation(int32_t generation) {
+    persist_write_int(KEY_CONFIGDONE, generation);
+}
+
+static void index_modules(int state) {
+    uint8_t *modules = settings.modules[state];
+    memset(module_slots[state], -1, sizeof(module_slots[state]));
+    module_masks[state] = 0;
+    // walk backwards so a module placed twice resolves to its first slot
+    for (int slot = 5; slot >= 0; --slot) {
+        if (modules[slot] < NUM_MODULES) {
+            module_slots[state][modules[slot]] = slot;
+            module_masks[state] |= (uint32_t)1 << modules[slot];
+        }
+    }
+}
+
+static void read_settings() {
+    if (persist_exists(KEY_SETTINGS) &&
+        persist_read_data(KEY_SETTINGS, &settings, sizeof(settings)) == sizeof(settings) &&
+        settings.version == SETTINGS_VERSION) {
+        return;
+    }
+
+    // first start after an update: move the per-key settings into the record.
+    // a fresh install has none and gets the defaults, which are saved too so
+    // the next launch reads the record instead of probing every legacy key
+    bool has_legacy = persist_exists(KEY_CONFIGS);
+    memset(&settings, 0, sizeof(settings));
+    persist_delete(KEY_CONFIGDONE);
+    load_legacy_settings();
+    settings_dirty = true;
+    save_settings();
+    if (has_legacy) {
+        delete_legacy_settings();
+    }
+}
+
+void load_settings() {
+    memset(&settings, 0, sizeof(settings));
+    settings_loaded = true;
+    settings_dirty = false;
+
+    read_settings();
+    for (int state = 0; state < 4; ++state) {
+        index_modules(state);
+    }
+}
+
+static struct Settings* get_settings() {
+    if (!settings_loaded) {
+        load_settings();
+    }
+    return &settings;
+}
+
+static void update_setting(void *field, const void *value, size_t size) {
+    if (memcmp(field, value, size)) {
+        memcpy(field, value, size);
+        settings_dirty = true;
+    }
+}
+
+void set_int_setting(uint32_t key, int value) {
+    struct Settings *current = get_settings();
+    uint8_t byte_value = value;
+    int16_t short_value = value;
+    int32_t long_value = value;
+
+    switch (key) {
+        case KEY_FONTTYPE: update_setting(&current->font_type, &byte_value, 1); break;
+        case KEY_TEXTALIGN: update_setting(&current->text_align, &byte_value, 1); break;
+        case KEY_LOCALE: update_setting(&current->locale, &byte_value, 1); break;
+        case KEY_DATEFORMAT: update_setting(&current->date_format, &byte_value, 1); break;
+        case KEY_DATESEPARATOR: update_setting(&current->date_separator, &byte_value, 1); break;
+        case KEY_SPEEDUNIT: update_setting(&current->speed_unit, &byte_value, 1); break;
+        case KEY_TAPTIME: update_setting(&current->tap_timeout, &byte_value, 1); break;
+        case KEY_WEATHERTIME: update_setting(&current->weather_interval, &short_value, 2); break;
+        case KEY_CRYPTOTIME: update_setting(&current->crypto_interval, &short_value, 2); break;
+        case KEY_PHONEBATTERYTIME: update_setting(&current->phonebattery_interval, &short_value, 2); break;
+        case KEY_HEARTLOW: update_setting(&current->heart_low, &short_value, 2); break;
+        case KEY_HEARTHIGH: update_setting(&current->heart_high, &short_value, 2); break;
+        case KEY_CONFIGS: update_setting(&current->toggles, &long_value, 4); break;
+    }
+}
+
+void set_color_setting(uint32_t key, int32_t value) {
+    struct Settings *current = get_settings();
+    for (int i = 0; i < NUM_COLORS; ++i) {
+        if (color_keys[i] == key) {
+            uint64_t stored = current->colors_stored | ((uint64_t)1 << i);
+            update_setting(&current->colors_stored, &stored, sizeof(stored));
+            update_setting(&current->colors[i], &value, sizeof(value));
+            return;
+        }
+    }
+}
+
 #if !defined PBL_PLATFORM_APLITE
 void set_module(int slot, int module, int state) {
-    if (state == STATE_NORMAL) {
-        modules[slot] = module;
-    } else if (state == STATE_SLEEP) {
-        modules_sleep[slot] = module;
-    } else if (state == STATE_TAP) {
-        modules_tap[slot] = module;
-    } else if (state == STATE_WRIST) {
-        modules_wrist[slot] = module;
-    }
+    uint8_t value = module;
+    update_setting(&get_settings()->modules[state][slot], &value, 1);
+    index_modules(state);
 }
 #else
 void set_module(int slot, int module, int state) {
-    modules[slot] = module;
+    uint8_t value = module;
+    update_setting(&get_settings()->modules[STATE_NORMAL][slot], &value, 1);
+    index_modules(STATE_NORMAL);
 }
 #endif
 
+int get_font_type() {
+    return get_settings()->font_type;
+}
+
+int get_text_align() {
+    return get_settings()->text_align;
+}
+
+int get_locale() {
+    return get_settings()->locale;
+}
+
+int get_date_format() {
+    return get_settings()->date_format;
+}
+
+int get_date_separator() {
+    return get_settings()->date_separator;
+}
+
 int get_wind_speed_unit() {
-    return persist_exists(KEY_SPEEDUNIT) ? persist_read_int(KEY_SPEEDUNIT) : UNIT_MPH;
-}
-
-static void load_modules() {
-    modules[SLOT_A] = persist_read_int(KEY_SLOTA);
-    modules[SLOT_B] = persist_read_int(KEY_SLOTB);
-    modules[SLOT_C] = persist_read_int(KEY_SLOTC);
-    modules[SLOT_D] = persist_read_int(KEY_SLOTD);
-    modules[SLOT_E] = persist_read_int(KEY_SLOTE);
-    modules[SLOT_F] = persist_read_int(KEY_SLOTF);
-    #if !defined PBL_PLATFORM_APLITE
-    modules_sleep[SLOT_A] = persist_read_int(KEY_SLEEPSLOTA);
-    modules_sleep[SLOT_B] = persist_read_int(KEY_SLEEPSLOTB);
-    modules_sleep[SLOT_C] = persist_read_int(KEY_SLEEPSLOTC);
-    modules_sleep[SLOT_D] = persist_read_int(KEY_SLEEPSLOTD);
-    modules_sleep[SLOT_E] = persist_read_int(KEY_SLEEPSLOTE);
-    modules_sleep[SLOT_F] = persist_read_int(KEY_SLEEPSLOTF);
-    modules_tap[SLOT_A] = persist_read_int(KEY_TAPSLOTA);
-    modules_tap[SLOT_B] = persist_read_int(KEY_TAPSLOTB);
-    modules_tap[SLOT_C] = persist_read_int(KEY_TAPSLOTC);
-    modules_tap[SLOT_D] = persist_read_int(KEY_TAPSLOTD);
-    modules_tap[SLOT_E] = persist_read_int(KEY_TAPSLOTE);
-    modules_tap[SLOT_F] = persist_read_int(KEY_TAPSLOTF);
-    modules_wrist[SLOT_A] = persist_read_int(KEY_WRISTSLOTA);
-    modules_wrist[SLOT_B] = persist_read_int(KEY_WRISTSLOTB);
-    modules_wrist[SLOT_C] = persist_read_int(KEY_WRISTSLOTC);
-    modules_wrist[SLOT_D] = persist_read_int(KEY_WRISTSLOTD);
-    modules_wrist[SLOT_E] = persist_read_int(KEY_WRISTSLOTE);
-    modules_wrist[SLOT_F] = persist_read_int(KEY_WRISTSLOTF);
-    #endif
-
-    modules_loaded = true;
+    return get_settings()->speed_unit;
 }
 
-#if !defined PBL_PLATFORM_APLITE
-bool is_module_enabled(int module) {
-    if (!modules_loaded) {
-        load_modules();
+int get_weather_interval() {
+    return get_settings()->weather_interval;
+}
+
+int get_crypto_interval() {
+    return get_settings()->crypto_interval;
+}
+
+int get_phonebattery_interval() {
+    return get_settings()->phonebattery_interval;
+}
+
+int get_tap_timeout() {
+    return get_settings()->tap_timeout;
+}
+
+int get_heart_low() {
+    return get_settings()->heart_low;
+}
+
+int get_heart_high() {
+    return get_settings()->heart_high;
+}
+
+bool has_color(uint8_t color) {
+    return get_settings()->colors_stored & ((uint64_t)1 << color);
+}
+
+int32_t get_color_value(uint8_t color) {
+    return get_settings()->colors[color];
+}
+
+GColor get_color(uint8_t color) {
+    return GColorFromHEX(get_color_value(color));
+}
+
+static int get_module_slot(int state, int module) {
+    if (!settings_loaded) {
+        load_settings();
     }
+    if (module < 0 || module >= NUM_MODULES) {
+        return -1;
+    }
+    return module_slots[state][module];
+}
+
+static bool is_slot_visible(int slot) {
+    return slot != -1 && (slot <= 3 || center_slots_enabled);
+}
+
+#if !defined PBL_PLATFORM_APLITE
+static int get_visible_state() {
     if (tap_mode_visible()) {
-        for (unsigned int i = 0; i < 6; ++i) {
-            if (modules_tap[i] == module) {
-                return i <= 3 || (i > 3 && center_slots_enabled);
-            }
-        }
+        return STATE_TAP;
     } else if (wrist_mode_visible()) {
-        for (unsigned int i = 0; i < 6; ++i) {
-            if (modules_wrist[i] == module) {
-                return i <= 3 || (i > 3 && center_slots_enabled);
-            }
-        }
+        return STATE_WRIST;
     } else if (should_show_sleep_data()) {
-        for (unsigned int i = 0; i < 6; ++i) {
-            if (modules_sleep[i] == module) {
-                return i <= 3 || (i > 3 && center_slots_enabled);
-            }
-        }
-    } else {
-        for (unsigned int i = 0; i < 6; ++i) {
-            if (modules[i] == module) {
-                return i <= 3 || (i > 3 && center_slots_enabled);
-            }
-        }
+        return STATE_SLEEP;
     }
-    return false;
+    return STATE_NORMAL;
 }
 
 bool is_module_enabled_any(int module) {
-    if (!modules_loaded) {
-        load_modules();
-    }
-    for (unsigned int i = 0; i < 6; ++i) {
-        if (modules[i] == module ||
-            modules_tap[i] == module ||
-            modules_wrist[i] == module ||
-            modules_sleep[i] == module) {
-            return i <= 3 || (i > 3 && center_slots_enabled);
+    int first_slot = -1;
+    for (int state = 0; state < 4; ++state) {
+        int slot = get_module_slot(state, module);
+        if (slot != -1 && (first_slot == -1 || slot < first_slot)) {
+            first_slot = slot;
         }
     }
-    return false;
+    return is_slot_visible(first_slot);
 }
-#else
-bool is_module_enabled(int module) {
-    if (!modules_loaded) {
-        load_modules();
-    }
-    for (unsigned int i = 0; i < 6; ++i) {
-        if (modules[i] == module) {
-            return i <= 3 || (i > 3 && center_slots_enabled);
-        }
+
+bool is_module_configured(int module) {
+    if (!settings_loaded) {
+        load_settings();
     }
-    return false;
+    uint32_t mask = module_masks[STATE_NORMAL] | module_masks[STATE_SLEEP] |
+        module_masks[STATE_TAP] | module_masks[STATE_WRIST];
+    return module >= 0 && module < NUM_MODULES && (mask & ((uint32_t)1 << module));
+}
+#else
+static int get_visible_state() {
+    return STATE_NORMAL;
 }
 
 bool is_module_enabled_any(int module) {
     return is_module_enabled(module);
 }
 
+bool is_module_configured(int module) {
+    return get_module_slot(STATE_NORMAL, module) != -1;
+}
 #endif
 
-static int load_config_toggles() {
-    configs = persist_exists(KEY_CONFIGS) ? persist_read_int(KEY_CONFIGS) : 0;
-    configs_loaded = true;
-    return configs;
+bool is_module_enabled(int module) {
+    profile_count(COUNTER_MODULE_LOOKUP, 1);
+    return is_slot_visible(get_module_slot(get_visible_state(), module));
 }
 
 int get_config_toggles() {
-    if (!configs_loaded) {
-        return load_config_toggles();
-    }
-
-    return configs;
+    return get_settings()->toggles;
 }
 
 void set_config_toggles(int toggles) {
-    configs = toggles;
-    configs_loaded = true;
+    set_int_setting(KEY_CONFIGS, toggles);
 }
 
 bool is_weather_toggle_enabled() {
@@ -221,51 +482,10 @@ bool is_date_leading_zero_disabled() {
     return get_config_toggles() & FLAG_DATELEADINGZERO;
 }
 
-#if !defined PBL_PLATFORM_APLITE
 int get_slot_for_module(int module) {
-    if (!modules_loaded) {
-        load_modules();
-    }
-    if (tap_mode_visible()) {
-        for (unsigned int i = 0; i < 6; ++i) {
-            if (modules_tap[i] == module) {
-                return i;
-            }
-        }
-    } else if (wrist_mode_visible()) {
-        for (unsigned int i = 0; i < 6; ++i) {
-            if (modules_wrist[i] == module) {
-                return i;
-            }
-        }
-    } else if (should_show_sleep_data()) {
-        for (unsigned int i = 0; i < 6; ++i) {
-            if (modules_sleep[i] == module) {
-                return i;
-            }
-        }
-    } else {
-        for (unsigned int i = 0; i < 6; ++i) {
-            if (modules[i] == module) {
-                return i;
-            }
-        }
-    }
-    return -1;
+    profile_count(COUNTER_MODULE_LOOKUP, 1);
+    return get_module_slot(get_visible_state(), module);
 }
-#else
-int get_slot_for_module(int module) {
-    if (!modules_loaded) {
-        load_modules();
-    }
-    for (unsigned int i = 0; i < 6; ++i) {
-        if (modules[i] == module) {
-            return i;
-        }
-    }
-    return -1;
-}
-#endif
 
 void toggle_center_slots(bool enable) {
     center_slots_enabled = enable;
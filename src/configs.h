@@ -6,6 +6,7 @@ void set_config_toggles(int);
 int get_config_toggles();
 bool is_module_enabled(int);
 bool is_module_enabled_any(int);
+bool is_module_configured(int);
 int get_slot_for_module(int);
 
 void set_module(int, int, int);
@@ -28,7 +29,27 @@ bool is_wrist_enabled();
 bool is_mute_on_quiet_enabled();
 bool is_date_leading_zero_disabled();
 
+void load_settings();
+void save_settings();
+int32_t get_config_generation();
+void set_config_generation(int32_t);
+void set_int_setting(uint32_t, int);
+void set_color_setting(uint32_t, int32_t);
+int get_font_type();
+int get_text_align();
+int get_locale();
+int get_date_format();
+int get_date_separator();
 int get_wind_speed_unit();
+int get_weather_interval();
+int get_crypto_interval();
+int get_phonebattery_interval();
+int get_tap_timeout();
+int get_heart_low();
+int get_heart_high();
+bool has_color(uint8_t);
+int32_t get_color_value(uint8_t);
+GColor get_color(uint8_t);
 void toggle_center_slots(bool);
 
 #endif
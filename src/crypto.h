@@ -4,7 +4,6 @@
 #if !defined PBL_PLATFORM_APLITE
 #include <pebble.h>
 
-bool is_crypto_need_update();
 void update_crypto_price(char*);
 void update_crypto_price_b(char*);
 void update_crypto_price_c(char*);
@@ -14,6 +13,5 @@ void store_crypto_price(char*);
 void store_crypto_price_b(char*);
 void store_crypto_price_c(char*);
 void store_crypto_price_d(char*);
-void crypto_set_updatetime(int);
 #endif
 #endif
@@ -7,8 +7,6 @@
 #if !defined PBL_PLATFORM_APLITE
 
 static bool customtext_enabled;
-static char custxt[22];
-static char custxt_b[22];
 
 static bool get_customtext_enabled() {
   return is_module_enabled(MODULE_CUSTOMTEXTA) ||
@@ -32,14 +30,16 @@ void update_customtext_b_text(char* custxt) {
 }
 
 static void update_customtext_from_storage() {
+    char custxt[22];
+
     if (persist_exists(KEY_CUSTOMTEXTATEXT)) {
         persist_read_string(KEY_CUSTOMTEXTATEXT, custxt, sizeof(custxt));
         update_customtext_a_text(custxt);
     }
 
     if (persist_exists(KEY_CUSTOMTEXTBTEXT)) {
-        persist_read_string(KEY_CUSTOMTEXTBTEXT, custxt_b, sizeof(custxt_b));
-        update_customtext_b_text(custxt_b);
+        persist_read_string(KEY_CUSTOMTEXTBTEXT, custxt, sizeof(custxt));
+        update_customtext_b_text(custxt);
     }
 }
 
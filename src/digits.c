@@ -0,0 +1,178 @@
+#include <pebble.h>
+#include "digits.h"
+
+#if defined TIMEBOXED_DIGIT_ATLAS
+
+#define DIGIT_GLYPHS 11
+
+// the glyphs are stored as a 1 bit mask so a color change only swaps the palette
+#if defined PBL_COLOR
+#define ATLAS_FORMAT GBitmapFormat1BitPalette
+#define ATLAS_BIT(x) (0x80 >> ((x) % 8))
+#else
+#define ATLAS_FORMAT GBitmapFormat1Bit
+#define ATLAS_BIT(x) (1 << ((x) % 8))
+#endif
+
+static const char glyphs[DIGIT_GLYPHS + 1] = "0123456789:";
+
+static GBitmap *atlas;
+static GBitmap *glyph_bitmaps[DIGIT_GLYPHS];
+static uint8_t glyph_widths[DIGIT_GLYPHS];
+static int16_t glyph_height;
+static GFont atlas_font;
+
+#if defined PBL_COLOR
+static GColor palette[2];
+#endif
+
+static int get_glyph(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    return c == ':' ? DIGIT_GLYPHS - 1 : -1;
+}
+
+static bool is_glyph_pixel(GBitmap *frame, int x, int y) {
+    GBitmapDataRowInfo row = gbitmap_get_data_row_info(frame, y);
+    if (x < row.min_x || x > row.max_x) {
+        return false;
+    }
+    #if defined PBL_COLOR
+    return row.data[x] != GColorBlackARGB8;
+    #else
+    return (row.data[x / 8] >> (x % 8)) & 1;
+    #endif
+}
+
+bool needs_digit_atlas(GFont font) {
+    return font != atlas_font;
+}
+
+void destroy_digit_atlas() {
+    for (int i = 0; i < DIGIT_GLYPHS; ++i) {
+        if (glyph_bitmaps[i]) {
+            gbitmap_destroy(glyph_bitmaps[i]);
+            glyph_bitmaps[i] = NULL;
+        }
+    }
+    if (atlas) {
+        gbitmap_destroy(atlas);
+        atlas = NULL;
+    }
+    atlas_font = NULL;
+}
+
+void build_digit_atlas(GContext *ctx, GFont font, GRect bounds) {
+    destroy_digit_atlas();
+    // remembered even if the build fails so it is not retried on every frame
+    atlas_font = font;
+
+    char glyph[2] = { 0, 0 };
+    int16_t width = 0;
+    glyph_height = 0;
+    for (int i = 0; i < DIGIT_GLYPHS; ++i) {
+        glyph[0] = glyphs[i];
+        GSize size = graphics_text_layout_get_content_size(glyph, font, bounds,
+                GTextOverflowModeWordWrap, GTextAlignmentLeft);
+        glyph_widths[i] = size.w;
+        width += size.w;
+        if (size.h > glyph_height) {
+            glyph_height = size.h;
+        }
+    }
+    if (width == 0 || glyph_height == 0 || glyph_height > bounds.size.h) {
+        return;
+    }
+
+    #if defined PBL_COLOR
+    palette[0] = GColorClear;
+    palette[1] = GColorWhite;
+    atlas = gbitmap_create_blank_with_palette(GSize(width, glyph_height), ATLAS_FORMAT, palette, false);
+    #else
+    atlas = gbitmap_create_blank(GSize(width, glyph_height), ATLAS_FORMAT);
+    #endif
+    if (!atlas) {
+        return;
+    }
+    uint8_t *data = gbitmap_get_data(atlas);
+    uint16_t bytes_per_row = gbitmap_get_bytes_per_row(atlas);
+    memset(data, 0, bytes_per_row * glyph_height);
+
+    // each glyph is drawn once in the middle of the screen, which is visible on
+    // every display shape, and copied out of the frame buffer bit by bit
+    int16_t x = 0;
+    for (int i = 0; i < DIGIT_GLYPHS; ++i) {
+        GRect cell = GRect((bounds.size.w - glyph_widths[i]) / 2, (bounds.size.h - glyph_height) / 2,
+                glyph_widths[i], glyph_height);
+        glyph[0] = glyphs[i];
+        graphics_context_set_fill_color(ctx, GColorBlack);
+        graphics_fill_rect(ctx, cell, 0, GCornerNone);
+        graphics_context_set_text_color(ctx, GColorWhite);
+        graphics_draw_text(ctx, glyph, font, cell, GTextOverflowModeWordWrap, GTextAlignmentLeft, NULL);
+
+        GBitmap *frame = graphics_capture_frame_buffer(ctx);
+        if (!frame) {
+            destroy_digit_atlas();
+            atlas_font = font;
+            return;
+        }
+        for (int y = 0; y < glyph_height; ++y) {
+            for (int gx = 0; gx < glyph_widths[i]; ++gx) {
+                if (is_glyph_pixel(frame, cell.origin.x + gx, cell.origin.y + y)) {
+                    data[y * bytes_per_row + (x + gx) / 8] |= ATLAS_BIT(x + gx);
+                }
+            }
+        }
+        graphics_release_frame_buffer(ctx, frame);
+
+        glyph_bitmaps[i] = gbitmap_create_as_sub_bitmap(atlas, GRect(x, 0, glyph_widths[i], glyph_height));
+        x += glyph_widths[i];
+    }
+}
+
+bool get_digits_size(GFont font, const char *text, GSize *size) {
+    if (!atlas || font != atlas_font) {
+        return false;
+    }
+    int16_t width = 0;
+    for (const char *c = text; *c; ++c) {
+        int glyph = get_glyph(*c);
+        if (glyph == -1) {
+            return false;
+        }
+        width += glyph_widths[glyph];
+    }
+    *size = GSize(width, glyph_height);
+    return true;
+}
+
+bool draw_digits(GContext *ctx, GFont font, const char *text, GRect frame, GTextAlignment alignment, GColor color) {
+    GSize size;
+    if (!get_digits_size(font, text, &size)) {
+        return false;
+    }
+
+    int16_t x = frame.origin.x;
+    if (alignment == GTextAlignmentCenter) {
+        x += (frame.size.w - size.w) / 2;
+    } else if (alignment == GTextAlignmentRight) {
+        x += frame.size.w - size.w;
+    }
+
+    #if defined PBL_COLOR
+    palette[1] = color;
+    graphics_context_set_compositing_mode(ctx, GCompOpSet);
+    #else
+    graphics_context_set_compositing_mode(ctx, gcolor_equal(color, GColorBlack) ? GCompOpClear : GCompOpSet);
+    #endif
+    for (const char *c = text; *c; ++c) {
+        int glyph = get_glyph(*c);
+        graphics_draw_bitmap_in_rect(ctx, glyph_bitmaps[glyph], GRect(x, frame.origin.y, glyph_widths[glyph], glyph_height));
+        x += glyph_widths[glyph];
+    }
+    graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+    return true;
+}
+
+#endif
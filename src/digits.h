@@ -0,0 +1,14 @@
+#ifndef __TIMEBOXED_DIGITS_
+#define __TIMEBOXED_DIGITS_
+
+#include <pebble.h>
+
+#if defined TIMEBOXED_DIGIT_ATLAS
+bool needs_digit_atlas(GFont font);
+void build_digit_atlas(GContext *ctx, GFont font, GRect bounds);
+void destroy_digit_atlas();
+bool get_digits_size(GFont font, const char *text, GSize *size);
+bool draw_digits(GContext *ctx, GFont font, const char *text, GRect frame, GTextAlignment alignment, GColor color);
+#endif
+
+#endif
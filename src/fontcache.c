@@ -0,0 +1,64 @@
+#include <pebble.h>
+#include "fontcache.h"
+#include "profiler.h"
+
+// a face uses up to six fonts and load_face_fonts releases the old ones it
+// no longer needs before loading new ones, so one set always fits
+#define MAX_FONTS 8
+
+struct FontEntry {
+    uint32_t resource_id;
+    GFont font;
+    uint8_t refs;
+    int32_t bytes;
+};
+
+static struct FontEntry fonts[MAX_FONTS];
+static int32_t resident_bytes;
+
+GFont acquire_font(uint32_t resource_id) {
+    struct FontEntry *free_entry = NULL;
+    for (int i = 0; i < MAX_FONTS; ++i) {
+        if (fonts[i].refs && fonts[i].resource_id == resource_id) {
+            fonts[i].refs++;
+            return fonts[i].font;
+        }
+        if (!fonts[i].refs && !free_entry) {
+            free_entry = &fonts[i];
+        }
+    }
+    if (!free_entry) {
+        return NULL;
+    }
+
+    // the heap growth while loading is what the font keeps resident
+    size_t heap_before = heap_bytes_used();
+    free_entry->font = fonts_load_custom_font(resource_get_handle(resource_id));
+    if (!free_entry->font) {
+        return NULL;
+    }
+    free_entry->bytes = (int32_t)heap_bytes_used() - (int32_t)heap_before;
+    free_entry->resource_id = resource_id;
+    free_entry->refs = 1;
+    resident_bytes += free_entry->bytes;
+    profile_alloc(1);
+    profile_count(COUNTER_FONT_LOADS, 1);
+    return free_entry->font;
+}
+
+void release_font(uint32_t resource_id) {
+    for (int i = 0; i < MAX_FONTS; ++i) {
+        if (fonts[i].refs && fonts[i].resource_id == resource_id) {
+            if (--fonts[i].refs == 0) {
+                fonts_unload_custom_font(fonts[i].font);
+                fonts[i].font = NULL;
+                resident_bytes -= fonts[i].bytes;
+            }
+            return;
+        }
+    }
+}
+
+int32_t get_resident_font_bytes() {
+    return resident_bytes;
+}
@@ -0,0 +1,10 @@
+#ifndef __TIMEBOXED_FONTCACHE_
+#define __TIMEBOXED_FONTCACHE_
+
+#include <pebble.h>
+
+GFont acquire_font(uint32_t resource_id);
+void release_font(uint32_t resource_id);
+int32_t get_resident_font_bytes();
+
+#endif
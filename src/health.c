@@ -4,6 +4,8 @@
 #include "text.h"
 #include "configs.h"
 #include "screen.h"
+#include "profiler.h"
+#include "scheduler.h"
 
 
 #if defined(PBL_HEALTH)
@@ -17,13 +19,48 @@ static bool useCalories;
 static bool update_queued;
 static bool is_sleeping;
 static bool sleep_status_updated;
-static char steps_text[8];
-static char cal_text[10];
-static char dist_text[10];
-static char sleep_text[8];
-static char deep_text[8];
-static char active_text[8];
-static char heart_text[10];
+
+#define HEALTH_STEPS 0
+#define HEALTH_DIST 1
+#define HEALTH_CAL 2
+#define HEALTH_SLEEP 3
+#define HEALTH_DEEP 4
+#define HEALTH_ACTIVE 5
+#define NUM_HEALTH_METRICS 6
+
+// values are formatted on the stack and copied into the text arena, which
+// holds the only lasting copy of each displayed string
+#define HEALTH_TEXT_SIZE 10
+
+// steps, distance and calories are compared with the average up to the current
+// time of day, which is refreshed every BASELINE_PERIOD. sleep and activity use
+// the whole day average, so those only change when the day rolls over
+#define BASELINE_PERIOD (15 * SECONDS_PER_MINUTE)
+
+// layout of the record stored under KEY_HEALTH_BASELINES, bump on any change
+#define HEALTH_BASELINES_VERSION 1
+
+struct Baselines {
+    uint8_t version;
+    int32_t day;
+    int32_t until[NUM_HEALTH_METRICS];
+    int32_t values[NUM_HEALTH_METRICS];
+    uint8_t available;
+};
+
+struct HealthMetricInfo {
+    uint8_t module;
+    uint32_t storage_key;
+    HealthMetric metrics[2];
+    uint8_t num_metrics;
+    bool running;
+    void (*format)(char *text, uint8_t size, int value);
+    void (*set_text)(char *text);
+    const char* (*get_text)();
+    void (*set_progress_color)(bool behind);
+};
+
+static struct Baselines baselines;
 
 static void clear_health_fields() {
     set_steps_layer_text("");
@@ -49,249 +86,136 @@ static bool health_permission_granted() {
     return !(mask_steps & HealthServiceAccessibilityMaskNoPermission);
 }
 
-static void get_steps_data() {
-    time_t start = time_start_of_today();
-    time_t end = time(NULL);
-    int one_day = 24 * SECONDS_PER_HOUR;
-    int current_steps = 0;
-    int steps_last_week = 0;
-
-    HealthMetric metric_steps = HealthMetricStepCount;
-    HealthServiceAccessibilityMask mask_steps =
-        health_service_metric_accessible(metric_steps, start, end);
-
-    if (mask_steps & HealthServiceAccessibilityMaskAvailable) {
-        current_steps = (int)health_service_sum_today(metric_steps);
-
-        steps_last_week = 0;
-        HealthServiceAccessibilityMask mask_steps_average =
-            health_service_metric_averaged_accessible(metric_steps, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-
-        if (mask_steps_average & HealthServiceAccessibilityMaskAvailable) {
-            steps_last_week = (int)health_service_sum_averaged(metric_steps, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-        } else {
-            for (int i = 7; i <= 28; i = i+7) {
-                steps_last_week += (int)health_service_sum(metric_steps, start - i*one_day, end - i*one_day);
-            }
-            steps_last_week /= 4;
-        }
-        APP_LOG(APP_LOG_LEVEL_DEBUG, "Steps data: %d / %d", current_steps, steps_last_week);
-
-        snprintf(steps_text, sizeof(steps_text), "%d", current_steps);
-
-        set_steps_layer_text(steps_text);
+static void format_steps(char *text, uint8_t size, int steps) {
+    snprintf(text, size, "%d", steps);
+}
 
-        set_progress_color_steps(current_steps < steps_last_week);
+static void format_dist(char *text, uint8_t size, int dist) {
+    if (!useKm) {
+        dist /= 1.6;
     }
+    snprintf(text, size, (useKm ? "%d.%dkm" : "%d.%dmi"), dist/1000, (dist%1000)/100);
 }
 
-static void get_dist_data() {
-    time_t start = time_start_of_today();
-    time_t end = time(NULL);
-    int one_day = 24 * SECONDS_PER_HOUR;
-
-    int current_dist = 0;
-    int dist_last_week = 0;
-    int current_dist_int = 0;
-    int current_dist_dec = 0;
-
-    HealthMetric metric_dist = HealthMetricWalkedDistanceMeters;
-    HealthServiceAccessibilityMask mask_dist =
-        health_service_metric_accessible(metric_dist, start, end);
-
-    if (mask_dist & HealthServiceAccessibilityMaskAvailable) {
-        current_dist = (int)health_service_sum_today(metric_dist);
-
-        dist_last_week = 0;
-        HealthServiceAccessibilityMask mask_dist_average =
-            health_service_metric_averaged_accessible(metric_dist, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-
-        if (mask_dist_average & HealthServiceAccessibilityMaskAvailable) {
-            dist_last_week = (int)health_service_sum_averaged(metric_dist, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-        } else {
-            for (int i = 7; i <= 28; i = i+7) {
-                dist_last_week += (int)health_service_sum(metric_dist, start - i*one_day, end - i*one_day);
-            }
-            dist_last_week /= 4;
-        }
-        APP_LOG(APP_LOG_LEVEL_DEBUG, "Dist data: %d / %d", current_dist, dist_last_week);
-
-        if (!useKm) {
-            current_dist /= 1.6;
-        }
-        current_dist_int = current_dist/1000;
-        current_dist_dec = (current_dist%1000)/100;
+static void format_cal(char *text, uint8_t size, int cal) {
+    snprintf(text, size, (get_loaded_font() == KONSTRUCT_FONT && cal >= 2000) ? "%dcal" : "%d cal", cal);
+}
 
-        snprintf(dist_text, sizeof(dist_text), (useKm ? "%d.%dkm" : "%d.%dmi"), current_dist_int, current_dist_dec);
+static void format_duration(char *text, uint8_t size, int seconds) {
+    int hours = seconds / SECONDS_PER_HOUR;
+    int minutes = ((seconds - (hours * SECONDS_PER_HOUR))/SECONDS_PER_MINUTE) % SECONDS_PER_MINUTE;
+    snprintf(text, size, "%dh%02dm", hours, minutes);
+}
 
-        set_dist_layer_text(dist_text);
-        set_progress_color_dist(current_dist < dist_last_week);
+static const struct HealthMetricInfo health_metrics[NUM_HEALTH_METRICS] = {
+    { MODULE_STEPS, KEY_STEPS, { HealthMetricStepCount }, 1, true,
+        format_steps, set_steps_layer_text, get_steps_layer_text, set_progress_color_steps },
+    { MODULE_DIST, KEY_DIST, { HealthMetricWalkedDistanceMeters }, 1, true,
+        format_dist, set_dist_layer_text, get_dist_layer_text, set_progress_color_dist },
+    { MODULE_CAL, KEY_CAL, { HealthMetricRestingKCalories, HealthMetricActiveKCalories }, 2, true,
+        format_cal, set_cal_layer_text, get_cal_layer_text, set_progress_color_cal },
+    { MODULE_SLEEP, KEY_SLEEP, { HealthMetricSleepSeconds }, 1, false,
+        format_duration, set_sleep_layer_text, get_sleep_layer_text, set_progress_color_sleep },
+    { MODULE_DEEP, KEY_DEEP, { HealthMetricSleepRestfulSeconds }, 1, false,
+        format_duration, set_deep_layer_text, get_deep_layer_text, set_progress_color_deep },
+    { MODULE_ACTIVE, KEY_ACTIVE, { HealthMetricActiveSeconds }, 1, false,
+        format_duration, set_active_layer_text, get_active_layer_text, set_progress_color_active },
+};
+
+static void check_baseline_day(time_t start) {
+    if (baselines.day != (int32_t)start) {
+        memset(&baselines, 0, sizeof(baselines));
+        baselines.day = (int32_t)start;
     }
 }
 
-static void get_cal_data() {
-
-    HealthMetric metric_cal_rest = HealthMetricRestingKCalories;
-    HealthMetric metric_cal_act = HealthMetricActiveKCalories;
-
-    time_t start = time_start_of_today();
-    time_t end = time(NULL);
-    int one_day = 24 * SECONDS_PER_HOUR;
-
-    int current_cal = 0;
-    int cal_last_week = 0;
-
-    HealthServiceAccessibilityMask mask_cal_rest =
-        health_service_metric_accessible(metric_cal_rest, start, end);
-    HealthServiceAccessibilityMask mask_cal_act =
-        health_service_metric_accessible(metric_cal_act, start, end);
-
-
-    bool has_cal_metric = (mask_cal_rest & HealthServiceAccessibilityMaskAvailable) || (mask_cal_act & HealthServiceAccessibilityMaskAvailable);
-    if (has_cal_metric) {
-        current_cal = (int)health_service_sum_today(metric_cal_rest) + (int)health_service_sum_today(metric_cal_act);
-
-        cal_last_week = 0;
-        HealthServiceAccessibilityMask mask_cal_rest_average =
-            health_service_metric_averaged_accessible(metric_cal_rest, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-        HealthServiceAccessibilityMask mask_cal_act_average =
-            health_service_metric_averaged_accessible(metric_cal_act, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-
-        if ((mask_cal_rest_average & HealthServiceAccessibilityMaskAvailable) || mask_cal_act_average & HealthServiceAccessibilityMaskAvailable) {
-            cal_last_week += (int)health_service_sum_averaged(metric_cal_rest, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-            cal_last_week += (int)health_service_sum_averaged(metric_cal_act, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-        } else {
-            for (int i = 7; i <= 28; i = i+7) {
-                cal_last_week += (int)health_service_sum(metric_cal_rest, start - i*one_day, end - i*one_day);
-                cal_last_week += (int)health_service_sum(metric_cal_act, start - i*one_day, end - i*one_day);
-            }
-            cal_last_week /= 4;
+static bool is_metric_available(uint8_t index, time_t start, time_t end) {
+    // once a metric has data for today it stays available until the day rolls over
+    if (baselines.available & (1 << index)) {
+        return true;
+    }
+    const struct HealthMetricInfo *info = &health_metrics[index];
+    for (int m = 0; m < info->num_metrics; ++m) {
+        profile_count(COUNTER_HEALTH_CALLS, 1);
+        if (health_service_metric_accessible(info->metrics[m], start, end) & HealthServiceAccessibilityMaskAvailable) {
+            baselines.available |= 1 << index;
+            return true;
         }
-        APP_LOG(APP_LOG_LEVEL_DEBUG, "Calories data: %d / %d", current_cal, cal_last_week);
-
-        snprintf(cal_text, sizeof(cal_text), (get_loaded_font() == KONSTRUCT_FONT && current_cal >= 2000) ? "%dcal" : "%d cal", current_cal);
-
-        set_cal_layer_text(cal_text);
-        set_progress_color_cal(current_cal < cal_last_week);
-
     }
+    return false;
 }
 
-static void get_sleep_data() {
-
-    time_t start = time_start_of_today();
-    time_t end = time(NULL);
+static int get_baseline(uint8_t index, time_t start, time_t end) {
+    const struct HealthMetricInfo *info = &health_metrics[index];
     int one_day = 24 * SECONDS_PER_HOUR;
+    time_t until = info->running ?
+        start + ((end - start) / BASELINE_PERIOD) * BASELINE_PERIOD :
+        start + one_day - 1;
 
-    int current_sleep = 0;
-    int sleep_last_week = 0;
-
-    HealthMetric metric_sleep = HealthMetricSleepSeconds;
-    HealthServiceAccessibilityMask mask_sleep =
-        health_service_metric_accessible(metric_sleep, start, end);
-    HealthServiceAccessibilityMask mask_sleep_average =
-        health_service_metric_averaged_accessible(metric_sleep, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-
-    if (mask_sleep & HealthServiceAccessibilityMaskAvailable) {
-        current_sleep = (int)health_service_sum_today(metric_sleep);
+    if (baselines.until[index] == (int32_t)until) {
+        return baselines.values[index];
+    }
 
-        sleep_last_week = 0;
-        if (mask_sleep_average & HealthServiceAccessibilityMaskAvailable) {
-            sleep_last_week = (int)health_service_sum_averaged(metric_sleep, start, start + 24*SECONDS_PER_HOUR-1, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-        } else {
-            for (int i = 1; i <= 7; i++) {
-                sleep_last_week += (int)health_service_sum(metric_sleep, start - i*one_day, start - (i-1)*one_day);
-            }
-            sleep_last_week /= 7;
+    bool has_average = false;
+    for (int m = 0; m < info->num_metrics; ++m) {
+        if (health_service_metric_averaged_accessible(info->metrics[m], start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend) & HealthServiceAccessibilityMaskAvailable) {
+            has_average = true;
         }
-        APP_LOG(APP_LOG_LEVEL_DEBUG, "Sleep data: %d / %d", current_sleep, sleep_last_week);
-
-        int current_sleep_hours = current_sleep / SECONDS_PER_HOUR;
-        int current_sleep_minutes = ((current_sleep - (current_sleep_hours * SECONDS_PER_HOUR))/SECONDS_PER_MINUTE) % SECONDS_PER_MINUTE;
-
-        snprintf(sleep_text, sizeof(sleep_text), "%dh%02dm", current_sleep_hours, current_sleep_minutes);
-
-        set_sleep_layer_text(sleep_text);
-        set_progress_color_sleep(current_sleep < sleep_last_week);
     }
-}
-
-static void get_deep_data() {
-
-    time_t start = time_start_of_today();
-    time_t end = time(NULL);
-    int one_day = 24 * SECONDS_PER_HOUR;
-
-    int current_deep = 0;
-    int deep_last_week = 0;
+    profile_count(COUNTER_HEALTH_CALLS, info->num_metrics);
 
-    HealthMetric metric_deep = HealthMetricSleepRestfulSeconds;
-    HealthServiceAccessibilityMask mask_deep =
-        health_service_metric_accessible(metric_deep, start, end);
-    HealthServiceAccessibilityMask mask_deep_average =
-        health_service_metric_averaged_accessible(metric_deep, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-
-    if (mask_deep & HealthServiceAccessibilityMaskAvailable) {
-        current_deep = (int)health_service_sum_today(metric_deep);
-
-        deep_last_week = 0;
-        if (mask_deep_average & HealthServiceAccessibilityMaskAvailable) {
-            deep_last_week = (int)health_service_sum_averaged(metric_deep, start, start + 24*SECONDS_PER_HOUR-1, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-        } else {
-            for (int i = 1; i <= 7; i++) {
-                deep_last_week += (int)health_service_sum(metric_deep, start - i*one_day, start - (i-1)*one_day);
+    int value = 0;
+    if (has_average) {
+        for (int m = 0; m < info->num_metrics; ++m) {
+            value += (int)health_service_sum_averaged(info->metrics[m], start, until, HealthServiceTimeScopeDailyWeekdayOrWeekend);
+        }
+        profile_count(COUNTER_HEALTH_CALLS, info->num_metrics);
+    } else if (info->running) {
+        for (int i = 7; i <= 28; i = i+7) {
+            for (int m = 0; m < info->num_metrics; ++m) {
+                value += (int)health_service_sum(info->metrics[m], start - i*one_day, until - i*one_day);
             }
-            deep_last_week /= 7;
         }
-        APP_LOG(APP_LOG_LEVEL_DEBUG, "Deep sleep data: %d / %d", current_deep, deep_last_week);
-
-        int current_deep_hours = current_deep / SECONDS_PER_HOUR;
-        int current_deep_minutes = ((current_deep - (current_deep_hours * SECONDS_PER_HOUR))/SECONDS_PER_MINUTE) % SECONDS_PER_MINUTE;
-
-        snprintf(deep_text, sizeof(deep_text), "%dh%02dm", current_deep_hours, current_deep_minutes);
-
-        set_deep_layer_text(deep_text);
-        set_progress_color_deep(current_deep < deep_last_week);
+        value /= 4;
+        profile_count(COUNTER_HEALTH_CALLS, 4 * info->num_metrics);
+    } else {
+        for (int i = 1; i <= 7; i++) {
+            for (int m = 0; m < info->num_metrics; ++m) {
+                value += (int)health_service_sum(info->metrics[m], start - i*one_day, start - (i-1)*one_day);
+            }
+        }
+        value /= 7;
+        profile_count(COUNTER_HEALTH_CALLS, 7 * info->num_metrics);
     }
 
+    baselines.until[index] = (int32_t)until;
+    baselines.values[index] = value;
+    return value;
 }
 
-static void get_active_data() {
-
+static void get_metrics_data() {
     time_t start = time_start_of_today();
     time_t end = time(NULL);
-    int one_day = 24 * SECONDS_PER_HOUR;
-
-    int current_active = 0;
-    int active_last_week = 0;
+    check_baseline_day(start);
 
-    HealthMetric metric_active = HealthMetricActiveSeconds;
-    HealthServiceAccessibilityMask mask_active =
-        health_service_metric_accessible(metric_active, start, end);
-    HealthServiceAccessibilityMask mask_active_average =
-        health_service_metric_averaged_accessible(metric_active, start, end, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-
-    if (mask_active & HealthServiceAccessibilityMaskAvailable) {
-        current_active = (int)health_service_sum_today(metric_active);
-
-        active_last_week = 0;
-        if (mask_active_average & HealthServiceAccessibilityMaskAvailable) {
-            active_last_week = (int)health_service_sum_averaged(metric_active, start, start + 24*SECONDS_PER_HOUR-1, HealthServiceTimeScopeDailyWeekdayOrWeekend);
-        } else {
-            for (int i = 1; i <= 7; i++) {
-                active_last_week += (int)health_service_sum(metric_active, start - i*one_day, start - (i-1)*one_day);
-            }
-            active_last_week /= 7;
+    for (int i = 0; i < NUM_HEALTH_METRICS; ++i) {
+        const struct HealthMetricInfo *info = &health_metrics[i];
+        if (!is_module_enabled(info->module) || !is_metric_available(i, start, end)) {
+            continue;
         }
-        APP_LOG(APP_LOG_LEVEL_DEBUG, "Active data: %d / %d", current_active, active_last_week);
 
-        int current_active_hours = current_active / SECONDS_PER_HOUR;
-        int current_active_minutes = ((current_active - (current_active_hours * SECONDS_PER_HOUR))/SECONDS_PER_MINUTE) % SECONDS_PER_MINUTE;
-
-        snprintf(active_text, sizeof(active_text), "%dh%02dm", current_active_hours, current_active_minutes);
-
-        set_active_layer_text(active_text);
-        set_progress_color_active(current_active < active_last_week);
+        int current = 0;
+        for (int m = 0; m < info->num_metrics; ++m) {
+            current += (int)health_service_sum_today(info->metrics[m]);
+        }
+        profile_count(COUNTER_HEALTH_CALLS, info->num_metrics);
+        int last_week = get_baseline(i, start, end);
+        APP_LOG(APP_LOG_LEVEL_DEBUG, "Health data %d: %d / %d", i, current, last_week);
+
+        char text[HEALTH_TEXT_SIZE];
+        info->format(text, sizeof(text), current);
+        info->set_text(text);
+        info->set_progress_color(current < last_week);
     }
 }
 
@@ -301,12 +225,13 @@ static void get_heart_data() {
     HealthMetric metric_heart = HealthMetricHeartRateBPM;
 
     current_heart = (int)health_service_peek_current_value(metric_heart);
+    profile_count(COUNTER_HEALTH_CALLS, 1);
 
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Heart data: %d", current_heart);
 
+    char heart_text[HEALTH_TEXT_SIZE];
     snprintf(heart_text, sizeof(heart_text), "%d", current_heart);
 
-
     set_heart_layer_text(heart_text);
     set_heart_icon_layer_text("v");
     set_progress_color_heart(current_heart);
@@ -319,29 +244,14 @@ void queue_health_update() {
 
 void get_health_data() {
     if (health_enabled && update_queued) {
+        profile_begin(PROFILE_HEALTH);
         update_queued = false;
         APP_LOG(APP_LOG_LEVEL_DEBUG, "Updating health data. %d%03d", (int)time(NULL), (int)time_ms(NULL, NULL));
-        if (is_module_enabled(MODULE_STEPS)) {
-            get_steps_data();
-        }
-        if (is_module_enabled(MODULE_DIST)) {
-            get_dist_data();
-        }
-        if (is_module_enabled(MODULE_CAL)) {
-            get_cal_data();
-        }
-        if (is_module_enabled(MODULE_SLEEP)) {
-            get_sleep_data();
-        }
-        if (is_module_enabled(MODULE_DEEP)) {
-            get_deep_data();
-        }
-        if (is_module_enabled(MODULE_ACTIVE)) {
-            get_active_data();
-        }
+        get_metrics_data();
         if (is_module_enabled(MODULE_HEART)) {
             get_heart_data();
         }
+        profile_end(PROFILE_HEALTH);
     }
 }
 
@@ -360,35 +270,14 @@ void health_handler(HealthEventType event, void *context) {
 
 static void load_health_data_from_storage() {
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Loading health data from storage. %d%03d", (int)time(NULL), (int)time_ms(NULL, NULL));
-    if (is_module_enabled(MODULE_STEPS)) {
-        persist_read_string(KEY_STEPS, steps_text, sizeof(steps_text));
-        set_steps_layer_text(steps_text);
-        set_progress_color_steps(false);
-    }
-    if (is_module_enabled(MODULE_DIST)) {
-        persist_read_string(KEY_DIST, dist_text, sizeof(dist_text));
-        set_dist_layer_text(dist_text);
-        set_progress_color_dist(false);
-    }
-    if (is_module_enabled(MODULE_CAL)) {
-        persist_read_string(KEY_CAL, cal_text, sizeof(cal_text));
-        set_cal_layer_text(cal_text);
-        set_progress_color_cal(false);
-    }
-    if (is_module_enabled(MODULE_SLEEP)) {
-        persist_read_string(KEY_SLEEP, sleep_text, sizeof(sleep_text));
-        set_sleep_layer_text(sleep_text);
-        set_progress_color_sleep(false);
-    }
-    if (is_module_enabled(MODULE_DEEP)) {
-        persist_read_string(KEY_DEEP, deep_text, sizeof(deep_text));
-        set_deep_layer_text(deep_text);
-        set_progress_color_deep(false);
-    }
-    if (is_module_enabled(MODULE_ACTIVE)) {
-        persist_read_string(KEY_ACTIVE, active_text, sizeof(active_text));
-        set_active_layer_text(active_text);
-        set_progress_color_active(false);
+    for (int i = 0; i < NUM_HEALTH_METRICS; ++i) {
+        const struct HealthMetricInfo *info = &health_metrics[i];
+        if (is_module_enabled(info->module)) {
+            char text[HEALTH_TEXT_SIZE] = "";
+            persist_read_string(info->storage_key, text, sizeof(text));
+            info->set_text(text);
+            info->set_progress_color(false);
+        }
     }
     if (is_module_enabled(MODULE_HEART)) {
         set_heart_layer_text("0");
@@ -409,12 +298,26 @@ static bool get_health_enabled() {
 }
 
 void toggle_health(uint8_t reload_origin) {
-    is_sleeping = false;
+    // module reloads come from redraw_screen, often because the sleep state just
+    // changed, so forgetting it here would flip the face back until the next check
+    if (reload_origin != RELOAD_MODULE) {
+        is_sleeping = false;
+    }
     bool has_health = false;
     health_enabled = get_health_enabled();
     sleep_data_enabled = is_sleep_data_enabled();
 
     if (health_enabled) {
+        // a record from another build or a partial write is dropped, the
+        // baselines are queried again instead
+        if (reload_origin == RELOAD_DEFAULT && persist_exists(KEY_HEALTH_BASELINES)) {
+            if (persist_get_size(KEY_HEALTH_BASELINES) != sizeof(baselines) ||
+                persist_read_data(KEY_HEALTH_BASELINES, &baselines, sizeof(baselines)) != sizeof(baselines) ||
+                baselines.version != HEALTH_BASELINES_VERSION) {
+                memset(&baselines, 0, sizeof(baselines));
+            }
+        }
+
         MeasurementSystem distMeasure = health_service_get_measurement_system_for_display(HealthMetricWalkedDistanceMeters);
         if (distMeasure != MeasurementSystemUnknown) {
             useKm = distMeasure == MeasurementSystemMetric;
@@ -441,6 +344,10 @@ void toggle_health(uint8_t reload_origin) {
         }
     }
 
+    // refresh every 2 minutes, or every minute if heart rate is enabled
+    set_task(TASK_HEALTH, health_enabled && has_health, (is_module_enabled(MODULE_HEART) ? 1 : 2) * SECONDS_PER_MINUTE);
+    set_task_handler(TASK_HEALTH, get_health_data);
+
     if (!health_enabled || !has_health) {
         clear_health_fields();
         health_service_events_unsubscribe();
@@ -503,12 +410,14 @@ void init_sleep_data() {
 
 void save_health_data_to_storage() {
     APP_LOG(APP_LOG_LEVEL_DEBUG, "Storing health data. %d%03d", (int)time(NULL), (int)time_ms(NULL, NULL));
-    persist_write_string(KEY_STEPS, steps_text);
-    persist_write_string(KEY_DIST, dist_text);
-    persist_write_string(KEY_CAL, cal_text);
-    persist_write_string(KEY_SLEEP, sleep_text);
-    persist_write_string(KEY_DEEP, deep_text);
-    persist_write_string(KEY_ACTIVE, active_text);
+    for (int i = 0; i < NUM_HEALTH_METRICS; ++i) {
+        const char *text = health_metrics[i].get_text();
+        if (text) {
+            persist_write_string(health_metrics[i].storage_key, text);
+        }
+    }
+    baselines.version = HEALTH_BASELINES_VERSION;
+    persist_write_data(KEY_HEALTH_BASELINES, &baselines, sizeof(baselines));
 }
 
 bool should_show_sleep_data() {
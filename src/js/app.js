@@ -18,14 +18,16 @@ Pebble.addEventListener('ready', function(e) {
 
 Pebble.addEventListener('appmessage', function(e) {
     console.log('AppMessage received!');
+    if (e.payload.KEY_CONFIGDONE !== undefined) {
+        checkConfig(e.payload.KEY_CONFIGDONE);
+    }
     if (e.payload.KEY_HASUPDATE) {
         console.log('Checking for updates...');
         checkForUpdates();
     }
     if (e.payload.KEY_REQUESTWEATHER) {
         console.log('Fetching weather info...');
-        var weatherKey = localStorage.weatherKey;
-        var provider = 2;
+        var provider = YAHOO;
         var useCelsius = ('' + localStorage.useCelsius || 'false').toLowerCase();
         if (typeof useCelsius === 'string') {
             try {
@@ -36,22 +38,10 @@ Pebble.addEventListener('appmessage', function(e) {
             }
         }
         if (localStorage.weatherProvider) {
-            provider = parseInt(localStorage.weatherProvider, 10);
-            switch (provider) {
-                case WUNDERGROUND:
-                    weatherKey = localStorage.weatherKey;
-                    break;
-                case FORECAST:
-                    weatherKey = localStorage.forecastKey;
-                    break;
-                case OPEN_WEATHER:
-                    weatherKey = localStorage.openWeatherKey;
-                    break;
-                default:
-                    weatherKey = '';
-            }
-            console.log('weatherKey: ' + weatherKey);
+            provider = getWeatherProvider(parseInt(localStorage.weatherProvider, 10));
         }
+        var weatherKey = getWeatherProviderKey(provider);
+        console.log('weatherKey: ' + weatherKey);
         getWeather(
             provider,
             weatherKey,
@@ -103,16 +93,21 @@ Pebble.addEventListener('webviewclosed', function(e) {
 
     console.log(e.response);
 
+    var dict = getConfigDict(e.response);
+    localStorage.configDict = e.response;
+    sendConfig(dict);
+});
+
+// turns what the config page returned into the dictionary for the watch
+function getConfigDict(response) {
     var configData;
     try {
-        configData = JSON.parse(e.response);
+        configData = JSON.parse(response);
     } catch (error) {
-        configData = JSON.parse(LZString.decompressFromBase64(e.response));
+        configData = JSON.parse(LZString.decompressFromBase64(response));
     }
     console.log(JSON.stringify(configData));
 
-    localStorage.configDict = e.response;
-
     var dict = {};
 
     Object.keys(configData).forEach(function(item) {
@@ -234,29 +229,229 @@ Pebble.addEventListener('webviewclosed', function(e) {
             });
     }
 
-    console.log('sending');
-    console.log(JSON.stringify(dict));
-    Pebble.sendAppMessage(
-        dict,
-        function(data) {
-            console.log('Send config successful: ' + JSON.stringify(data));
-        },
-        function(data, error) {
-            console.log(
-                'Send failed! ' +
-                    JSON.stringify(dict) +
-                    ' --> ' +
-                    JSON.stringify(data) +
-                    ': ' + error
-            );
+    return dict;
+}
+
+// inbox sizes opened by the watch in app_message_open
+var INBOX_SIZE = 1024;
+var INBOX_SIZE_APLITE = 512;
+var CONFIG_RETRIES = 3;
+
+function getUtf8Length(text) {
+    var length = 0;
+    for (var i = 0; i < text.length; ++i) {
+        var code = text.charCodeAt(i);
+        if (code < 0x80) {
+            length += 1;
+        } else if (code < 0x800) {
+            length += 2;
+        } else if (code >= 0xd800 && code < 0xdc00 && i + 1 < text.length) {
+            // a surrogate pair is one 4 byte character
+            length += 4;
+            i++;
+        } else {
+            length += 3;
         }
-    );
-});
+    }
+    return length;
+}
+
+function getTupleSize(value) {
+    // every tuple carries a 7 byte header (key, type, length); strings go to
+    // the watch as nul terminated UTF-8
+    if (typeof value === 'string') {
+        return 7 + getUtf8Length(value) + 1;
+    }
+    if (Array.isArray(value)) {
+        return 7 + value.length;
+    }
+    return 7 + 4;
+}
+
+function getWatchToken() {
+    try {
+        return Pebble.getWatchToken() || '';
+    } catch (err) {
+        return '';
+    }
+}
+
+// what was last acknowledged, kept per watch so pairing another one gets a full send
+function getConfigSnapshotKey() {
+    return 'sentConfig:' + getWatchToken();
+}
+
+function readConfigSnapshot() {
+    try {
+        var snapshot = JSON.parse(localStorage[getConfigSnapshotKey()] || 'null');
+        return snapshot && snapshot.version === currentVersion ? snapshot : null;
+    } catch (err) {
+        return null;
+    }
+}
+
+function getConfigGeneration(dict) {
+    var text = JSON.stringify(dict);
+    var hash = 5381;
+    for (var i = 0; i < text.length; ++i) {
+        hash = (hash * 33 + text.charCodeAt(i)) | 0;
+    }
+    // the watch reports 0 when it has nothing from us
+    return (hash & 0x7fffffff) || 1;
+}
+
+function getConfigDelta(dict) {
+    var snapshot = readConfigSnapshot();
+    var sent = snapshot ? snapshot.config : {};
+
+    var delta = {};
+    Object.keys(dict).forEach(function(key) {
+        if (JSON.stringify(dict[key]) !== JSON.stringify(sent[key])) {
+            delta[key] = dict[key];
+        }
+    });
+    return delta;
+}
+
+// the watch reports the generation of the config it holds when it starts; if
+// that is not what we last sent (a reinstall, or settings from another phone)
+// the delta would be against the wrong base, so send everything again
+function checkConfig(generation) {
+    var snapshot = readConfigSnapshot();
+    if (snapshot && snapshot.generation === generation) {
+        return;
+    }
+    delete localStorage[getConfigSnapshotKey()];
+    if (!localStorage.configDict) {
+        return;
+    }
+    console.log('Watch holds config ' + generation + ', sending all of it');
+    sendConfig(getConfigDict(localStorage.configDict));
+}
+
+function getConfigChunks(delta) {
+    var isAplite = Pebble.getActiveWatchInfo().platform === 'aplite';
+    // room for the dictionary header and the KEY_CONFIGDONE tuple on the last chunk
+    var budget = (isAplite ? INBOX_SIZE_APLITE : INBOX_SIZE) - 1 - getTupleSize(1);
+    var chunks = [];
+    var chunk = {};
+    var size = 0;
+
+    Object.keys(delta).forEach(function(key) {
+        var tupleSize = getTupleSize(delta[key]);
+        if (size + tupleSize > budget && size > 0) {
+            chunks.push(chunk);
+            chunk = {};
+            size = 0;
+        }
+        chunk[key] = delta[key];
+        size += tupleSize;
+    });
+    chunks.push(chunk);
+    return chunks;
+}
+
+function sendConfig(dict) {
+    var delta = getConfigDelta(dict);
+    if (Object.keys(delta).length === 0) {
+        console.log('Config unchanged, nothing to send.');
+        return;
+    }
+
+    var chunks = getConfigChunks(delta);
+    var generation = getConfigGeneration(dict);
+    chunks[chunks.length - 1].KEY_CONFIGDONE = generation;
+    var retries = 0;
+    console.log('sending ' + Object.keys(delta).length + ' changed keys in ' + chunks.length + ' chunks');
+
+    var sendChunk = function(index) {
+        Pebble.sendAppMessage(
+            chunks[index],
+            function(data) {
+                retries = 0;
+                if (index + 1 < chunks.length) {
+                    sendChunk(index + 1);
+                    return;
+                }
+                // only remember what the watch has acknowledged
+                localStorage[getConfigSnapshotKey()] = JSON.stringify({
+                    version: currentVersion,
+                    generation: generation,
+                    config: dict,
+                });
+                console.log('Send config successful: ' + JSON.stringify(delta));
+            },
+            function(data, error) {
+                if (retries < CONFIG_RETRIES) {
+                    retries++;
+                    setTimeout(function() {
+                        sendChunk(index);
+                    }, 500 * retries);
+                    return;
+                }
+                delete localStorage[getConfigSnapshotKey()];
+                console.log(
+                    'Send failed! ' +
+                        JSON.stringify(chunks[index]) +
+                        ' --> ' +
+                        JSON.stringify(data) +
+                        ': ' + error
+                );
+            }
+        );
+    };
+    sendChunk(0);
+}
 
 function parse(type) {
     return typeof type == 'string' ? JSON.parse(type) : type;
 }
 
+// responses are shared by requests for the same provider, units and location
+// cell, so a watch asking again a few minutes later does not cost a download
+var WEATHER_CACHE_TTL = 15 * 60 * 1000;
+var WEATHER_CELL_SIZE = 0.02;
+var WEATHER_REQUEST_TIMEOUT = 60 * 1000;
+
+var weatherRequests = {};
+
+function getWeatherCacheTtl() {
+    var minutes = parseInt(localStorage.weatherCacheTtl, 10);
+    return isNaN(minutes) ? WEATHER_CACHE_TTL : minutes * 60 * 1000;
+}
+
+function getWeatherCacheKey(pos, provider, useCelsius, overrideLocation) {
+    var location = overrideLocation;
+    if (!location) {
+        location =
+            Math.round(pos.coords.latitude / WEATHER_CELL_SIZE) +
+            ',' +
+            Math.round(pos.coords.longitude / WEATHER_CELL_SIZE);
+    }
+    return provider + ':' + (useCelsius ? 'c' : 'f') + ':' + location;
+}
+
+function readWeatherCache() {
+    try {
+        return JSON.parse(localStorage.weatherCache || '{}');
+    } catch (ex) {
+        return {};
+    }
+}
+
+function storeWeather(key, record) {
+    var cache = readWeatherCache();
+    var now = Date.now();
+    var ttl = getWeatherCacheTtl();
+    Object.keys(cache).forEach(function(cached) {
+        if (now - cache[cached].time >= ttl) {
+            delete cache[cached];
+        }
+    });
+    cache[key] = { time: now, record: record };
+    localStorage.weatherCache = JSON.stringify(cache);
+}
+
 function locationSuccess(
     pos,
     provider,
@@ -264,38 +459,218 @@ function locationSuccess(
     useCelsius,
     overrideLocation
 ) {
+    var now = Date.now();
+    var key = getWeatherCacheKey(pos, provider, useCelsius, overrideLocation);
+    var cached = readWeatherCache()[key];
+    if (cached && cached.record && now - cached.time < getWeatherCacheTtl()) {
+        console.log('Weather cache hit: ' + key);
+        sendData(cached.record);
+        return;
+    }
+    if (weatherRequests[key] && now - weatherRequests[key] < WEATHER_REQUEST_TIMEOUT) {
+        console.log('Weather request already in flight: ' + key);
+        return;
+    }
+    console.log('Weather cache miss: ' + key);
+    weatherRequests[key] = now;
+
     console.log('Retrieving weather info');
+    fetchWeather(
+        pos,
+        provider,
+        weatherKey,
+        useCelsius,
+        overrideLocation,
+        function(record) {
+            delete weatherRequests[key];
+            if (!record) {
+                console.log('No weather provider answered');
+                sendError();
+                return;
+            }
+            storeWeather(key, record);
+            sendData(record);
+        }
+    );
+}
 
-    switch (provider) {
-        case OPEN_WEATHER:
-            fetchOpenWeatherMapData(
-                pos,
-                weatherKey,
-                useCelsius,
-                overrideLocation
-            );
-            break;
-        case WUNDERGROUND:
-            fetchWeatherUndergroundData(
-                pos,
-                weatherKey,
-                useCelsius,
-                overrideLocation
-            );
-            break;
-        case YAHOO:
-            fetchYahooData(pos, useCelsius, overrideLocation);
-            break;
-        case FORECAST:
-            fetchForecastApiData(pos, weatherKey, useCelsius, overrideLocation);
-            break;
-        default:
-            fetchYahooData(pos, useCelsius, overrideLocation);
-            break;
+// every provider reports the same record through success(), or calls failure()
+var weatherProviders = {};
+weatherProviders[OPEN_WEATHER] = {
+    name: 'OpenWeatherMap',
+    key: 'openWeatherKey',
+    fetch: fetchOpenWeatherMapData,
+};
+weatherProviders[WUNDERGROUND] = {
+    name: 'Weather Underground',
+    key: 'weatherKey',
+    fetch: fetchWeatherUndergroundData,
+};
+weatherProviders[YAHOO] = {
+    name: 'Yahoo',
+    key: null,
+    fetch: fetchYahooData,
+};
+weatherProviders[FORECAST] = {
+    name: 'Dark Sky',
+    key: 'forecastKey',
+    fetch: fetchForecastApiData,
+};
+
+// providers tried when the selected one fails, keyless ones last
+var WEATHER_FAILOVER_ORDER = [OPEN_WEATHER, FORECAST, WUNDERGROUND, YAHOO];
+var WEATHER_FAILOVER_DEADLINE = 10 * 1000;
+
+function getWeatherProvider(provider) {
+    return weatherProviders[provider] ? provider : YAHOO;
+}
+
+function getWeatherProviderKey(provider) {
+    var key = weatherProviders[provider].key;
+    return key ? localStorage[key] || '' : '';
+}
+
+function getFailoverProvider(provider) {
+    for (var i = 0; i < WEATHER_FAILOVER_ORDER.length; i++) {
+        var candidate = WEATHER_FAILOVER_ORDER[i];
+        if (
+            candidate !== provider &&
+            (!weatherProviders[candidate].key || getWeatherProviderKey(candidate))
+        ) {
+            return candidate;
+        }
     }
+    return null;
+}
+
+function weatherRecord(
+    temp,
+    max,
+    min,
+    condition,
+    feels,
+    speed,
+    direction,
+    sunrise,
+    sunset
+) {
+    return {
+        temp: temp,
+        max: max,
+        min: min,
+        condition: condition,
+        feels: feels,
+        speed: speed,
+        direction: direction,
+        sunrise: sunrise,
+        sunset: sunset,
+    };
+}
+
+function recordWeatherStats(provider, started, ok) {
+    var stats;
+    try {
+        stats = JSON.parse(localStorage.weatherStats || '{}');
+    } catch (ex) {
+        stats = {};
+    }
+    var entry = stats[provider] || { requests: 0, errors: 0, totalMs: 0 };
+    entry.requests += 1;
+    if (ok) {
+        entry.totalMs += Date.now() - started;
+    } else {
+        entry.errors += 1;
+    }
+    stats[provider] = entry;
+    localStorage.weatherStats = JSON.stringify(stats);
+    console.log(
+        weatherProviders[provider].name +
+            ': ' +
+            entry.requests +
+            ' requests, ' +
+            entry.errors +
+            ' errors, ' +
+            Math.round(entry.totalMs / Math.max(1, entry.requests - entry.errors)) +
+            'ms average'
+    );
+}
+
+// the selected provider gets a head start; a backup joins the race when it
+// fails or misses the deadline, and the first record that arrives is used
+function fetchWeather(
+    pos,
+    provider,
+    weatherKey,
+    useCelsius,
+    overrideLocation,
+    callback
+) {
+    var done = false;
+    var failedOver = false;
+    var attempts = 0;
+    var failures = 0;
+    var timer = null;
+
+    var finish = function(record) {
+        done = true;
+        clearTimeout(timer);
+        callback(record);
+    };
+
+    var failover = function() {
+        clearTimeout(timer);
+        if (failedOver || done) {
+            return;
+        }
+        failedOver = true;
+        var backup = getFailoverProvider(provider);
+        if (backup !== null) {
+            console.log('Failing over to ' + weatherProviders[backup].name);
+            attempt(backup, getWeatherProviderKey(backup));
+        } else if (failures === attempts) {
+            finish(null);
+        }
+    };
+
+    var attempt = function(id, key) {
+        var started = Date.now();
+        attempts += 1;
+        weatherProviders[id].fetch(
+            pos,
+            key,
+            useCelsius,
+            overrideLocation,
+            function(record) {
+                recordWeatherStats(id, started, true);
+                if (!done) {
+                    finish(record);
+                }
+            },
+            function() {
+                recordWeatherStats(id, started, false);
+                failures += 1;
+                if (!failedOver) {
+                    failover();
+                } else if (!done && failures === attempts) {
+                    finish(null);
+                }
+            }
+        );
+    };
+
+    provider = getWeatherProvider(provider);
+    timer = setTimeout(failover, WEATHER_FAILOVER_DEADLINE);
+    attempt(provider, weatherKey);
 }
 
-function executeYahooQuery(pos, useCelsius, woeid, overrideLocation) {
+function executeYahooQuery(
+    pos,
+    useCelsius,
+    woeid,
+    overrideLocation,
+    success,
+    failure
+) {
     var url =
         'https://query.yahooapis.com/v1/public/yql?format=json&env=store%3A%2F%2Fdatatables.org%2Falltableswithkeys&q=';
     var woeidQuery = '';
@@ -364,24 +739,18 @@ function executeYahooQuery(pos, useCelsius, woeid, overrideLocation) {
                     condition = 0;
                 }
 
-                sendData(
-                    temp,
-                    max,
-                    min,
-                    condition,
-                    feels,
-                    speed,
-                    direction,
-                    sunrise,
-                    sunset
+                success(
+                    weatherRecord(temp, max, min, condition, feels, speed, direction, sunrise, sunset)
                 );
             } catch (ex) {
                 console.log(ex);
                 console.log('Yahoo weather failed!');
+                failure();
             }
-        });
+        }, failure);
     } else {
         console.log('No woeid found!');
+        failure();
     }
 }
 
@@ -401,11 +770,18 @@ function formatYahooTime(time) {
     return parseInt(newTime.getTime() / 1000, 10);
 }
 
-function fetchYahooData(pos, useCelsius, overrideLocation) {
+function fetchYahooData(
+    pos,
+    weatherKey,
+    useCelsius,
+    overrideLocation,
+    success,
+    failure
+) {
     if (!overrideLocation) {
-        getWoeidAndExecuteQuery(pos, useCelsius);
+        getWoeidAndExecuteQuery(pos, useCelsius, success, failure);
     } else {
-        executeYahooQuery(pos, useCelsius, '', overrideLocation);
+        executeYahooQuery(pos, useCelsius, '', overrideLocation, success, failure);
     }
 }
 
@@ -413,7 +789,7 @@ function fahrenheitToCelsius(temp) {
     return (temp - 32) / 1.8;
 }
 
-function getWoeidAndExecuteQuery(pos, useCelsius) {
+function getWoeidAndExecuteQuery(pos, useCelsius, success, failure) {
     var truncLat = pos.coords.latitude.toFixed(4);
     var truncLng = pos.coords.longitude.toFixed(4);
     var latLng = truncLat + ',' + truncLng;
@@ -422,7 +798,14 @@ function getWoeidAndExecuteQuery(pos, useCelsius) {
         console.log(
             'Got woeid from storage. ' + latLng + ': ' + localStorage[latLng]
         );
-        executeYahooQuery(pos, useCelsius, localStorage[latLng]);
+        executeYahooQuery(
+            pos,
+            useCelsius,
+            localStorage[latLng],
+            '',
+            success,
+            failure
+        );
         return;
     }
 
@@ -441,24 +824,26 @@ function getWoeidAndExecuteQuery(pos, useCelsius) {
                 var woeid = resp.ResultSet.Results[0].woeid;
                 console.log('Got woeid from API. ' + latLng + ': ' + woeid);
                 localStorage[latLng] = woeid;
-                executeYahooQuery(pos, useCelsius, woeid);
+                executeYahooQuery(pos, useCelsius, woeid, '', success, failure);
             } else {
                 console.log('woeid query failed: ' + resp.ResultSet.Error);
-                executeYahooQuery(pos, useCelsius, '');
+                executeYahooQuery(pos, useCelsius, '', '', success, failure);
             }
         } catch (ex) {
             console.log(ex.stack);
             console.log('woeid query failed');
-            executeYahooQuery(pos, useCelsius, '');
+            executeYahooQuery(pos, useCelsius, '', '', success, failure);
         }
-    });
+    }, failure);
 }
 
 function fetchWeatherUndergroundData(
     pos,
     weatherKey,
     useCelsius,
-    overrideLocation
+    overrideLocation,
+    success,
+    failure
 ) {
     var url =
         'http://api.wunderground.com/api/' +
@@ -515,23 +900,14 @@ function fetchWeatherUndergroundData(
                 condition = 0;
             }
 
-            sendData(
-                temp,
-                max,
-                min,
-                condition,
-                feels,
-                speed,
-                direction,
-                sunrise,
-                sunset
+            success(
+                weatherRecord(temp, max, min, condition, feels, speed, direction, sunrise, sunset)
             );
         } catch (ex) {
             console.log(ex.stack);
-            console.log('Falling back to Yahoo');
-            fetchYahooData(pos, useCelsius, overrideLocation);
+            failure();
         }
-    });
+    }, failure);
 }
 
 function formatWeatherUndergroundDate(hours, minutes) {
@@ -542,15 +918,34 @@ function formatWeatherUndergroundDate(hours, minutes) {
     return parseInt(time.getTime() / 1000, 10);
 }
 
-function fetchForecastApiData(pos, weatherKey, useCelsius, overrideLocation) {
+function fetchForecastApiData(
+    pos,
+    weatherKey,
+    useCelsius,
+    overrideLocation,
+    success,
+    failure
+) {
     if (overrideLocation) {
-        findLocationAndExecuteQuery(weatherKey, useCelsius, overrideLocation);
+        findLocationAndExecuteQuery(
+            weatherKey,
+            useCelsius,
+            overrideLocation,
+            success,
+            failure
+        );
     } else {
-        executeForecastQuery(pos, weatherKey, useCelsius);
+        executeForecastQuery(pos, weatherKey, useCelsius, '', success, failure);
     }
 }
 
-function findLocationAndExecuteQuery(weatherKey, useCelsius, overrideLocation) {
+function findLocationAndExecuteQuery(
+    weatherKey,
+    useCelsius,
+    overrideLocation,
+    success,
+    failure
+) {
     if (localStorage[overrideLocation]) {
         console.log(
             'Got coords for ' +
@@ -562,7 +957,9 @@ function findLocationAndExecuteQuery(weatherKey, useCelsius, overrideLocation) {
             JSON.parse(localStorage[overrideLocation]),
             weatherKey,
             useCelsius,
-            overrideLocation
+            overrideLocation,
+            success,
+            failure
         );
         return;
     }
@@ -590,16 +987,29 @@ function findLocationAndExecuteQuery(weatherKey, useCelsius, overrideLocation) {
 
             localStorage[overrideLocation] = JSON.stringify(pos);
 
-            executeForecastQuery(pos, weatherKey, useCelsius, overrideLocation);
+            executeForecastQuery(
+                pos,
+                weatherKey,
+                useCelsius,
+                overrideLocation,
+                success,
+                failure
+            );
         } catch (ex) {
             console.log(ex.stack);
-            console.log('Falling back to Yahoo');
-            fetchYahooData(pos, useCelsius, overrideLocation);
+            failure();
         }
-    });
+    }, failure);
 }
 
-function executeForecastQuery(pos, weatherKey, useCelsius, overrideLocation) {
+function executeForecastQuery(
+    pos,
+    weatherKey,
+    useCelsius,
+    overrideLocation,
+    success,
+    failure
+) {
     console.log(JSON.stringify(pos));
     var truncLat = pos.coords.latitude.toFixed(4);
     var truncLng = pos.coords.longitude.toFixed(4);
@@ -653,23 +1063,14 @@ function executeForecastQuery(pos, weatherKey, useCelsius, overrideLocation) {
                 condition = 0;
             }
 
-            sendData(
-                temp,
-                max,
-                min,
-                condition,
-                feels,
-                speed,
-                direction,
-                sunrise,
-                sunset
+            success(
+                weatherRecord(temp, max, min, condition, feels, speed, direction, sunrise, sunset)
             );
         } catch (ex) {
             console.log(ex.stack);
-            console.log('Falling back to Yahoo');
-            fetchYahooData(pos, useCelsius, overrideLocation);
+            failure();
         }
-    });
+    }, failure);
 }
 
 function formatTimestamp(timestamp) {
@@ -680,7 +1081,9 @@ function fetchOpenWeatherMapData(
     pos,
     weatherKey,
     useCelsius,
-    overrideLocation
+    overrideLocation,
+    success,
+    failure
 ) {
     var url =
         'http://api.openweathermap.org/data/2.5/weather?appid=' + weatherKey;
@@ -765,35 +1168,26 @@ function fetchOpenWeatherMapData(
                         }
                     }
 
-                    sendData(
-                        temp,
-                        max,
-                        min,
-                        condition,
-                        feels,
-                        speed,
-                        direction,
-                        sunrise,
-                        sunset
-                   );
+                    success(
+                        weatherRecord(temp, max, min, condition, feels, speed, direction, sunrise, sunset)
+                    );
                 } catch (ex) {
                     console.log(
                         'Failure requesting forecast data from OpenWeatherMap.'
                     );
                     console.log(ex.stack);
 
-                    sendData(
-                        temp,
-                        max,
-                        min,
-                        condition,
-                        feels,
-                        speed,
-                        direction,
-                        sunrise,
-                        sunset
-                   );
+                    success(
+                        weatherRecord(temp, max, min, condition, feels, speed, direction, sunrise, sunset)
+                    );
                 }
+            }, function() {
+                console.log(
+                    'Failure requesting forecast data from OpenWeatherMap.'
+                );
+                success(
+                    weatherRecord(temp, max, min, condition, feels, speed, direction, sunrise, sunset)
+                );
             });
 
         } catch (ex) {
@@ -801,8 +1195,9 @@ function fetchOpenWeatherMapData(
                 'Failure requesting current weather from OpenWeatherMap.'
             );
             console.log(ex.stack);
+            failure();
         }
-    });
+    }, failure);
 }
 
 function checkForUpdates() {
@@ -848,27 +1243,32 @@ function kelvinToFahrenheit(temp) {
     return Math.round(temp * 1.8 - 459.67);
 }
 
-function sendData(
-    temp,
-    max,
-    min,
-    condition,
-    feels,
-    speed,
-    direction,
-    sunrise,
-    sunset
-) {
+// must match the packed layout read by update_weather_from_payload on the watch
+var WEATHER_PAYLOAD_VERSION = 1;
+
+function packWeather(values) {
+    var bytes = [WEATHER_PAYLOAD_VERSION];
+    values.forEach(function(field) {
+        var value = Math.round(field[0] || 0);
+        for (var i = 0; i < field[1]; i++) {
+            bytes.push((value >> (8 * i)) & 0xff);
+        }
+    });
+    return bytes;
+}
+
+function sendData(record) {
     var data = {
-        KEY_TEMP: temp || 0,
-        KEY_MAX: max || 0,
-        KEY_MIN: min || 0,
-        KEY_WEATHER: condition || 0,
-        KEY_FEELS: feels || 0,
-        KEY_SPEED: speed || 0,
-        KEY_DIRECTION: direction || 0,
-        KEY_SUNRISE: sunrise || 0,
-        KEY_SUNSET: sunset || 0,
+        KEY_WEATHERDATA: packWeather([
+            [record.condition, 1],
+            [record.temp, 2],
+            [record.max, 2],
+            [record.min, 2],
+            [record.speed, 2],
+            [record.direction, 2],
+            [record.sunrise, 4],
+            [record.sunset, 4],
+        ]),
     };
 
     console.log(JSON.stringify(data));
@@ -912,22 +1312,143 @@ function getWeather(provider, weatherKey, useCelsius, overrideLocation) {
             overrideLocation
         );
     } else {
-        navigator.geolocation.getCurrentPosition(
-            function(pos) {
-                locationSuccess(
-                    pos,
-                    provider,
-                    weatherKey,
-                    useCelsius,
-                    overrideLocation
-                );
-            },
-            locationError,
-            { timeout: 15000, maximumAge: 60000 }
-        );
+        getPosition(function(pos) {
+            locationSuccess(
+                pos,
+                provider,
+                weatherKey,
+                useCelsius,
+                overrideLocation
+            );
+        });
     }
 }
 
+// a stationary phone keeps using its last fix; until that is too old only a
+// coarse fix the system may already have is asked for to see if we moved
+var POSITION_MAX_AGE = 2 * 60 * 60 * 1000;
+var POSITION_COARSE_AGE = 30 * 60 * 1000;
+var POSITION_RADIUS = 1000;
+
+function getPositionMaxAge() {
+    var minutes = parseInt(localStorage.positionMaxAge, 10);
+    return isNaN(minutes) ? POSITION_MAX_AGE : minutes * 60 * 1000;
+}
+
+function getDistance(a, b) {
+    var rad = Math.PI / 180;
+    var x =
+        (b.longitude - a.longitude) *
+        rad *
+        Math.cos((a.latitude + b.latitude) / 2 * rad);
+    var y = (b.latitude - a.latitude) * rad;
+    return Math.sqrt(x * x + y * y) * 6371000;
+}
+
+function countPositionFix(kind) {
+    var count = (parseInt(localStorage[kind], 10) || 0) + 1;
+    localStorage[kind] = count;
+    console.log(kind + ': ' + count);
+}
+
+function storePosition(pos) {
+    var position = {
+        latitude: pos.coords.latitude,
+        longitude: pos.coords.longitude,
+        accuracy: pos.coords.accuracy,
+        time: Date.now(),
+    };
+    localStorage.lastPosition = JSON.stringify(position);
+    return position;
+}
+
+function readPosition() {
+    try {
+        return JSON.parse(localStorage.lastPosition || 'null');
+    } catch (ex) {
+        return null;
+    }
+}
+
+function getFullPosition(callback) {
+    navigator.geolocation.getCurrentPosition(
+        function(pos) {
+            countPositionFix('positionFixes');
+            storePosition(pos);
+            callback(pos);
+        },
+        locationError,
+        { timeout: 15000, maximumAge: 60000 }
+    );
+}
+
+function getPosition(callback) {
+    var cached = readPosition();
+    if (!cached || Date.now() - cached.time >= getPositionMaxAge()) {
+        getFullPosition(callback);
+        return;
+    }
+
+    var cachedPos = {
+        coords: { latitude: cached.latitude, longitude: cached.longitude },
+    };
+    navigator.geolocation.getCurrentPosition(
+        function(pos) {
+            countPositionFix('positionCoarseFixes');
+            var moved = getDistance(cached, pos.coords);
+            if (moved > POSITION_RADIUS + (cached.accuracy || 0) + (pos.coords.accuracy || 0)) {
+                // the coarse fix is good enough for the weather, no need for another
+                console.log('Moved ' + Math.round(moved) + 'm, using the new fix');
+                storePosition(pos);
+                callback(pos);
+            } else {
+                console.log('Reusing position from ' + new Date(cached.time));
+                callback(cachedPos);
+            }
+        },
+        function(err) {
+            console.log('Coarse location failed, reusing last position');
+            callback(cachedPos);
+        },
+        {
+            enableHighAccuracy: false,
+            timeout: 5000,
+            maximumAge: POSITION_COARSE_AGE,
+        }
+    );
+}
+
+// prices are kept across restarts of the js, so the request a watch makes
+// when the face or its config is reloaded does not download them again;
+// shorter than the shortest refresh interval so scheduled ones always do
+var CRYPTO_CACHE_TTL = 4 * 60 * 1000;
+
+function readCryptoCache() {
+    try {
+        return JSON.parse(localStorage.cryptoCache || '{}');
+    } catch (ex) {
+        return {};
+    }
+}
+
+function storeCryptoPrices(prices) {
+    var cache = readCryptoCache();
+    var now = Date.now();
+    Object.keys(cache).forEach(function(cached) {
+        if (now - cache[cached].time >= CRYPTO_CACHE_TTL) {
+            delete cache[cached];
+        }
+    });
+    Object.keys(prices).forEach(function(pair) {
+        cache[pair] = { time: now, price: prices[pair] };
+    });
+    localStorage.cryptoCache = JSON.stringify(cache);
+}
+
+var formatCryptoPrice = function(price, multi) {
+    return formatNumber(multi ? Math.round(parseFloat(price) * 100000000) : price);
+};
+
 var getCryptocurrencies = function() {
     try {
         var fromA = localStorage.cryptoFrom;
@@ -947,72 +1468,140 @@ var getCryptocurrencies = function() {
         var multiC = parse(('' + localStorage.cryptoMultiC || 'false').toLowerCase());
         var multiD = parse(('' + localStorage.cryptoMultiD || 'false').toLowerCase());
 
-        var data = {};
         var info = {};
 
         if (fromA && fromA !== 'None' && toA && toA !== 'None' && marketA && marketA !== 'None') {
-            data.KEY_CRYPTOPRICE = null;
             info.KEY_CRYPTOPRICE = { to: toA, from: fromA, market: marketA, multi: multiA };
         }
         if (fromB && fromB !== 'None' && toB && toB !== 'None' && marketB && marketB !== 'None') {
-            data.KEY_CRYPTOPRICEB = null;
             info.KEY_CRYPTOPRICEB = { to: toB, from: fromB, market: marketB, multi: multiB };
         }
         if (fromC && fromC !== 'None' && toC && toC !== 'None' && marketC && marketC !== 'None') {
-            data.KEY_CRYPTOPRICEC = null;
             info.KEY_CRYPTOPRICEC = { to: toC, from: fromC, market: marketC, multi: multiC };
         }
         if (fromD && fromD !== 'None' && toD && toD !== 'None' && marketD && marketD !== 'None') {
-            data.KEY_CRYPTOPRICED = null;
             info.KEY_CRYPTOPRICED = { to: toD, from: fromD, market: marketD, multi: multiD };
         }
 
         console.log(JSON.stringify(info));
 
-        var retries = 0;
-        var interval = setInterval(function() {
-            var gotAll = true;
-            Object.keys(data).forEach(function(key) {
-                if (data[key] === null) {
-                    gotAll = false;
+        var data = {};
+        var markets = {};
+        var now = Date.now();
+        var cache = readCryptoCache();
+        Object.keys(info).forEach(function(key) {
+            var reqInfo = info[key];
+            var cached = cache[reqInfo.market + ':' + reqInfo.from + ':' + reqInfo.to];
+            if (cached && now - cached.time < CRYPTO_CACHE_TTL) {
+                data[key] = formatCryptoPrice(cached.price, reqInfo.multi);
+            } else {
+                markets[reqInfo.market] = markets[reqInfo.market] || [];
+                markets[reqInfo.market].push(key);
+            }
+        });
+
+        // prices go to the watch as each market answers, one message at a time;
+        // whatever arrives while a message is in flight is merged into the next
+        var sent = false;
+        var sending = false;
+        var pending = null;
+        var send = function(prices) {
+            sent = true;
+            if (sending) {
+                pending = pending || {};
+                Object.keys(prices).forEach(function(key) {
+                    pending[key] = prices[key];
+                });
+                return;
+            }
+            sending = true;
+            var next = function() {
+                sending = false;
+                if (pending) {
+                    var prices = pending;
+                    pending = null;
+                    send(prices);
                 }
-            });
+            };
+            Pebble.sendAppMessage(
+                prices,
+                function(e) {
+                    console.log('Cryptocurrencies info sent to Pebble successfully!');
+                    next();
+                },
+                function(e) {
+                    console.log('Error sending cryptocurrencies info to Pebble!');
+                    next();
+                }
+            );
+        };
 
-            if (gotAll) {
-                console.log('Got all crypto!');
-                clearInterval(interval);
-                Pebble.sendAppMessage(
-                    data,
-                    function(e) {
-                        console.log('Cryptocurrencies info sent to Pebble successfully!');
-                    },
-                    function(e) {
-                        console.log('Error sending cryptocurrencies info to Pebble!');
-                    }
-                );
-            } else if (retries > 20) {
-                console.log('Too many retries. Canceling crypto request.');
-                clearInterval(interval);
-                sendError();
+        if (Object.keys(data).length > 0) {
+            send(data);
+        }
+
+        var remaining = Object.keys(markets).length;
+        if (remaining === 0) {
+            if (sent) {
+                console.log('Got all crypto from cache!');
             } else {
-                console.log('Still waiting for crypto...');
-                retries += 1;
+                sendError();
             }
+            return;
+        }
 
-        }, 200);
-
-        Object.keys(info).forEach(function(key) {
-            var reqInfo = info[key];
+        // one request per market covers every pair on it
+        Object.keys(markets).forEach(function(market) {
+            var keys = markets[market];
+            var fsyms = [];
+            var tsyms = [];
+            keys.forEach(function(key) {
+                if (fsyms.indexOf(info[key].from) === -1) {
+                    fsyms.push(info[key].from);
+                }
+                if (tsyms.indexOf(info[key].to) === -1) {
+                    tsyms.push(info[key].to);
+                }
+            });
+            var done = function() {
+                remaining -= 1;
+                if (remaining === 0 && !sent) {
+                    sendError();
+                }
+            };
             xhrRequest(
-                'https://min-api.cryptocompare.com/data/price?fsym=' + reqInfo.from + '&tsyms=' + reqInfo.to + '&e=' + reqInfo.market,
+                'https://min-api.cryptocompare.com/data/pricemulti?fsyms=' + fsyms.join(',') + '&tsyms=' + tsyms.join(',') + '&e=' + market,
                 'GET',
                 function(responseText) {
-                console.log('Got ' + key);
-                var response = JSON.parse(responseText);
-                data[key] = formatNumber(
-                    reqInfo.multi ? Math.round(parseFloat(response[reqInfo.to]) * 100000000) : response[reqInfo.to]
-                );
-            });
+                    console.log('Got crypto for ' + market);
+                    try {
+                        var response = JSON.parse(responseText);
+                        var prices = {};
+                        var pairs = {};
+                        keys.forEach(function(key) {
+                            var reqInfo = info[key];
+                            var price = response[reqInfo.from] && response[reqInfo.from][reqInfo.to];
+                            if (price === undefined) {
+                                console.log('No price for ' + reqInfo.from + ' in ' + reqInfo.to);
+                                return;
+                            }
+                            pairs[market + ':' + reqInfo.from + ':' + reqInfo.to] = price;
+                            prices[key] = formatCryptoPrice(price, reqInfo.multi);
+                        });
+                        if (Object.keys(prices).length > 0) {
+                            storeCryptoPrices(pairs);
+                            send(prices);
+                        }
+                    } catch (ex) {
+                        console.log('Error parsing crypto for ' + market);
+                    }
+                    done();
+                },
+                function() {
+                    console.log('Error requesting crypto for ' + market);
+                    done();
+                }
+            );
         });
     } catch (ex) {
         console.log('Error when retrieving cryptocurrencies');
@@ -1063,18 +1652,30 @@ var formatNumber = function(number) {
     }
 };
 
-var xhrRequest = function(url, type, callback) {
+// a request that hangs would otherwise hold up everything waiting on it
+var XHR_TIMEOUT = 15 * 1000;
+
+var xhrRequest = function(url, type, callback, errorCallback) {
     var xhr = new XMLHttpRequest();
     xhr.onload = function() {
         callback(this.responseText);
     };
+    if (errorCallback) {
+        xhr.onerror = errorCallback;
+        xhr.ontimeout = errorCallback;
+    }
 
     try {
         xhr.open(type, url);
+        xhr.timeout = XHR_TIMEOUT;
         xhr.send();
     } catch (ex) {
         console.log(ex);
-        sendError();
+        if (errorCallback) {
+            errorCallback();
+        } else {
+            sendError();
+        }
     }
 };
 
@@ -145,6 +145,10 @@
 #define KEY_QUIETTIMECOLOR 141
 #define KEY_QUIETTIMEON 142
 #define KEY_DATELEADINGZERO 143
+#define KEY_SETTINGS 144
+#define KEY_HEALTH_BASELINES 145
+#define KEY_WEATHERDATA 146
+#define KEY_CONFIGDONE 147
 
 #define FLAG_WEATHER 0x0001
 #define FLAG_HEALTH 0x0002
@@ -239,6 +243,7 @@
 #define MODULE_PHONEBATTERY 24
 #define MODULE_CUSTOMTEXTA 25
 #define MODULE_CUSTOMTEXTB 26
+#define NUM_MODULES 27
 
 #define MODE_NORMAL 0
 #define MODE_SIMPLE 1
@@ -288,4 +293,48 @@
 #define RELOAD_REDRAW 2
 #define RELOAD_MODULE 3
 
+#define COLOR_BG 0
+#define COLOR_HOURS 1
+#define COLOR_ALTHOURS 2
+#define COLOR_ALTHOURSB 3
+#define COLOR_DATE 4
+#define COLOR_BLUETOOTH 5
+#define COLOR_UPDATE 6
+#define COLOR_QUIETTIME 7
+#define COLOR_BATTERY 8
+#define COLOR_BATTERYLOW 9
+#define COLOR_PHONEBATTERY 10
+#define COLOR_PHONEBATTERYLOW 11
+#define COLOR_TEMP 12
+#define COLOR_WEATHER 13
+#define COLOR_MIN 14
+#define COLOR_MAX 15
+#define COLOR_WINDDIR 16
+#define COLOR_WINDSPEED 17
+#define COLOR_COMPASS 18
+#define COLOR_SUNRISE 19
+#define COLOR_SUNSET 20
+#define COLOR_SECONDS 21
+#define COLOR_CRYPTO 22
+#define COLOR_CRYPTOB 23
+#define COLOR_CRYPTOC 24
+#define COLOR_CRYPTOD 25
+#define COLOR_CUSTOMTEXTA 26
+#define COLOR_CUSTOMTEXTB 27
+#define COLOR_STEPS 28
+#define COLOR_STEPSBEHIND 29
+#define COLOR_DIST 30
+#define COLOR_DISTBEHIND 31
+#define COLOR_CAL 32
+#define COLOR_CALBEHIND 33
+#define COLOR_SLEEP 34
+#define COLOR_SLEEPBEHIND 35
+#define COLOR_DEEP 36
+#define COLOR_DEEPBEHIND 37
+#define COLOR_ACTIVE 38
+#define COLOR_ACTIVEBEHIND 39
+#define COLOR_HEART 40
+#define COLOR_HEARTOFF 41
+#define NUM_COLORS 42
+
 #endif
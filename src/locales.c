@@ -100,6 +100,6 @@ void get_current_date(struct tm* tick_time, char* buffer, int buf_size, int sepa
 }
 
 void load_locale() {
-    selected_locale = persist_exists(KEY_LOCALE) ? persist_read_int(KEY_LOCALE) : LC_ENGLISH;
-    selected_format = persist_exists(KEY_DATEFORMAT) ? persist_read_int(KEY_DATEFORMAT): FORMAT_WMD;
+    selected_locale = get_locale();
+    selected_format = get_date_format();
 }
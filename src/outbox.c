@@ -0,0 +1,93 @@
+#include <pebble.h>
+#include "outbox.h"
+#include "keys.h"
+#include "configs.h"
+#include "profiler.h"
+
+#define OUTBOX_MIN_BACKOFF 1000
+#define OUTBOX_MAX_BACKOFF (60 * 1000)
+
+// requests in the order they are written to the message, most important first
+static const uint32_t request_keys[] = {
+    KEY_CONFIGDONE,
+    KEY_REQUESTWEATHER,
+    KEY_REQUESTCRYPTO,
+    KEY_REQUESTPHONEBATTERY,
+    KEY_HASUPDATE,
+};
+
+static uint8_t pending;
+static uint8_t in_flight;
+static uint32_t backoff;
+static AppTimer *retry_timer;
+
+void outbox_request(uint32_t key) {
+    for (int i = 0; i < (int)ARRAY_LENGTH(request_keys); ++i) {
+        if (request_keys[i] == key) {
+            if ((pending | in_flight) & (1 << i)) {
+                profile_count(COUNTER_OUTBOX_COALESCED, 1);
+            }
+            pending |= 1 << i;
+        }
+    }
+}
+
+static void retry_handler(void *context) {
+    retry_timer = NULL;
+    outbox_flush();
+}
+
+static void schedule_retry() {
+    backoff = backoff ? backoff * 2 : OUTBOX_MIN_BACKOFF;
+    if (backoff > OUTBOX_MAX_BACKOFF) {
+        backoff = OUTBOX_MAX_BACKOFF;
+    }
+    profile_count(COUNTER_OUTBOX_RETRIES, 1);
+    retry_timer = app_timer_register(backoff, retry_handler, NULL);
+}
+
+void outbox_flush() {
+    // one message at a time, and nothing while waiting to retry or without a phone
+    if (!pending || in_flight || retry_timer || !connection_service_peek_pebble_app_connection()) {
+        return;
+    }
+
+    DictionaryIterator *iter;
+    if (app_message_outbox_begin(&iter) != APP_MSG_OK) {
+        schedule_retry();
+        return;
+    }
+
+    for (int i = 0; i < (int)ARRAY_LENGTH(request_keys); ++i) {
+        if (!(pending & (1 << i))) {
+            continue;
+        }
+        if (request_keys[i] == KEY_CONFIGDONE) {
+            // 0 tells the phone the watch has no config from it
+            dict_write_int32(iter, KEY_CONFIGDONE, get_config_generation());
+        } else {
+            dict_write_uint8(iter, request_keys[i], 1);
+        }
+    }
+
+    if (app_message_outbox_send() != APP_MSG_OK) {
+        schedule_retry();
+        return;
+    }
+
+    profile_count(COUNTER_OUTBOX_SEND, 1);
+    in_flight = pending;
+    pending = 0;
+}
+
+void outbox_sent() {
+    in_flight = 0;
+    backoff = 0;
+    outbox_flush();
+}
+
+void outbox_failed() {
+    pending |= in_flight;
+    in_flight = 0;
+    schedule_retry();
+}
@@ -0,0 +1,11 @@
+#ifndef __TIMEBOXED_OUTBOX_
+#define __TIMEBOXED_OUTBOX_
+
+#include <pebble.h>
+
+void outbox_request(uint32_t key);
+void outbox_flush();
+void outbox_sent();
+void outbox_failed();
+
+#endif
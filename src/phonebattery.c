@@ -3,11 +3,11 @@
 #include "phonebattery.h"
 #include "keys.h"
 #include "text.h"
+#include "scheduler.h"
 
 #if !defined PBL_PLATFORM_APLITE
 
 static bool phonebattery_enabled;
-static bool force_update = false;
 static int last_update = 0;
 static int phonebattery_interval = 5;
 /* exp time == 90 + 10 extra (because in timeboxed.c time when pebble
@@ -43,35 +43,31 @@ void update_phonebattery_from_storage(){
 void store_phonebattery_vals(int lvl_val, int chg_val){
   persist_write_int(KEY_PHONEBATTERY_CHARGING, chg_val);
   persist_write_int(KEY_PHONEBATTERY_LEVEL, lvl_val);
+  last_update = (int)time(NULL);
+}
+
+static void expire_phonebattery() {
+    int current_time = (int)time(NULL);
+    if ((current_time - last_update) >= phonebattery_expiration * 60) {
+      set_phonebattery_layer_text("");
+    }
 }
 
 void toggle_phonebattery(uint8_t reload_origin) {
     phonebattery_enabled = is_module_enabled(MODULE_PHONEBATTERY);
     if (reload_origin == RELOAD_CONFIGS || reload_origin == RELOAD_DEFAULT) {
-      phonebattery_interval = persist_exists(KEY_PHONEBATTERYTIME) ? persist_read_int(KEY_PHONEBATTERYTIME) : 5;
+      phonebattery_interval = get_phonebattery_interval();
     }
+    set_task(TASK_PHONEBATTERY, phonebattery_enabled, phonebattery_interval * SECONDS_PER_MINUTE);
+    set_task_handler(TASK_PHONEBATTERY, expire_phonebattery);
     if (phonebattery_enabled) {
       update_phonebattery_from_storage();
       if (reload_origin == RELOAD_MODULE || reload_origin == RELOAD_CONFIGS) {
-	force_update = true;
+        force_task(TASK_PHONEBATTERY);
       }
     } else {
       set_phonebattery_layer_text("");
     }
 }
 
-bool is_phonebattery_need_update() {
-    int current_time = (int)time(NULL);
-    bool fup = force_update;
-    force_update = false;
-    if ((current_time - last_update) >= phonebattery_expiration * 60) {
-      set_phonebattery_layer_text("");
-    }
-    return (phonebattery_enabled && (fup || last_update == 0 || (current_time - last_update) >= phonebattery_interval * 60));
-}
-
-void phonebattery_set_updatetime(int updtime) {
-  last_update = updtime;
-}
-
 #endif
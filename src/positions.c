@@ -3,6 +3,151 @@
 #include "keys.h"
 #include "configs.h"
 
+#define NUM_FONTS 8
+#define NUM_ITEMS 30
+
+#define XY(round_x, rect_x, y) { PBL_IF_ROUND_ELSE(round_x, rect_x), y }
+
+struct Offset {
+    int8_t x;
+    int8_t y;
+};
+
+// offsets of the hours, date and status icons from the vertical midpoint;
+// the x positions of the icons depend on the text alignment on rect screens
+struct FontPositions {
+    int8_t hours_y;
+    int8_t date_y;
+    int8_t icons_y;
+    int8_t bluetooth_y;
+    int8_t quiettime_y;
+    int8_t updates_y;
+    int8_t bluetooth_x[3];
+    int8_t quiettime_x[3];
+    int8_t updates_x[3];
+};
+
+static const struct FontPositions font_positions[NUM_FONTS] = {
+    // BLOCKO_FONT
+    { -46, 6, 34, -24, 0, -6, { -4, 126, 0 }, { 7, 7, 0 }, { -4, 112, 0 } },
+    // BLOCKO_BIG_FONT
+    { -52, 4, 40, -30, -6, -8, { -4, 126, 0 }, { 7, 7, 0 }, { -4, 112, 0 } },
+    // SYSTEM_FONT
+    { -42, 2, 40, -30, -6, -8, { -4, 126, 0 }, { 7, 7, 0 }, { -4, 112, 0 } },
+    // ARCHIVO_FONT
+    { -44, 8, 40, -30, -6, -8, { -4, 126, 0 }, { 7, 7, 0 }, { -4, 112, 0 } },
+    // DIN_FONT
+    { -45, 8, 40, -30, -6, -8, { -4, 126, 0 }, { 7, 7, 0 }, { -4, 112, 0 } },
+    // PROTOTYPE_FONT
+    { -40, 8, 34, -24, 0, -6, { -2, 126, -2 }, { 9, 9, -2 }, { -2, 112, -2 } },
+    // LECO_FONT
+    { -38, 9, 34, -26, -2, -8, { -4, 126, -2 }, { 7, 7, -2 }, { -4, 112, -2 } },
+    // KONSTRUCT_FONT
+    { -24, 10, 40, -30, -6, -8, { -4, 126, -2 }, { 7, 7, -2 }, { -4, 112, -2 } },
+};
+
+// offset of every item inside its slot, per font
+static const struct Offset item_offsets[NUM_ITEMS][NUM_FONTS] = {
+    // WEATHER_ITEM
+    { XY(-14, 0, 0), XY(-14, 0, 0), XY(-14, 0, 0), XY(-14, 0, 0),
+      XY(-14, 0, 0), XY(-16, 0, 0), XY(-16, 0, 0), XY(-16, 0, 0) },
+    // TEMP_ITEM
+    { XY(16, 38, 3), XY(16, 38, 3), XY(16, 38, 3), XY(16, 38, 3),
+      XY(16, 38, 3), XY(18, 40, 3), XY(15, 39, 5), XY(15, 39, 9) },
+    // TEMPMIN_ITEM
+    { XY(70, 12, 3), XY(70, 12, 3), XY(70, 12, 3), XY(70, 12, 3),
+      XY(70, 12, 3), XY(70, 12, 3), XY(68, 10, 5), XY(68, 10, 9) },
+    // TEMPMAX_ITEM
+    { XY(108, 45, 3), XY(108, 45, 3), XY(108, 45, 3), XY(108, 45, 3),
+      XY(108, 45, 3), XY(108, 45, 3), XY(108, 45, 5), XY(108, 45, 9) },
+    // STEPS_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // DIST_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // CAL_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // SLEEP_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // DEEP_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // SPEED_ITEM
+    { XY(56, 6, 3), XY(56, 6, 3), XY(56, 6, 3), XY(56, 6, 3),
+      XY(56, 6, 3), XY(56, 6, 3), XY(56, 6, 5), XY(56, 6, 9) },
+    // DIRECTION_ITEM
+    { XY(56, 4, 3), XY(56, 4, 3), XY(56, 4, 3), XY(56, 4, 3),
+      XY(56, 4, 3), XY(56, 4, 3), XY(56, 4, 5), XY(56, 4, 5) },
+    // WIND_UNIT_ITEM
+    { XY(100, 48, 1), XY(100, 48, 3), XY(100, 48, 3), XY(100, 48, 2),
+      XY(100, 48, 3), XY(100, 48, 1), XY(100, 48, 1), XY(100, 48, 2) },
+    // TEMPMINICON_ITEM
+    { XY(60, 2, 4), XY(60, 2, 4), XY(60, 2, 4), XY(60, 2, 4),
+      XY(60, 2, 4), XY(60, 2, 4), XY(59, 1, 3), XY(59, 1, 5) },
+    // TEMPMAXICON_ITEM
+    { XY(98, 35, 4), XY(98, 35, 4), XY(98, 35, 4), XY(98, 35, 4),
+      XY(98, 35, 4), XY(98, 35, 4), XY(99, 36, 3), XY(99, 36, 5) },
+    // SUNRISE_ITEM
+    { XY(86, 22, 3), XY(86, 22, 3), XY(86, 22, 3), XY(86, 22, 3),
+      XY(86, 22, 3), XY(86, 22, 3), XY(86, 22, 5), XY(86, 22, 9) },
+    // SUNSET_ITEM
+    { XY(-86, -24, 3), XY(-86, -24, 3), XY(-86, -24, 3), XY(-86, -24, 3),
+      XY(-86, -24, 3), XY(-86, -24, 3), XY(-86, -24, 5), XY(-86, -24, 9) },
+    // SUNRISEICON_ITEM
+    { XY(60, 0, 3), XY(60, 0, 4), XY(60, 0, 4), XY(60, 0, 4),
+      XY(60, 0, 5), XY(60, 0, 3), XY(60, 0, 4), XY(60, 0, 5) },
+    // SUNSETICON_ITEM
+    { XY(-60, -4, 3), XY(-60, -4, 4), XY(-60, -4, 4), XY(-60, -4, 4),
+      XY(-60, -4, 5), XY(-60, -4, 3), XY(-60, -4, 4), XY(-60, -4, 5) },
+    // ACTIVE_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // HEART_ITEM
+    { XY(96, 38, 3), XY(96, 38, 3), XY(96, 38, 3), XY(96, 38, 3),
+      XY(96, 38, 3), XY(96, 38, 3), XY(96, 38, 5), XY(96, 38, 9) },
+    // HEARTICON_ITEM
+    { XY(64, 8, 4), XY(64, 8, 5), XY(64, 8, 5), XY(64, 8, 5),
+      XY(64, 8, 6), XY(64, 8, 4), XY(64, 8, 5), XY(64, 8, 6) },
+    // DEGREES_ITEM
+    { XY(82, 30, 3), XY(82, 30, 3), XY(82, 30, 3), XY(82, 30, 3),
+      XY(82, 30, 3), XY(82, 30, 3), XY(82, 30, 5), XY(82, 30, 9) },
+    // COMPASS_ITEM
+    { XY(60, 8, 3), XY(60, 8, 3), XY(60, 8, 3), XY(60, 8, 3),
+      XY(60, 8, 3), XY(60, 8, 3), XY(60, 8, 5), XY(60, 8, 5) },
+    // SECONDS_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // BATTERY_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // TIMEZONE_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // TIMEZONEB_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // CRYPTO_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // PHONEBATTERY_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+    // CUSTOMTEXT_ITEM
+    { XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 3),
+      XY(0, 0, 3), XY(0, 0, 3), XY(0, 0, 5), XY(0, 0, 9) },
+};
+
+// vertical offsets of the center slots from the midpoint, per font
+static const int8_t slot_e_offsets[NUM_FONTS] = { -48, -55, -53, -51, -55, -51, -48, -41 };
+static const int8_t slot_f_offsets[NUM_FONTS] = { 24, 29, 25, 31, 29, 27, 26, 19 };
+
+#ifndef PBL_ROUND
+static int module_height = 26;
+#endif
+
 GPoint create_point(int x, int y) {
     struct GPoint point;
     point.x = x;
@@ -10,960 +155,71 @@ GPoint create_point(int x, int y) {
     return point;
 }
 
-#ifndef PBL_ROUND
-static int module_height = 26;
+static int get_font_index(int font) {
+    return font >= 0 && font < NUM_FONTS ? font : BLOCKO_FONT;
+}
 
-static int get_pos(int alignment, int left_pos, int center_pos, int right_pos) {
+#ifndef PBL_ROUND
+static int get_alignment_index(GTextAlignment alignment) {
     switch (alignment) {
         case GTextAlignmentLeft:
-            return left_pos;
-            break;
+            return 0;
         case GTextAlignmentCenter:
-            return center_pos;
-            break;
-        case GTextAlignmentRight:
-            return right_pos;
-            break;
+            return 1;
+        default:
+            return 2;
     }
-    return right_pos;
 }
 #endif
 
-static void get_text_positions_blocko(GTextAlignment align, struct TextPositions* positions, int width, int height) {
-    int midpoint = height / 2;
-    positions->hours = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint - 46
-    );
-    positions->date = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint + 6
-    );
-    positions->bluetooth = create_point(
-        PBL_IF_ROUND_ELSE(134, get_pos(align, -4, 126, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 34,
-            get_pos(align, midpoint - 24, midpoint + 34, midpoint - 24)
-        )
-    );
-    positions->quiettime = create_point(
-        PBL_IF_ROUND_ELSE(7, get_pos(align, 7, 7, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 34,
-            get_pos(align, midpoint, midpoint + 34, midpoint)
-        )
-    );
-    positions->updates = create_point(
-        PBL_IF_ROUND_ELSE(120, get_pos(align, -4, 112, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 34,
-            get_pos(align, midpoint - 6, midpoint + 34, midpoint - 6)
-        )
-    );
-}
-
-static void get_text_positions_blocko_big(GTextAlignment align, struct TextPositions* positions, int width, int height) {
-    int midpoint = height / 2;
-    positions->hours = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint - 52
-    );
-    positions->date = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint + 4
-    );
-    positions->bluetooth = create_point(
-        PBL_IF_ROUND_ELSE(134, get_pos(align, -4, 126, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 30, midpoint + 40, midpoint - 30)
-        )
-    );
-    positions->quiettime = create_point(
-        PBL_IF_ROUND_ELSE(7, get_pos(align, 7, 7, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 6, midpoint + 40, midpoint - 6)
-        )
-    );
-    positions->updates = create_point(
-        PBL_IF_ROUND_ELSE(120, get_pos(align, -4, 112, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 8, midpoint + 40, midpoint - 8)
-        )
-    );
-}
-
-static void get_text_positions_system(GTextAlignment align, struct TextPositions* positions, int width, int height) {
-    int midpoint = height / 2;
-    positions->hours = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint - 42
-    );
-    positions->date = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint + 2
-    );
-    positions->bluetooth = create_point(
-        PBL_IF_ROUND_ELSE(134, get_pos(align, -4, 126, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-                get_pos(align, midpoint - 30, midpoint + 40, midpoint - 30)
-            )
-    );
-    positions->quiettime = create_point(
-        PBL_IF_ROUND_ELSE(7, get_pos(align, 7, 7, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-                get_pos(align, midpoint - 6, midpoint + 40, midpoint - 6)
-            )
-    );
-    positions->updates = create_point(
-        PBL_IF_ROUND_ELSE(120, get_pos(align, -4, 112, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-                get_pos(align, midpoint - 8, midpoint + 40, midpoint - 8)
-            )
-    );
-}
-
-static void get_text_positions_archivo(GTextAlignment align, struct TextPositions* positions, int width, int height) {
-    int midpoint = height / 2;
-    positions->hours = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint - 44
-    );
-    positions->date = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint + 8
-    );
-    positions->bluetooth = create_point(
-        PBL_IF_ROUND_ELSE(134, get_pos(align, -4, 126, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 30, midpoint + 40, midpoint - 30)
-        )
-    );
-    positions->quiettime = create_point(
-        PBL_IF_ROUND_ELSE(7, get_pos(align, 7, 7, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 6, midpoint + 40, midpoint - 6)
-        )
-    );
-    positions->updates = create_point(
-        PBL_IF_ROUND_ELSE(120, get_pos(align, -4, 112, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 8, midpoint + 40, midpoint - 8)
-        )
-    );
-}
-
-static void get_text_positions_din(GTextAlignment align, struct TextPositions* positions, int width, int height) {
-    int midpoint = height / 2;
-    positions->hours = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint - 45
-    );
-    positions->date = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint + 8
-    );
-    positions->bluetooth = create_point(
-        PBL_IF_ROUND_ELSE(134, get_pos(align, -4, 126, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 30, midpoint + 40, midpoint - 30)
-        )
-    );
-    positions->quiettime = create_point(
-        PBL_IF_ROUND_ELSE(7, get_pos(align, 7, 7, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 6, midpoint + 40, midpoint - 6)
-        )
-    );
-    positions->updates = create_point(
-        PBL_IF_ROUND_ELSE(120, get_pos(align, -4, 112, 0)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 8, midpoint + 40, midpoint - 8)
-        )
-    );
-}
-
-static void get_text_positions_prototype(GTextAlignment align, struct TextPositions* positions, int width, int height) {
-    int midpoint = height / 2;
-    positions->hours = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint - 40
-    );
-    positions->date = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint + 8
-    );
-    positions->bluetooth = create_point(
-        PBL_IF_ROUND_ELSE(134, get_pos(align, -2, 126, -2)),
-        PBL_IF_ROUND_ELSE(midpoint + 34,
-            get_pos(align, midpoint - 24, midpoint + 34, midpoint - 24)
-        )
-    );
-    positions->quiettime = create_point(
-        PBL_IF_ROUND_ELSE(7, get_pos(align, 9, 9, -2)),
-        PBL_IF_ROUND_ELSE(midpoint + 34,
-            get_pos(align, midpoint, midpoint + 34, midpoint)
-        )
-    );
-    positions->updates = create_point(
-        PBL_IF_ROUND_ELSE(120, get_pos(align, -2, 112, -2)),
-        PBL_IF_ROUND_ELSE(midpoint + 34,
-            get_pos(align, midpoint - 6, midpoint + 34, midpoint - 6)
-        )
-    );
-}
-
-static void get_text_positions_leco(GTextAlignment align, struct TextPositions* positions, int width, int height) {
-    int midpoint = height / 2;
-    positions->hours = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint - 38
-    );
-    positions->date = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint + 9
-    );
-    positions->bluetooth = create_point(
-        PBL_IF_ROUND_ELSE(134, get_pos(align, -4, 126, -2)),
-        PBL_IF_ROUND_ELSE(midpoint + 34,
-            get_pos(align, midpoint - 26, midpoint + 34, midpoint - 26)
-        )
-    );
-    positions->quiettime = create_point(
-        PBL_IF_ROUND_ELSE(7, get_pos(align, 7, 7, -2)),
-        PBL_IF_ROUND_ELSE(midpoint + 34,
-            get_pos(align, midpoint - 2, midpoint + 34, midpoint - 2)
-        )
-    );
-    positions->updates = create_point(
-        PBL_IF_ROUND_ELSE(120, get_pos(align, -4, 112, -2)),
-        PBL_IF_ROUND_ELSE(midpoint + 34,
-            get_pos(align, midpoint - 8, midpoint + 34, midpoint - 8)
-        )
-    );
-}
-
-static void get_text_positions_konstruct(GTextAlignment align, struct TextPositions* positions, int width, int height) {
-    int midpoint = height / 2;
-    positions->hours = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint - 24
-    );
-    positions->date = create_point(
-        PBL_IF_ROUND_ELSE(0, 2),
-        midpoint + 10
-    );
-    positions->bluetooth = create_point(
-        PBL_IF_ROUND_ELSE(134, get_pos(align, -4, 126, -2)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 30, midpoint + 40, midpoint - 30)
-        )
-    );
-    positions->quiettime = create_point(
-        PBL_IF_ROUND_ELSE(7, get_pos(align, 7, 7, -2)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 6, midpoint + 40, midpoint - 6)
-        )
-    );
-    positions->updates = create_point(
-        PBL_IF_ROUND_ELSE(120, get_pos(align, -4, 112, -2)),
-        PBL_IF_ROUND_ELSE(midpoint + 40,
-            get_pos(align, midpoint - 8, midpoint + 40, midpoint - 8)
-        )
-    );
-}
-
 void get_text_positions(int selected_font, GTextAlignment alignment, struct TextPositions* positions, int width, int height) {
-    switch(selected_font) {
-        case BLOCKO_FONT:
-            get_text_positions_blocko(alignment, positions, width, height);
-            break;
-        case BLOCKO_BIG_FONT:
-            get_text_positions_blocko_big(alignment, positions, width, height);
-            break;
-        case SYSTEM_FONT:
-            get_text_positions_system(alignment, positions, width, height);
-            break;
-        case ARCHIVO_FONT:
-            get_text_positions_archivo(alignment, positions, width, height);
-            break;
-        case DIN_FONT:
-            get_text_positions_din(alignment, positions, width, height);
-            break;
-        case PROTOTYPE_FONT:
-            get_text_positions_prototype(alignment, positions, width, height);
-            break;
-        case LECO_FONT:
-            get_text_positions_leco(alignment, positions, width, height);
-            break;
-        case KONSTRUCT_FONT:
-            get_text_positions_konstruct(alignment, positions, width, height);
-            break;
-        default:
-            get_text_positions_blocko(alignment, positions, width, height);
-    }
-};
-
-static GPoint get_weather_positions(int mode, int font, int width, int height) {
-    // weather condition
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case BLOCKO_BIG_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(-14, 0), 0);
-                case PROTOTYPE_FONT:
-                case LECO_FONT:
-                case KONSTRUCT_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(-16, 0), 0);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_temp_positions(int mode, int font, int width, int height) {
-    // current temperature
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(16, 38), 3);
-                case PROTOTYPE_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(18, 40), 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(16, 38), 3);
-                case LECO_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(15, 39), 5);
-                case KONSTRUCT_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(15, 39), 9);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_tempmin_positions(int mode, int font, int width, int height) {
-    // min temperature
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(70, 12), 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(70, 12), 3);
-                case LECO_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(68, 10), 5);
-                case KONSTRUCT_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(68, 10), 9);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_tempminicon_positions(int mode, int font, int width, int height) {
-    // min temperature
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(60, 2), 4);
-                case DIN_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(60, 2), 4);
-                case BLOCKO_BIG_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(60, 2), 4);
-                case LECO_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(59, 1), 3);
-                case KONSTRUCT_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(59, 1), 5);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_tempmax_positions(int mode, int font, int width, int height) {
-    // max temperature
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(108, 45), 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(108, 45), 3);
-                case LECO_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(108, 45), 5);
-                case KONSTRUCT_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(108, 45), 9);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_tempmaxicon_positions(int mode, int font, int width, int height) {
-    // max temperature
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(98, 35), 4);
-                case DIN_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(98, 35), 4);
-                case BLOCKO_BIG_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(98, 35), 4);
-                case LECO_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(99, 36), 3);
-                case KONSTRUCT_FONT:
-                    return create_point(PBL_IF_ROUND_ELSE(99, 36), 5);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-#if defined(PBL_HEALTH)
-static GPoint get_heart_positions(int mode, int font, int width, int height) {
-    // heart
-    int x_pos = PBL_IF_ROUND_ELSE(96, 38);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(x_pos, 3);
-                case LECO_FONT:
-                    return create_point(x_pos, 5);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 9);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_heart_icon_positions(int mode, int font, int width, int height) {
-    // heart icon
-    int x_pos = PBL_IF_ROUND_ELSE(64, 8);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                    return create_point(x_pos, 4);
-                case BLOCKO_BIG_FONT:
-                    return create_point(x_pos, 5);
-                case SYSTEM_FONT:
-                    return create_point(x_pos, 5);
-                case ARCHIVO_FONT:
-                    return create_point(x_pos, 5);
-                case DIN_FONT:
-                    return create_point(x_pos, 6);
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 4);
-                case LECO_FONT:
-                    return create_point(x_pos, 5);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 6);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-#endif
-
-static GPoint get_speed_positions(int mode, int font, int width, int height) {
-    // wind speed
-    int x_pos = PBL_IF_ROUND_ELSE(56, 6);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(x_pos, 3);
-                case LECO_FONT:
-                    return create_point(x_pos, 5);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 9);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_direction_positions(int mode, int font, int width, int height) {
-    // wind direction
-    int x_pos = PBL_IF_ROUND_ELSE(56, 4);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case BLOCKO_BIG_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 3);
-                case LECO_FONT:
-                    return create_point(x_pos, 5);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 5);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_wind_unit_positions(int mode, int font, int width, int height) {
-    // wind unit
-    int x_pos = PBL_IF_ROUND_ELSE(100, 48);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                    return create_point(x_pos, 1);
-                case BLOCKO_BIG_FONT:
-                    return create_point(x_pos, 3);
-                case SYSTEM_FONT:
-                    return create_point(x_pos, 3);
-                case ARCHIVO_FONT:
-                    return create_point(x_pos, 2);
-                case DIN_FONT:
-                    return create_point(x_pos, 3);
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 1);
-                case LECO_FONT:
-                    return create_point(x_pos, 1);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 2);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_sunrise_positions(int mode, int font, int width, int height) {
-    // sunrise
-    int x_pos = PBL_IF_ROUND_ELSE(86, 22);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(x_pos, 3);
-                case LECO_FONT:
-                    return create_point(x_pos, 5);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 9);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_sunrise_icon_positions(int mode, int font, int width, int height) {
-    // sunrise icon
-    int x_pos = PBL_IF_ROUND_ELSE(60, 0);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                    return create_point(x_pos, 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(x_pos, 4);
-                case SYSTEM_FONT:
-                    return create_point(x_pos, 4);
-                case ARCHIVO_FONT:
-                    return create_point(x_pos, 4);
-                case DIN_FONT:
-                    return create_point(x_pos, 5);
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 3);
-                case LECO_FONT:
-                    return create_point(x_pos, 4);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 5);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_sunset_positions(int mode, int font, int width, int height) {
-    // sunset
-    int x_pos = PBL_IF_ROUND_ELSE(-86, -24);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(x_pos, 3);
-                case LECO_FONT:
-                    return create_point(x_pos, 5);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 9);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_sunset_icon_positions(int mode, int font, int width, int height) {
-    // sunset icon
-    int x_pos = PBL_IF_ROUND_ELSE(-60, -4);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                    return create_point(x_pos, 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(x_pos, 4);
-                case SYSTEM_FONT:
-                    return create_point(x_pos, 4);
-                case ARCHIVO_FONT:
-                    return create_point(x_pos, 4);
-                case DIN_FONT:
-                    return create_point(x_pos, 5);
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 3);
-                case LECO_FONT:
-                    return create_point(x_pos, 4);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 5);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_degrees_positions(int mode, int font, int width, int height) {
-    // compass degrees
-    int x_pos = PBL_IF_ROUND_ELSE(82, 30);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(x_pos, 3);
-                case LECO_FONT:
-                    return create_point(x_pos, 5);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 9);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_compass_positions(int mode, int font, int width, int height) {
-    // compass arrow
-    int x_pos = PBL_IF_ROUND_ELSE(60, 8);
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case BLOCKO_BIG_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(x_pos, 3);
-                case LECO_FONT:
-                    return create_point(x_pos, 5);
-                case KONSTRUCT_FONT:
-                    return create_point(x_pos, 5);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_text_only_positions(int mode, int font, int width, int height) {
-    // text-only modules
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                case SYSTEM_FONT:
-                case ARCHIVO_FONT:
-                case DIN_FONT:
-                case PROTOTYPE_FONT:
-                    return create_point(0, 3);
-                case BLOCKO_BIG_FONT:
-                    return create_point(0, 3);
-                case LECO_FONT:
-                    return create_point(0, 5);
-                case KONSTRUCT_FONT:
-                    return create_point(0, 9);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
-    return create_point(0, 0);
-};
-
-static GPoint get_slot_e_positions(int mode, int font, int width, int height) {
+    const struct FontPositions *font = &font_positions[get_font_index(selected_font)];
     int midpoint = height / 2;
-    // position for slot e
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                    return create_point(2, midpoint - 48);
-                case BLOCKO_BIG_FONT:
-                    return create_point(2, midpoint - 55);
-                case SYSTEM_FONT:
-                    return create_point(2, midpoint - 53);
-                case ARCHIVO_FONT:
-                    return create_point(2, midpoint - 51);
-                case DIN_FONT:
-                    return create_point(2, midpoint - 55);
-                case PROTOTYPE_FONT:
-                    return create_point(2, midpoint - 51);
-                case LECO_FONT:
-                    return create_point(2, midpoint - 48);
-                case KONSTRUCT_FONT:
-                    return create_point(2, midpoint - 41);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
 
-    return create_point(0, 0);
-};
+    positions->hours = create_point(PBL_IF_ROUND_ELSE(0, 2), midpoint + font->hours_y);
+    positions->date = create_point(PBL_IF_ROUND_ELSE(0, 2), midpoint + font->date_y);
+
+    #if defined PBL_ROUND
+    positions->bluetooth = create_point(134, midpoint + font->icons_y);
+    positions->quiettime = create_point(7, midpoint + font->icons_y);
+    positions->updates = create_point(120, midpoint + font->icons_y);
+    #else
+    int align = get_alignment_index(alignment);
+    bool centered = alignment == GTextAlignmentCenter;
+    positions->bluetooth = create_point(font->bluetooth_x[align],
+            midpoint + (centered ? font->icons_y : font->bluetooth_y));
+    positions->quiettime = create_point(font->quiettime_x[align],
+            midpoint + (centered ? font->icons_y : font->quiettime_y));
+    positions->updates = create_point(font->updates_x[align],
+            midpoint + (centered ? font->icons_y : font->updates_y));
+    #endif
+}
 
-static GPoint get_slot_f_positions(int mode, int font, int width, int height) {
+static GPoint get_slot_positions(int slot, int font, int width, int height) {
     int midpoint = height / 2;
-    // position for slot f
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(font) {
-                case BLOCKO_FONT:
-                    return create_point(2, midpoint + 24);
-                case BLOCKO_BIG_FONT:
-                    return create_point(2, midpoint + 29);
-                case SYSTEM_FONT:
-                    return create_point(2, midpoint + 25);
-                case ARCHIVO_FONT:
-                    return create_point(2, midpoint + 31);
-                case DIN_FONT:
-                    return create_point(2, midpoint + 29);
-                case PROTOTYPE_FONT:
-                    return create_point(2, midpoint + 27);
-                case LECO_FONT:
-                    return create_point(2, midpoint + 26);
-                case KONSTRUCT_FONT:
-                    return create_point(2, midpoint + 19);
-            }
-            break;
-        default:
-            return create_point(0, 0);
+    switch(slot) {
+        case SLOT_A:
+            return create_point(2, 0);
+        case SLOT_B:
+            return create_point(PBL_IF_ROUND_ELSE(2, width / 2), PBL_IF_ROUND_ELSE(18, 0));
+        case SLOT_C:
+            return create_point(2, PBL_IF_ROUND_ELSE(136, height - module_height));
+        case SLOT_D:
+            return create_point(PBL_IF_ROUND_ELSE(2, width / 2), PBL_IF_ROUND_ELSE(152, height - module_height));
+        case SLOT_E:
+            return create_point(2, midpoint + slot_e_offsets[font]);
+        case SLOT_F:
+            return create_point(2, midpoint + slot_f_offsets[font]);
     }
-
-    return create_point(0, 0);
-};
-
-GPoint get_slot_positions(int mode, int slot, int width, int height, int font) {
-    switch (mode) {
-        case MODE_NORMAL:
-            switch(slot) {
-                case SLOT_A:
-                    return create_point(2, 0);
-                case SLOT_B:
-                    return create_point(PBL_IF_ROUND_ELSE(2, width / 2), PBL_IF_ROUND_ELSE(18, 0));
-                case SLOT_C:
-                    return create_point(2, PBL_IF_ROUND_ELSE(136, height - module_height));
-                case SLOT_D:
-                    return create_point(PBL_IF_ROUND_ELSE(2, width / 2), PBL_IF_ROUND_ELSE(152, height - module_height));
-                case SLOT_E:
-                    return get_slot_e_positions(mode, font, width, height);
-                case SLOT_F:
-                    return get_slot_f_positions(mode, font, width, height);
-            }
-            break;
-        default:
-            return create_point(0, 0);
-    }
-
     return create_point(0, 0);
-};
+}
 
 GPoint get_pos_for_item(int slot, int item, int mode, int font, int width, int height) {
-    if (slot == -1) {
+    if (slot == -1 || mode != MODE_NORMAL || item < 0 || item >= NUM_ITEMS) {
         return create_point(0, 0);
     }
-    GPoint slot_pos = get_slot_positions(mode, slot, width, height, font);
-    GPoint item_pos;
-    switch (item) {
-        case WEATHER_ITEM:
-            item_pos = get_weather_positions(mode, font, width, height);
-            break;
-        case TEMP_ITEM:
-            item_pos = get_temp_positions(mode, font, width, height);
-            break;
-        case TEMPMIN_ITEM:
-            item_pos = get_tempmin_positions(mode, font, width, height);
-            break;
-        case TEMPMAX_ITEM:
-            item_pos = get_tempmax_positions(mode, font, width, height);
-            break;
-        #if defined(PBL_HEALTH)
-        case STEPS_ITEM:
-        case DIST_ITEM:
-        case CAL_ITEM:
-        case SLEEP_ITEM:
-        case DEEP_ITEM:
-        case ACTIVE_ITEM:
-            item_pos = get_text_only_positions(mode, font, width, height);
-            break;
-        case HEART_ITEM:
-            item_pos = get_heart_positions(mode, font, width, height);
-            break;
-        case HEARTICON_ITEM:
-            item_pos = get_heart_icon_positions(mode, font, width, height);
-            break;
-        #endif
-        case SPEED_ITEM:
-            item_pos = get_speed_positions(mode, font, width, height);
-            break;
-        case DIRECTION_ITEM:
-            item_pos = get_direction_positions(mode, font, width, height);
-            break;
-        case WIND_UNIT_ITEM:
-            item_pos = get_wind_unit_positions(mode, font, width, height);
-            break;
-        case TEMPMINICON_ITEM:
-            item_pos = get_tempminicon_positions(mode, font, width, height);
-            break;
-        case TEMPMAXICON_ITEM:
-            item_pos = get_tempmaxicon_positions(mode, font, width, height);
-            break;
-        case SUNRISE_ITEM:
-            item_pos = get_sunrise_positions(mode, font, width, height);
-            break;
-        case SUNSET_ITEM:
-            item_pos = get_sunset_positions(mode, font, width, height);
-            break;
-        case SUNRISEICON_ITEM:
-            item_pos = get_sunrise_icon_positions(mode, font, width, height);
-            break;
-        case SUNSETICON_ITEM:
-            item_pos = get_sunset_icon_positions(mode, font, width, height);
-            break;
-        case DEGREES_ITEM:
-            item_pos = get_degrees_positions(mode, font, width, height);
-            break;
-        case COMPASS_ITEM:
-            item_pos = get_compass_positions(mode, font, width, height);
-            break;
-        case SECONDS_ITEM:
-        case BATTERY_ITEM:
-        case TIMEZONE_ITEM:
-            item_pos = get_text_only_positions(mode, font, width, height);
-            break;
-        #if !defined PBL_PLATFORM_APLITE
-        case CUSTOMTEXT_ITEM:
-        case PHONEBATTERY_ITEM:
-        case CRYPTO_ITEM:
-        case TIMEZONEB_ITEM:
-            item_pos = get_text_only_positions(mode, font, width, height);
-            break;
-        #endif
-    }
-    return create_point(slot_pos.x + item_pos.x, slot_pos.y + item_pos.y);
+    font = get_font_index(font);
+    GPoint slot_pos = get_slot_positions(slot, font, width, height);
+    const struct Offset *item_pos = &item_offsets[item][font];
+    return create_point(slot_pos.x + item_pos->x, slot_pos.y + item_pos->y);
 }
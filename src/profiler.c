@@ -0,0 +1,133 @@
+#include <pebble.h>
+#include "profiler.h"
+#include "fontcache.h"
+
+#if defined TIMEBOXED_PROFILE
+
+struct ProfileSection {
+    uint32_t calls;
+    uint32_t total_ms;
+    uint32_t max_ms;
+    uint32_t allocs;
+    int32_t heap_delta;
+    uint32_t started_at;
+    int32_t heap_at_start;
+};
+
+static char* section_names[PROFILE_SECTIONS] = {
+    "tick",
+    "inbox",
+    "load",
+    "redraw",
+    "battery",
+    "bluetooth",
+    "accel",
+    "health",
+    "draw",
+    "hours",
+};
+
+static char* counter_names[PROFILE_COUNTERS] = {
+    "outbox sends",
+    "module lookups",
+    "text updates applied",
+    "text updates skipped",
+    "accel samples",
+    "accel samples skipped as quiet",
+    "taps detected",
+    "health api calls",
+    "outbox requests coalesced",
+    "outbox retries",
+    "rects redrawn",
+    "pixels redrawn",
+    "font loads",
+};
+
+static struct ProfileSection sections[PROFILE_SECTIONS];
+static int32_t counters[PROFILE_COUNTERS];
+static uint16_t open_sections;
+static size_t heap_peak;
+static time_t reset_at;
+
+static uint32_t now_ms() {
+    time_t seconds;
+    uint16_t millis;
+    time_ms(&seconds, &millis);
+    return (uint32_t)seconds * 1000 + millis;
+}
+
+void profile_begin(uint8_t section) {
+    struct ProfileSection *current = &sections[section];
+    current->calls++;
+    current->started_at = now_ms();
+    current->heap_at_start = (int32_t)heap_bytes_used();
+    open_sections |= 1 << section;
+}
+
+void profile_end(uint8_t section) {
+    struct ProfileSection *current = &sections[section];
+    uint32_t elapsed = now_ms() - current->started_at;
+    size_t heap_used = heap_bytes_used();
+
+    current->total_ms += elapsed;
+    if (elapsed > current->max_ms) {
+        current->max_ms = elapsed;
+    }
+    current->heap_delta += (int32_t)heap_used - current->heap_at_start;
+    if (heap_used > heap_peak) {
+        heap_peak = heap_used;
+    }
+    open_sections &= ~(1 << section);
+}
+
+void profile_alloc(uint16_t count) {
+    // allocations are attributed to every section that is currently open
+    for (int i = 0; i < PROFILE_SECTIONS; ++i) {
+        if (open_sections & (1 << i)) {
+            sections[i].allocs += count;
+        }
+    }
+}
+
+void profile_count(uint8_t counter, int32_t amount) {
+    counters[counter] += amount;
+}
+
+void profile_reset() {
+    memset(sections, 0, sizeof(sections));
+    memset(counters, 0, sizeof(counters));
+    open_sections = 0;
+    heap_peak = heap_bytes_used();
+    reset_at = time(NULL);
+}
+
+void profile_dump() {
+    APP_LOG(APP_LOG_LEVEL_INFO, "profile: section calls total_ms max_ms allocs heap_delta");
+    for (int i = 0; i < PROFILE_SECTIONS; ++i) {
+        struct ProfileSection *current = &sections[i];
+        APP_LOG(APP_LOG_LEVEL_INFO, "profile: %s %d %d %d %d %d", section_names[i],
+            (int)current->calls, (int)current->total_ms, (int)current->max_ms,
+            (int)current->allocs, (int)current->heap_delta);
+    }
+    for (int i = 0; i < PROFILE_COUNTERS; ++i) {
+        APP_LOG(APP_LOG_LEVEL_INFO, "profile: %s %d", counter_names[i], (int)counters[i]);
+    }
+    if (counters[COUNTER_ACCEL_SAMPLES] > 0) {
+        // accel data arrives at 25Hz, so this is the cpu cost per minute of recorded motion
+        APP_LOG(APP_LOG_LEVEL_INFO, "profile: accel %d ms per minute of data",
+            (int)(sections[PROFILE_ACCEL].total_ms * 60 * ACCEL_SAMPLING_25HZ / counters[COUNTER_ACCEL_SAMPLES]));
+    }
+    int elapsed = (int)(time(NULL) - reset_at);
+    if (elapsed > 0) {
+        APP_LOG(APP_LOG_LEVEL_INFO, "profile: health api calls %d per hour",
+            (int)(counters[COUNTER_HEALTH_CALLS] * SECONDS_PER_HOUR / elapsed));
+        APP_LOG(APP_LOG_LEVEL_INFO, "profile: redrawn %d rects %d pixels per minute",
+            (int)(counters[COUNTER_DRAW_RECTS] * SECONDS_PER_MINUTE / elapsed),
+            (int)(counters[COUNTER_DRAW_PIXELS] * SECONDS_PER_MINUTE / elapsed));
+    }
+    APP_LOG(APP_LOG_LEVEL_INFO, "profile: heap used %d peak %d free %d",
+        (int)heap_bytes_used(), (int)heap_peak, (int)heap_bytes_free());
+    APP_LOG(APP_LOG_LEVEL_INFO, "profile: fonts resident %d bytes", (int)get_resident_font_bytes());
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef __TIMEBOXED_PROFILER_
+#define __TIMEBOXED_PROFILER_
+
+#include <pebble.h>
+
+#define PROFILE_TICK 0
+#define PROFILE_INBOX 1
+#define PROFILE_LOAD 2
+#define PROFILE_REDRAW 3
+#define PROFILE_BATTERY 4
+#define PROFILE_BLUETOOTH 5
+#define PROFILE_ACCEL 6
+#define PROFILE_HEALTH 7
+#define PROFILE_DRAW 8
+#define PROFILE_HOURS 9
+#define PROFILE_SECTIONS 10
+
+#define COUNTER_OUTBOX_SEND 0
+#define COUNTER_MODULE_LOOKUP 1
+#define COUNTER_TEXT_APPLIED 2
+#define COUNTER_TEXT_SKIPPED 3
+#define COUNTER_ACCEL_SAMPLES 4
+#define COUNTER_ACCEL_QUIET 5
+#define COUNTER_TAPS 6
+#define COUNTER_HEALTH_CALLS 7
+#define COUNTER_OUTBOX_COALESCED 8
+#define COUNTER_OUTBOX_RETRIES 9
+#define COUNTER_DRAW_RECTS 10
+#define COUNTER_DRAW_PIXELS 11
+#define COUNTER_FONT_LOADS 12
+#define PROFILE_COUNTERS 13
+
+#if defined TIMEBOXED_PROFILE
+void profile_begin(uint8_t section);
+void profile_end(uint8_t section);
+void profile_alloc(uint16_t count);
+void profile_count(uint8_t counter, int32_t amount);
+void profile_reset();
+void profile_dump();
+#else
+#define profile_begin(section)
+#define profile_end(section)
+#define profile_alloc(count)
+#define profile_count(counter, amount)
+#define profile_reset()
+#define profile_dump()
+#endif
+
+#endif
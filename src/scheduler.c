@@ -0,0 +1,117 @@
+#include <pebble.h>
+#include "scheduler.h"
+#include "keys.h"
+#include "outbox.h"
+
+// while the user sleeps phone requests are throttled to one every 90 minutes
+// and health data is only refreshed once an hour
+#define SLEEP_REQUEST_INTERVAL (90 * SECONDS_PER_MINUTE)
+#define SLEEP_HEALTH_INTERVAL SECONDS_PER_HOUR
+
+struct Task {
+    bool enabled;
+    bool forced;
+    uint32_t request_key;
+    int interval;
+    int sleep_interval;
+    int last_run;
+    TaskHandler handler;
+};
+
+static struct Task tasks[NUM_TASKS];
+static int next_due;
+static bool was_sleeping;
+
+void init_scheduler() {
+    memset(tasks, 0, sizeof(tasks));
+    tasks[TASK_WEATHER].request_key = KEY_REQUESTWEATHER;
+    tasks[TASK_PHONEBATTERY].request_key = KEY_REQUESTPHONEBATTERY;
+    tasks[TASK_CRYPTO].request_key = KEY_REQUESTCRYPTO;
+    tasks[TASK_UPDATES].request_key = KEY_HASUPDATE;
+
+    tasks[TASK_WEATHER].sleep_interval = SLEEP_REQUEST_INTERVAL;
+    tasks[TASK_PHONEBATTERY].sleep_interval = SLEEP_REQUEST_INTERVAL;
+    tasks[TASK_CRYPTO].sleep_interval = SLEEP_REQUEST_INTERVAL;
+    tasks[TASK_HEALTH].sleep_interval = SLEEP_HEALTH_INTERVAL;
+    next_due = 0;
+}
+
+static int get_task_due(struct Task *task, bool sleeping) {
+    if (task->forced || task->last_run == 0) {
+        return 0;
+    }
+    int interval = task->interval;
+    if (sleeping && task->sleep_interval > interval) {
+        interval = task->sleep_interval;
+    }
+    return task->last_run + interval;
+}
+
+static void update_next_due(bool sleeping) {
+    next_due = INT32_MAX;
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        if (tasks[i].enabled) {
+            int due = get_task_due(&tasks[i], sleeping);
+            if (due < next_due) {
+                next_due = due;
+            }
+        }
+    }
+    was_sleeping = sleeping;
+}
+
+static void complete_task(struct Task *task, int current_time) {
+    task->forced = false;
+    task->last_run = current_time;
+}
+
+void set_task(uint8_t task, bool enabled, int interval) {
+    tasks[task].enabled = enabled;
+    tasks[task].interval = interval;
+    next_due = 0;
+}
+
+void set_task_handler(uint8_t task, TaskHandler handler) {
+    tasks[task].handler = handler;
+}
+
+void force_task(uint8_t task) {
+    tasks[task].forced = true;
+    next_due = 0;
+}
+
+void schedule_task_at(uint8_t task, int due) {
+    tasks[task].forced = false;
+    tasks[task].last_run = due - tasks[task].interval;
+    next_due = 0;
+}
+
+void run_due_tasks(bool sleeping) {
+    int current_time = (int)time(NULL);
+    if (sleeping == was_sleeping && current_time < next_due) {
+        return;
+    }
+
+    bool due_requests = false;
+    for (int i = 0; i < NUM_TASKS; ++i) {
+        struct Task *task = &tasks[i];
+        if (!task->enabled || current_time < get_task_due(task, sleeping)) {
+            continue;
+        }
+        if (task->handler) {
+            task->handler();
+        }
+        // the outbox keeps retrying until the phone gets the request
+        if (task->request_key) {
+            outbox_request(task->request_key);
+            due_requests = true;
+        }
+        complete_task(task, current_time);
+    }
+
+    if (due_requests) {
+        outbox_flush();
+    }
+
+    update_next_due(sleeping);
+}
@@ -0,0 +1,22 @@
+#ifndef __TIMEBOXED_SCHEDULER_
+#define __TIMEBOXED_SCHEDULER_
+
+#include <pebble.h>
+
+#define TASK_WEATHER 0
+#define TASK_PHONEBATTERY 1
+#define TASK_CRYPTO 2
+#define TASK_UPDATES 3
+#define TASK_HEALTH 4
+#define NUM_TASKS 5
+
+typedef void (*TaskHandler)(void);
+
+void init_scheduler();
+void set_task(uint8_t task, bool enabled, int interval);
+void set_task_handler(uint8_t task, TaskHandler handler);
+void force_task(uint8_t task);
+void schedule_task_at(uint8_t task, int due);
+void run_due_tasks(bool sleeping);
+
+#endif
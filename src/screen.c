@@ -12,8 +12,24 @@
 #include "crypto.h"
 #include "phonebattery.h"
 #include "customtext.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "outbox.h"
+
+static void toggle_update_check(uint8_t reload_origin) {
+    set_task(TASK_UPDATES, !is_update_disabled(), SECONDS_PER_DAY);
+    if (reload_origin == RELOAD_CONFIGS || reload_origin == RELOAD_DEFAULT) {
+        // updates are checked daily at 4:00am
+        int next_check = (int)time_start_of_today() + 4 * SECONDS_PER_HOUR;
+        if (next_check <= (int)time(NULL)) {
+            next_check += SECONDS_PER_DAY;
+        }
+        schedule_task_at(TASK_UPDATES, next_check);
+    }
+}
 
 void load_screen(uint8_t reload_origin, Window *watchface) {
+    profile_begin(PROFILE_LOAD);
     load_locale();
     update_time();
 
@@ -35,16 +51,18 @@ void load_screen(uint8_t reload_origin, Window *watchface) {
     toggle_crypto(reload_origin);
     toggle_customtext(reload_origin);
     #endif
+    toggle_update_check(reload_origin);
     battery_handler(battery_state_service_peek());
     bt_handler(connection_service_peek_pebble_app_connection());
     time_t temp = time(NULL);
     struct tm *tick_time = localtime(&temp);
     update_seconds(tick_time);
     update_quiet_time_icon(true);
+    update_tick_service();
+    profile_end(PROFILE_LOAD);
 }
 
 void reload_fonts() {
-    unload_face_fonts();
     load_face_fonts();
 }
 
@@ -56,8 +74,10 @@ void recreate_text_layers(Window * watchface) {
 }
 
 void redraw_screen(Window *watchface) {
-    recreate_text_layers(watchface);
+    profile_begin(PROFILE_REDRAW);
+    layout_text_layers(watchface);
     load_screen(RELOAD_MODULE, watchface);
+    profile_end(PROFILE_REDRAW);
 }
 
 void update_quiet_time_icon(bool force) {
@@ -78,9 +98,11 @@ void update_quiet_time_icon(bool force) {
 }
 
 void bt_handler(bool connected) {
+    profile_begin(PROFILE_BLUETOOTH);
     if (connected) {
         set_bluetooth_layer_text("");
         persist_write_int(KEY_BLUETOOTHDISCONNECT, 0);
+        outbox_flush();
     } else {
         bool did_vibrate = persist_exists(KEY_BLUETOOTHDISCONNECT) ? persist_read_int(KEY_BLUETOOTHDISCONNECT): 0;
         bool should_vibrate_if_quiet = !is_mute_on_quiet_enabled() || !quiet_time_is_active();
@@ -96,9 +118,11 @@ void bt_handler(bool connected) {
         set_bluetooth_color();
         set_bluetooth_layer_text("a");
     }
+    profile_end(PROFILE_BLUETOOTH);
 }
 
 void battery_handler(BatteryChargeState charge_state) {
+    profile_begin(PROFILE_BATTERY);
     if (is_module_enabled(MODULE_BATTERY)) {
         char s_battery_buffer[8];
         int rounded_percentage = (charge_state.charge_percent / 5) * 5;
@@ -113,13 +137,7 @@ void battery_handler(BatteryChargeState charge_state) {
     } else {
         set_battery_layer_text("");
     }
-}
-
-void check_for_updates() {
-    DictionaryIterator *iter;
-    app_message_outbox_begin(&iter);
-    dict_write_uint8(iter, KEY_HASUPDATE, 1);
-    app_message_outbox_send();
+    profile_end(PROFILE_BATTERY);
 }
 
 void notify_update(int update_available) {
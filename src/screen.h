@@ -11,7 +11,6 @@ void update_quiet_time_icon(bool force);
 void bt_handler(bool connected);
 void battery_handler(BatteryChargeState battery_state);
 void update_time();
-void check_for_updates();
 void notify_update(int update_available);
 void load_timezone();
 
@@ -3,52 +3,125 @@
 #include "keys.h"
 #include "configs.h"
 #include "positions.h"
+#include "profiler.h"
+#include "digits.h"
+#include "fontcache.h"
+
+#define HOUR_TEXT_SIZE 13
+#define DATE_TEXT_SIZE 13
+#define BLUETOOTH_TEXT_SIZE 4
+#define QUIETTIME_TEXT_SIZE 4
+#define UPDATE_TEXT_SIZE 4
+#define BATTERY_TEXT_SIZE 8
+#define ALT_TIME_TEXT_SIZE 22
+#define TEMP_CUR_TEXT_SIZE 8
+#define TEMP_MAX_TEXT_SIZE 8
+#define MAX_ICON_TEXT_SIZE 4
+#define TEMP_MIN_TEXT_SIZE 8
+#define MIN_ICON_TEXT_SIZE 4
+#define WEATHER_TEXT_SIZE 4
+#define DIRECTION_TEXT_SIZE 4
+#define SPEED_TEXT_SIZE 8
+#define WIND_UNIT_TEXT_SIZE 2
+#define SUNRISE_TEXT_SIZE 8
+#define SUNRISE_ICON_TEXT_SIZE 4
+#define SUNSET_TEXT_SIZE 8
+#define SUNSET_ICON_TEXT_SIZE 4
+#define COMPASS_TEXT_SIZE 4
+#define DEGREES_TEXT_SIZE 8
+#define SECONDS_TEXT_SIZE 4
+#define ALT_TIME_B_TEXT_SIZE 22
+#define CRYPTO_TEXT_SIZE 8
+#define CRYPTO_B_TEXT_SIZE 8
+#define CRYPTO_C_TEXT_SIZE 8
+#define CRYPTO_D_TEXT_SIZE 8
+#define PHONEBATTERY_TEXT_SIZE 8
+#define CUSTOMTEXT_A_TEXT_SIZE 22
+#define CUSTOMTEXT_B_TEXT_SIZE 22
+#define STEPS_TEXT_SIZE 10
+#define CAL_TEXT_SIZE 10
+#define DIST_TEXT_SIZE 10
+#define SLEEP_TEXT_SIZE 10
+#define DEEP_TEXT_SIZE 10
+#define ACTIVE_TEXT_SIZE 10
+#define HEART_TEXT_SIZE 8
+#define HEART_ICON_TEXT_SIZE 4
+
+#if defined TIMEBOXED_CANVAS
+// every module fragment is an entry in this table and one layer draws them all
+#define MAX_TEXT_ITEMS 40
+#define MAX_DIRTY_RECTS 4
+#define DIRTY_PADDING 2
+
+typedef struct {
+    GRect frame;
+    GRect drawn;
+    GFont font;
+    const char *text;
+    GColor color;
+    GTextAlignment alignment;
+    bool hidden;
+} TextItem;
+
+static TextItem text_items[MAX_TEXT_ITEMS];
+static uint8_t num_text_items;
+static Layer *canvas;
+static GColor canvas_color;
+
+// the window is left transparent so the framebuffer keeps the last frame and
+// only these rects are cleared and repainted, unless a full redraw is pending
+static GRect dirty_rects[MAX_DIRTY_RECTS];
+static uint8_t num_dirty_rects;
+static bool full_redraw;
+#else
+typedef TextLayer TextItem;
+#endif
 
-static TextLayer *hours;
-static TextLayer *date;
-static TextLayer *alt_time;
-static TextLayer *battery;
-static TextLayer *bluetooth;
-static TextLayer *quiettime;
-static TextLayer *temp_cur;
-static TextLayer *temp_max;
-static TextLayer *temp_min;
+static TextItem *hours;
+static TextItem *date;
+static TextItem *alt_time;
+static TextItem *battery;
+static TextItem *bluetooth;
+static TextItem *quiettime;
+static TextItem *temp_cur;
+static TextItem *temp_max;
+static TextItem *temp_min;
 
 #if defined(PBL_HEALTH)
-static TextLayer *steps;
-static TextLayer *sleep;
-static TextLayer *dist;
-static TextLayer *cal;
-static TextLayer *deep;
-static TextLayer *active;
-static TextLayer *heart;
-static TextLayer *heart_icon;
+static TextItem *steps;
+static TextItem *sleep;
+static TextItem *dist;
+static TextItem *cal;
+static TextItem *deep;
+static TextItem *active;
+static TextItem *heart;
+static TextItem *heart_icon;
 #endif
 
-static TextLayer *weather;
-static TextLayer *max_icon;
-static TextLayer *min_icon;
-static TextLayer *update;
-static TextLayer *direction;
-static TextLayer *speed;
-static TextLayer *wind_unit;
-static TextLayer *sunrise;
-static TextLayer *sunrise_icon;
-static TextLayer *sunset;
-static TextLayer *sunset_icon;
-static TextLayer *compass;
-static TextLayer *degrees;
-static TextLayer *seconds;
+static TextItem *weather;
+static TextItem *max_icon;
+static TextItem *min_icon;
+static TextItem *update;
+static TextItem *direction;
+static TextItem *speed;
+static TextItem *wind_unit;
+static TextItem *sunrise;
+static TextItem *sunrise_icon;
+static TextItem *sunset;
+static TextItem *sunset_icon;
+static TextItem *compass;
+static TextItem *degrees;
+static TextItem *seconds;
 
 #if !defined PBL_PLATFORM_APLITE
-static TextLayer *alt_time_b;
-static TextLayer *crypto;
-static TextLayer *crypto_b;
-static TextLayer *crypto_c;
-static TextLayer *crypto_d;
-static TextLayer *phonebattery;
-static TextLayer *customtext_a;
-static TextLayer *customtext_b;
+static TextItem *alt_time_b;
+static TextItem *crypto;
+static TextItem *crypto_b;
+static TextItem *crypto_c;
+static TextItem *crypto_d;
+static TextItem *phonebattery;
+static TextItem *customtext_a;
+static TextItem *customtext_b;
 #endif
 
 static GFont time_font;
@@ -58,6 +131,16 @@ static GFont weather_font;
 static GFont weather_font_small;
 static GFont custom_font;
 
+#define FACE_TIME 0
+#define FACE_MEDIUM 1
+#define FACE_BASE 2
+#define FACE_WEATHER 3
+#define FACE_WEATHER_SMALL 4
+#define FACE_ICONS 5
+#define NUM_FACE_FONTS 6
+
+static uint32_t face_resources[NUM_FACE_FONTS];
+
 static GColor base_color;
 static GColor battery_color;
 static GColor battery_low_color;
@@ -84,55 +167,113 @@ static GColor heart_color;
 static GColor heart_color_off;
 #endif
 
-static char hour_text[13];
-static char date_text[13];
-static char bluetooth_text[4];
-static char quiettime_text[4];
-static char update_text[4];
-static char battery_text[8];
-static char alt_time_text[22];
-
-static char temp_cur_text[8];
-static char temp_max_text[8];
-static char max_icon_text[4];
-static char temp_min_text[8];
-static char min_icon_text[4];
-static char weather_text[4];
-static char direction_text[4];
-static char speed_text[8];
-static char wind_unit_text[2];
-static char sunrise_text[8];
-static char sunrise_icon_text[4];
-static char sunset_text[8];
-static char sunset_icon_text[4];
-static char compass_text[4];
-static char degrees_text[8];
-static char seconds_text[4];
+static char *hour_text;
+static char *date_text;
+static char *bluetooth_text;
+static char *quiettime_text;
+static char *update_text;
+static char *battery_text;
+static char *alt_time_text;
+
+static char *temp_cur_text;
+static char *temp_max_text;
+static char *max_icon_text;
+static char *temp_min_text;
+static char *min_icon_text;
+static char *weather_text;
+static char *direction_text;
+static char *speed_text;
+static char *wind_unit_text;
+static char *sunrise_text;
+static char *sunrise_icon_text;
+static char *sunset_text;
+static char *sunset_icon_text;
+static char *compass_text;
+static char *degrees_text;
+static char *seconds_text;
 
 #if !defined PBL_PLATFORM_APLITE
-static char alt_time_b_text[22];
-static char crypto_text[8];
-static char crypto_b_text[8];
-static char crypto_c_text[8];
-static char crypto_d_text[8];
-static char phonebattery_text[8];
-static char customtext_a_text[22];
-static char customtext_b_text[22];
+static char *alt_time_b_text;
+static char *crypto_text;
+static char *crypto_b_text;
+static char *crypto_c_text;
+static char *crypto_d_text;
+static char *phonebattery_text;
+static char *customtext_a_text;
+static char *customtext_b_text;
 #endif
 
 #if defined(PBL_HEALTH)
-static char steps_text[16];
-static char cal_text[16];
-static char dist_text[16];
-static char sleep_text[16];
-static char deep_text[16];
-static char active_text[16];
-static char heart_text[16];
-static char heart_icon_text[4];
+static char *steps_text;
+static char *cal_text;
+static char *dist_text;
+static char *sleep_text;
+static char *deep_text;
+static char *active_text;
+static char *heart_text;
+static char *heart_icon_text;
 static uint8_t heart_low;
 static uint8_t heart_high;
 #endif
 
+// every displayed string gets one slot in a single arena that is sized when
+// the layers are created, so modules that are not configured cost nothing
+struct TextSlot {
+    TextItem **item;
+    char **text;
+    uint8_t size;
+};
+
+static const struct TextSlot text_slots[] = {
+    { &hours, &hour_text, HOUR_TEXT_SIZE },
+    { &date, &date_text, DATE_TEXT_SIZE },
+    { &bluetooth, &bluetooth_text, BLUETOOTH_TEXT_SIZE },
+    { &quiettime, &quiettime_text, QUIETTIME_TEXT_SIZE },
+    { &update, &update_text, UPDATE_TEXT_SIZE },
+    { &battery, &battery_text, BATTERY_TEXT_SIZE },
+    { &alt_time, &alt_time_text, ALT_TIME_TEXT_SIZE },
+    { &temp_cur, &temp_cur_text, TEMP_CUR_TEXT_SIZE },
+    { &temp_max, &temp_max_text, TEMP_MAX_TEXT_SIZE },
+    { &max_icon, &max_icon_text, MAX_ICON_TEXT_SIZE },
+    { &temp_min, &temp_min_text, TEMP_MIN_TEXT_SIZE },
+    { &min_icon, &min_icon_text, MIN_ICON_TEXT_SIZE },
+    { &weather, &weather_text, WEATHER_TEXT_SIZE },
+    { &direction, &direction_text, DIRECTION_TEXT_SIZE },
+    { &speed, &speed_text, SPEED_TEXT_SIZE },
+    { &wind_unit, &wind_unit_text, WIND_UNIT_TEXT_SIZE },
+    { &sunrise, &sunrise_text, SUNRISE_TEXT_SIZE },
+    { &sunrise_icon, &sunrise_icon_text, SUNRISE_ICON_TEXT_SIZE },
+    { &sunset, &sunset_text, SUNSET_TEXT_SIZE },
+    { &sunset_icon, &sunset_icon_text, SUNSET_ICON_TEXT_SIZE },
+    { &compass, &compass_text, COMPASS_TEXT_SIZE },
+    { &degrees, &degrees_text, DEGREES_TEXT_SIZE },
+    { &seconds, &seconds_text, SECONDS_TEXT_SIZE },
+    #if !defined PBL_PLATFORM_APLITE
+    { &alt_time_b, &alt_time_b_text, ALT_TIME_B_TEXT_SIZE },
+    { &crypto, &crypto_text, CRYPTO_TEXT_SIZE },
+    { &crypto_b, &crypto_b_text, CRYPTO_B_TEXT_SIZE },
+    { &crypto_c, &crypto_c_text, CRYPTO_C_TEXT_SIZE },
+    { &crypto_d, &crypto_d_text, CRYPTO_D_TEXT_SIZE },
+    { &phonebattery, &phonebattery_text, PHONEBATTERY_TEXT_SIZE },
+    { &customtext_a, &customtext_a_text, CUSTOMTEXT_A_TEXT_SIZE },
+    { &customtext_b, &customtext_b_text, CUSTOMTEXT_B_TEXT_SIZE },
+    #endif
+    #if defined(PBL_HEALTH)
+    { &steps, &steps_text, STEPS_TEXT_SIZE },
+    { &cal, &cal_text, CAL_TEXT_SIZE },
+    { &dist, &dist_text, DIST_TEXT_SIZE },
+    { &sleep, &sleep_text, SLEEP_TEXT_SIZE },
+    { &deep, &deep_text, DEEP_TEXT_SIZE },
+    { &active, &active_text, ACTIVE_TEXT_SIZE },
+    { &heart, &heart_text, HEART_TEXT_SIZE },
+    { &heart_icon, &heart_icon_text, HEART_ICON_TEXT_SIZE },
+    #endif
+};
+
+#define NUM_TEXT_SLOTS (sizeof(text_slots) / sizeof(text_slots[0]))
+
+static char *text_arena;
+
 static uint8_t loaded_font;
 static bool enable_advanced;
 
@@ -148,44 +289,310 @@ uint8_t get_loaded_font() {
     return loaded_font;
 }
 
-static void add_text_layer(Layer * window, TextLayer * text) {
+#if defined TIMEBOXED_CANVAS
+static void mark_canvas_dirty() {
+    full_redraw = true;
+    num_dirty_rects = 0;
+    if (canvas) {
+        layer_mark_dirty(canvas);
+    }
+}
+
+static bool rects_touch(GRect a, GRect b) {
+    return a.origin.x <= b.origin.x + b.size.w && b.origin.x <= a.origin.x + a.size.w &&
+        a.origin.y <= b.origin.y + b.size.h && b.origin.y <= a.origin.y + a.size.h;
+}
+
+static GRect union_rects(GRect a, GRect b) {
+    int16_t x = a.origin.x < b.origin.x ? a.origin.x : b.origin.x;
+    int16_t y = a.origin.y < b.origin.y ? a.origin.y : b.origin.y;
+    int16_t right = a.origin.x + a.size.w > b.origin.x + b.size.w ? a.origin.x + a.size.w : b.origin.x + b.size.w;
+    int16_t bottom = a.origin.y + a.size.h > b.origin.y + b.size.h ? a.origin.y + a.size.h : b.origin.y + b.size.h;
+    return GRect(x, y, right - x, bottom - y);
+}
+
+static void add_dirty_rect(GRect rect) {
+    if (full_redraw || rect.size.w <= 0 || rect.size.h <= 0) {
+        return;
+    }
+    // rects that touch are merged so overlapping changes are repainted once
+    for (int i = 0; i < num_dirty_rects; ++i) {
+        if (rects_touch(dirty_rects[i], rect)) {
+            rect = union_rects(dirty_rects[i], rect);
+            dirty_rects[i--] = dirty_rects[--num_dirty_rects];
+        }
+    }
+    if (num_dirty_rects == MAX_DIRTY_RECTS) {
+        rect = union_rects(rect, dirty_rects[--num_dirty_rects]);
+    }
+    dirty_rects[num_dirty_rects++] = rect;
+    if (canvas) {
+        layer_mark_dirty(canvas);
+    }
+}
+
+static bool is_text_visible(TextItem * text) {
+    return !text->hidden && text->font && text->text && text->text[0];
+}
+
+static GRect get_text_box(TextItem * text) {
+    if (!is_text_visible(text)) {
+        return GRectZero;
+    }
+    GSize size = GSizeZero;
+    #if defined TIMEBOXED_DIGIT_ATLAS
+    bool digits = text == hours && get_digits_size(text->font, text->text, &size);
+    #else
+    bool digits = false;
+    #endif
+    if (!digits) {
+        size = graphics_text_layout_get_content_size(text->text, text->font, text->frame,
+                GTextOverflowModeWordWrap, text->alignment);
+    }
+    int16_t x = text->frame.origin.x;
+    if (text->alignment == GTextAlignmentCenter) {
+        x += (text->frame.size.w - size.w) / 2;
+    } else if (text->alignment == GTextAlignmentRight) {
+        x += text->frame.size.w - size.w;
+    }
+    return GRect(x - DIRTY_PADDING, text->frame.origin.y - DIRTY_PADDING,
+            size.w + 2 * DIRTY_PADDING, size.h + 2 * DIRTY_PADDING);
+}
+
+static void mark_text_dirty(TextItem * text) {
+    add_dirty_rect(text->drawn);
+    add_dirty_rect(get_text_box(text));
+}
+
+static bool is_in_dirty_rect(GRect box) {
+    for (int i = 0; i < num_dirty_rects; ++i) {
+        if (rects_touch(dirty_rects[i], box)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void draw_text_item(GContext *ctx, TextItem * text) {
+    #if defined TIMEBOXED_DIGIT_ATLAS
+    if (text == hours && draw_digits(ctx, text->font, text->text, text->frame, text->alignment, text->color)) {
+        return;
+    }
+    #endif
+    graphics_context_set_text_color(ctx, text->color);
+    graphics_draw_text(ctx, text->text, text->font, text->frame,
+            GTextOverflowModeWordWrap, text->alignment, NULL);
+}
+
+static void draw_text_items(Layer *layer, GContext *ctx) {
+    profile_begin(PROFILE_DRAW);
+    // a redraw we did not ask for, like the first frame, repaints everything
+    if (full_redraw || num_dirty_rects == 0) {
+        dirty_rects[0] = layer_get_bounds(layer);
+        num_dirty_rects = 1;
+
+        #if defined TIMEBOXED_DIGIT_ATLAS
+        // the atlas scribbles on the frame buffer, which only a full repaint hides
+        if (hours && hours->font && needs_digit_atlas(hours->font)) {
+            profile_begin(PROFILE_HOURS);
+            build_digit_atlas(ctx, hours->font, dirty_rects[0]);
+            profile_end(PROFILE_HOURS);
+        }
+        #endif
+    }
+
+    graphics_context_set_fill_color(ctx, canvas_color);
+    for (int i = 0; i < num_dirty_rects; ++i) {
+        graphics_fill_rect(ctx, dirty_rects[i], 0, GCornerNone);
+        profile_count(COUNTER_DRAW_RECTS, 1);
+        profile_count(COUNTER_DRAW_PIXELS, dirty_rects[i].size.w * dirty_rects[i].size.h);
+    }
+
+    for (int i = 0; i < num_text_items; ++i) {
+        TextItem *text = &text_items[i];
+        GRect box = get_text_box(text);
+        if (!is_text_visible(text) || !is_in_dirty_rect(box)) {
+            continue;
+        }
+        if (text == hours) {
+            profile_begin(PROFILE_HOURS);
+            draw_text_item(ctx, text);
+            profile_end(PROFILE_HOURS);
+        } else {
+            draw_text_item(ctx, text);
+        }
+        text->drawn = box;
+    }
+
+    num_dirty_rects = 0;
+    full_redraw = false;
+    profile_end(PROFILE_DRAW);
+}
+
+static TextItem* create_text_layer() {
+    if (num_text_items == MAX_TEXT_ITEMS) {
+        return NULL;
+    }
+    TextItem *text = &text_items[num_text_items++];
+    memset(text, 0, sizeof(TextItem));
+    text->color = GColorBlack;
+    return text;
+}
+
+// items live in the static table and are drawn by the canvas, so there is
+// nothing to attach or free per item
+static void add_text_layer(Layer * window, TextItem * text) {
+}
+
+static void delete_text_layer(TextItem * text) {
+}
+
+static void set_text_font(TextItem * text, GFont font) {
+    if (text) {
+        text->font = font;
+        mark_canvas_dirty();
+    }
+}
+
+static void set_text_color(TextItem * text, GColor color) {
+    if (text && !gcolor_equal(text->color, color)) {
+        text->color = color;
+        mark_text_dirty(text);
+    }
+}
+
+static const char* get_item_text(TextItem * text) {
+    return text->text;
+}
+
+static void set_item_text(TextItem * text, const char * buffer) {
+    text->text = buffer;
+    mark_text_dirty(text);
+}
+
+static void place_text_layer(TextItem * text, GRect frame, GTextAlignment alignment) {
+    if (text && (text->hidden || text->alignment != alignment || !grect_equal(&text->frame, &frame))) {
+        text->frame = frame;
+        text->alignment = alignment;
+        text->hidden = false;
+        mark_canvas_dirty();
+    }
+}
+
+static void hide_text_layer(TextItem * text) {
+    if (text && !text->hidden) {
+        text->hidden = true;
+        mark_canvas_dirty();
+    }
+}
+#else
+static void add_text_layer(Layer * window, TextItem * text) {
     if (text) {
         layer_add_child(window, text_layer_get_layer(text));
+        profile_alloc(1);
     }
 }
 
-static void delete_text_layer(TextLayer * text) {
+static void delete_text_layer(TextItem * text) {
     if (text) {
         text_layer_destroy(text);
     }
 }
 
-static void set_text_font(TextLayer * text, GFont font) {
+static void set_text_font(TextItem * text, GFont font) {
     if (text) {
         text_layer_set_font(text, font);
     }
 }
 
-static void set_text_color(TextLayer * text, GColor color) {
+static void set_text_color(TextItem * text, GColor color) {
     if (text) {
         text_layer_set_text_color(text, color);
     }
 }
 
-static void set_text(TextLayer * text, char * content) {
+static const char* get_item_text(TextItem * text) {
+    return text_layer_get_text(text);
+}
+
+static void set_item_text(TextItem * text, const char * buffer) {
+    text_layer_set_text(text, buffer);
+}
+
+static TextItem* create_text_layer() {
+    TextLayer *text = text_layer_create(GRectZero);
+    text_layer_set_background_color(text, GColorClear);
+    return text;
+}
+
+static void place_text_layer(TextItem * text, GRect frame, GTextAlignment alignment) {
     if (text) {
-        text_layer_set_text(text, content);
+        Layer *layer = text_layer_get_layer(text);
+        layer_set_frame(layer, frame);
+        text_layer_set_text_alignment(text, alignment);
+        layer_set_hidden(layer, false);
     }
 }
 
-void create_text_layers(Window* window) {
+static void hide_text_layer(TextItem * text) {
+    if (text) {
+        layer_set_hidden(text_layer_get_layer(text), true);
+    }
+}
+#endif
+
+static void set_layer_text(TextItem * text, char * buffer, size_t size, const char * content, bool uppercase) {
+    // modules without a layer have no slot in the arena
+    if (!buffer) {
+        profile_count(COUNTER_TEXT_SKIPPED, 1);
+        return;
+    }
+
+    bool changed = false;
+    size_t i = 0;
+    for (; i < size - 1 && content[i]; ++i) {
+        char c = uppercase ? to_upper_case((unsigned char)content[i]) : content[i];
+        if (buffer[i] != c) {
+            buffer[i] = c;
+            changed = true;
+        }
+    }
+    if (buffer[i]) {
+        buffer[i] = '\0';
+        changed = true;
+    }
+
+    // only mark the layer dirty when the rendered string actually differs
+    if (text && (changed || get_item_text(text) != buffer)) {
+        set_item_text(text, buffer);
+        profile_count(COUNTER_TEXT_APPLIED, 1);
+    } else {
+        profile_count(COUNTER_TEXT_SKIPPED, 1);
+    }
+}
+
+static TextItem* create_module_layer(int module) {
+    return is_module_configured(module) ? create_text_layer() : NULL;
+}
+
+static GTextAlignment get_slot_alignment(int slot, GTextAlignment text_align) {
+    return PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
+            is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight));
+}
+
+static int get_visible_slot(int module) {
+    int slot = get_slot_for_module(module);
+    return slot != -1 && is_module_enabled(module) ? slot : -1;
+}
+
+void layout_text_layers(Window* window) {
     Layer *window_layer = window_get_root_layer(window);
     GRect full_bounds = layer_get_bounds(window_layer);
     GRect bounds = layer_get_unobstructed_bounds(window_layer);
 
-    int selected_font = persist_exists(KEY_FONTTYPE) ? persist_read_int(KEY_FONTTYPE) : LECO_FONT;
+    int selected_font = get_font_type();
 
-    int alignment = PBL_IF_ROUND_ELSE(ALIGN_CENTER, persist_exists(KEY_TEXTALIGN) ? persist_read_int(KEY_TEXTALIGN) : ALIGN_RIGHT);
+    int alignment = PBL_IF_ROUND_ELSE(ALIGN_CENTER, get_text_align());
     int mode = is_simple_mode_enabled() ? MODE_SIMPLE : MODE_NORMAL;
 
     int width = bounds.size.w - 4;
@@ -210,6 +617,7 @@ void create_text_layers(Window* window) {
             text_align = GTextAlignmentRight;
             break;
     }
+    GTextAlignment icon_align = text_align == GTextAlignmentLeft ? GTextAlignmentRight : GTextAlignmentLeft;
 
     GPoint pos;
     int slot;
@@ -219,301 +627,385 @@ void create_text_layers(Window* window) {
 
     int slot_width = is_simple_mode_enabled() ? width : width/2;
 
-    hours = text_layer_create(GRect(text_positions.hours.x, text_positions.hours.y, width, 100));
-    text_layer_set_background_color(hours, GColorClear);
-    text_layer_set_text_alignment(hours, text_align);
-
-    date = text_layer_create(GRect(text_positions.date.x, text_positions.date.y, width, 50));
-    text_layer_set_background_color(date, GColorClear);
-    text_layer_set_text_alignment(date, text_align);
+    place_text_layer(hours, GRect(text_positions.hours.x, text_positions.hours.y, width, 100), text_align);
+    place_text_layer(date, GRect(text_positions.date.x, text_positions.date.y, width, 50), text_align);
 
-    slot = get_slot_for_module(MODULE_TIMEZONE);
+    slot = get_visible_slot(MODULE_TIMEZONE);
     if (slot != -1) {
         pos = get_pos_for_item(slot, TIMEZONE_ITEM, mode, selected_font, width, height);
-        alt_time = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(alt_time, GColorClear);
-        text_layer_set_text_alignment(alt_time, text_align);
-        text_layer_set_text_alignment(alt_time, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(alt_time, GRect(pos.x, pos.y, width, 50), get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(alt_time);
     }
 
     #if !defined PBL_PLATFORM_APLITE
-    slot = get_slot_for_module(MODULE_TIMEZONEB);
+    slot = get_visible_slot(MODULE_TIMEZONEB);
     if (slot != -1) {
         pos = get_pos_for_item(slot, TIMEZONEB_ITEM, mode, selected_font, width, height);
-        alt_time_b = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(alt_time_b, GColorClear);
-        text_layer_set_text_alignment(alt_time_b, text_align);
-        text_layer_set_text_alignment(alt_time_b, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(alt_time_b, GRect(pos.x, pos.y, width, 50), get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(alt_time_b);
     }
     #endif
 
-    slot = get_slot_for_module(MODULE_BATTERY);
+    slot = get_visible_slot(MODULE_BATTERY);
     if (slot != -1) {
         pos = get_pos_for_item(slot, BATTERY_ITEM, mode, selected_font, width, height);
-        battery = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(battery, GColorClear);
-        text_layer_set_text_alignment(battery, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(battery, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(battery);
     }
 
-    quiettime = text_layer_create(GRect(text_positions.quiettime.x, text_positions.quiettime.y, width, 50));
-    text_layer_set_background_color(quiettime, GColorClear);
-    text_layer_set_text_alignment(quiettime, text_align == GTextAlignmentLeft ? GTextAlignmentRight : GTextAlignmentLeft);
-    layer_set_hidden(text_layer_get_layer(quiettime), height != full_height);
-
-    bluetooth = text_layer_create(GRect(text_positions.bluetooth.x, text_positions.bluetooth.y, width, 50));
-    text_layer_set_background_color(bluetooth, GColorClear);
-    text_layer_set_text_alignment(bluetooth, text_align == GTextAlignmentLeft ? GTextAlignmentRight : GTextAlignmentLeft);
-    layer_set_hidden(text_layer_get_layer(bluetooth), height != full_height);
-
-    update = text_layer_create(GRect(text_positions.updates.x, text_positions.updates.y, width, 50));
-    text_layer_set_background_color(update, GColorClear);
-    text_layer_set_text_alignment(update, text_align == GTextAlignmentLeft ? GTextAlignmentRight : GTextAlignmentLeft);
-    layer_set_hidden(text_layer_get_layer(update), height != full_height);
-
+    place_text_layer(quiettime, GRect(text_positions.quiettime.x, text_positions.quiettime.y, width, 50), icon_align);
+    place_text_layer(bluetooth, GRect(text_positions.bluetooth.x, text_positions.bluetooth.y, width, 50), icon_align);
+    place_text_layer(update, GRect(text_positions.updates.x, text_positions.updates.y, width, 50), icon_align);
+    if (height != full_height) {
+        hide_text_layer(quiettime);
+        hide_text_layer(bluetooth);
+        hide_text_layer(update);
+    }
 
-    slot = get_slot_for_module(MODULE_WEATHER);
+    slot = get_visible_slot(MODULE_WEATHER);
     if (slot != -1) {
         pos = get_pos_for_item(slot, WEATHER_ITEM, mode, selected_font, width, height);
-        weather = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, 40), 50));
-        text_layer_set_background_color(weather, GColorClear);
-        text_layer_set_text_alignment(weather, GTextAlignmentCenter);
+        place_text_layer(weather, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, 40), 50), GTextAlignmentCenter);
 
         pos = get_pos_for_item(slot, TEMP_ITEM, mode, selected_font, width, height);
-        temp_cur = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(temp_cur, GColorClear);
-        text_layer_set_text_alignment(temp_cur, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
+        place_text_layer(temp_cur, GRect(pos.x, pos.y, width, 50), PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
+    } else {
+        hide_text_layer(weather);
+        hide_text_layer(temp_cur);
     }
 
-    slot = get_slot_for_module(MODULE_FORECAST);
+    slot = get_visible_slot(MODULE_FORECAST);
     if (slot != -1) {
         pos = get_pos_for_item(slot, TEMPMAX_ITEM, mode, selected_font, width, height);
-        temp_max = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(temp_max, GColorClear);
-        text_layer_set_text_alignment(temp_max, GTextAlignmentLeft);
+        place_text_layer(temp_max, GRect(pos.x, pos.y, width, 50), GTextAlignmentLeft);
 
         pos = get_pos_for_item(slot, TEMPMAXICON_ITEM, mode, selected_font, width, height);
-        max_icon = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(max_icon, GColorClear);
-        text_layer_set_text_alignment(max_icon, GTextAlignmentLeft);
+        place_text_layer(max_icon, GRect(pos.x, pos.y, width, 50), GTextAlignmentLeft);
 
         pos = get_pos_for_item(slot, TEMPMIN_ITEM, mode, selected_font, width, height);
-        temp_min = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(temp_min, GColorClear);
-        text_layer_set_text_alignment(temp_min, GTextAlignmentLeft);
+        place_text_layer(temp_min, GRect(pos.x, pos.y, width, 50), GTextAlignmentLeft);
 
         pos = get_pos_for_item(slot, TEMPMINICON_ITEM, mode, selected_font, width, height);
-        min_icon = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(min_icon, GColorClear);
-        text_layer_set_text_alignment(min_icon, GTextAlignmentLeft);
+        place_text_layer(min_icon, GRect(pos.x, pos.y, width, 50), GTextAlignmentLeft);
+    } else {
+        hide_text_layer(temp_max);
+        hide_text_layer(max_icon);
+        hide_text_layer(temp_min);
+        hide_text_layer(min_icon);
     }
 
-    slot = get_slot_for_module(MODULE_WIND);
+    slot = get_visible_slot(MODULE_WIND);
     if (slot != -1) {
         pos = get_pos_for_item(slot, SPEED_ITEM, mode, selected_font, width, height);
-        speed = text_layer_create(GRect(pos.x, pos.y, 42, 50));
-        text_layer_set_background_color(speed, GColorClear);
-        text_layer_set_text_alignment(speed, GTextAlignmentRight);
+        place_text_layer(speed, GRect(pos.x, pos.y, 42, 50), GTextAlignmentRight);
 
         pos = get_pos_for_item(slot, DIRECTION_ITEM, mode, selected_font, width, height);
-        direction = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(direction, GColorClear);
-        text_layer_set_text_alignment(direction, GTextAlignmentLeft);
+        place_text_layer(direction, GRect(pos.x, pos.y, width, 50), GTextAlignmentLeft);
 
         pos = get_pos_for_item(slot, WIND_UNIT_ITEM, mode, selected_font, width, height);
-        wind_unit = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(wind_unit, GColorClear);
-        text_layer_set_text_alignment(wind_unit, GTextAlignmentLeft);
+        place_text_layer(wind_unit, GRect(pos.x, pos.y, width, 50), GTextAlignmentLeft);
+    } else {
+        hide_text_layer(speed);
+        hide_text_layer(direction);
+        hide_text_layer(wind_unit);
     }
 
-    slot = get_slot_for_module(MODULE_SUNRISE);
+    slot = get_visible_slot(MODULE_SUNRISE);
     if (slot != -1) {
         pos = get_pos_for_item(slot, SUNRISE_ITEM, mode, selected_font, width, height);
-        sunrise = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot_width), 50));
-        text_layer_set_background_color(sunrise, GColorClear);
-        text_layer_set_text_alignment(sunrise, GTextAlignmentLeft);
+        place_text_layer(sunrise, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot_width), 50), GTextAlignmentLeft);
 
         pos = get_pos_for_item(slot, SUNRISEICON_ITEM, mode, selected_font, width, height);
-        sunrise_icon = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, 34), 50));
-        text_layer_set_background_color(sunrise_icon, GColorClear);
-        text_layer_set_text_alignment(sunrise_icon, GTextAlignmentLeft);
+        place_text_layer(sunrise_icon, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, 34), 50), GTextAlignmentLeft);
+    } else {
+        hide_text_layer(sunrise);
+        hide_text_layer(sunrise_icon);
     }
 
-    slot = get_slot_for_module(MODULE_SUNSET);
+    slot = get_visible_slot(MODULE_SUNSET);
     if (slot != -1) {
         pos = get_pos_for_item(slot, SUNSET_ITEM, mode, selected_font, width, height);
-        sunset = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot_width), 50));
-        text_layer_set_background_color(sunset, GColorClear);
-        text_layer_set_text_alignment(sunset, GTextAlignmentRight);
+        place_text_layer(sunset, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot_width), 50), GTextAlignmentRight);
 
         pos = get_pos_for_item(slot, SUNSETICON_ITEM, mode, selected_font, width, height);
-        sunset_icon = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot_width), 50));
-        text_layer_set_background_color(sunset_icon, GColorClear);
-        text_layer_set_text_alignment(sunset_icon, GTextAlignmentRight);
+        place_text_layer(sunset_icon, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot_width), 50), GTextAlignmentRight);
+    } else {
+        hide_text_layer(sunset);
+        hide_text_layer(sunset_icon);
     }
 
-    slot = get_slot_for_module(MODULE_COMPASS);
+    slot = get_visible_slot(MODULE_COMPASS);
     if (slot != -1) {
         pos = get_pos_for_item(slot, DEGREES_ITEM, mode, selected_font, width, height);
-        degrees = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(degrees, GColorClear);
-        text_layer_set_text_alignment(degrees, GTextAlignmentLeft);
+        place_text_layer(degrees, GRect(pos.x, pos.y, width, 50), GTextAlignmentLeft);
 
         pos = get_pos_for_item(slot, COMPASS_ITEM, mode, selected_font, width, height);
-        compass = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(compass, GColorClear);
-        text_layer_set_text_alignment(compass, GTextAlignmentLeft);
+        place_text_layer(compass, GRect(pos.x, pos.y, width, 50), GTextAlignmentLeft);
+    } else {
+        hide_text_layer(degrees);
+        hide_text_layer(compass);
     }
 
-    slot = get_slot_for_module(MODULE_SECONDS);
+    slot = get_visible_slot(MODULE_SECONDS);
     if (slot != -1) {
-
         pos = get_pos_for_item(slot, SECONDS_ITEM, mode, selected_font, width, height);
-        seconds = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(seconds, GColorClear);
-        text_layer_set_text_alignment(seconds, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(seconds, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(seconds);
     }
 
     #if !defined PBL_PLATFORM_APLITE
-    slot = get_slot_for_module(MODULE_PHONEBATTERY);
+    slot = get_visible_slot(MODULE_PHONEBATTERY);
     if (slot != -1) {
-
         pos = get_pos_for_item(slot, PHONEBATTERY_ITEM, mode, selected_font, width, height);
-        phonebattery = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(phonebattery, GColorClear);
-        text_layer_set_text_alignment(phonebattery, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
-
+        place_text_layer(phonebattery, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(phonebattery);
     }
 
-
-    slot = get_slot_for_module(MODULE_CUSTOMTEXTA);
+    slot = get_visible_slot(MODULE_CUSTOMTEXTA);
     if (slot != -1) {
         pos = get_pos_for_item(slot, CUSTOMTEXT_ITEM, mode, selected_font, width, height);
-        customtext_a = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(customtext_a, GColorClear);
-	text_layer_set_text_alignment(customtext_a, text_align);
-        text_layer_set_text_alignment(customtext_a, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(customtext_a, GRect(pos.x, pos.y, width, 50), get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(customtext_a);
     }
 
-    slot = get_slot_for_module(MODULE_CUSTOMTEXTB);
+    slot = get_visible_slot(MODULE_CUSTOMTEXTB);
     if (slot != -1) {
         pos = get_pos_for_item(slot, CUSTOMTEXT_ITEM, mode, selected_font, width, height);
-        customtext_b = text_layer_create(GRect(pos.x, pos.y, width, 50));
-        text_layer_set_background_color(customtext_b, GColorClear);
-	text_layer_set_text_alignment(customtext_b, text_align);
-        text_layer_set_text_alignment(customtext_b, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(customtext_b, GRect(pos.x, pos.y, width, 50), get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(customtext_b);
     }
 
-    slot = get_slot_for_module(MODULE_CRYPTO);
+    slot = get_visible_slot(MODULE_CRYPTO);
     if (slot != -1) {
         pos = get_pos_for_item(slot, CRYPTO_ITEM, mode, selected_font, width, height);
-        crypto = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(crypto, GColorClear);
-        text_layer_set_text_alignment(crypto, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(crypto, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(crypto);
     }
 
-    slot = get_slot_for_module(MODULE_CRYPTOB);
+    slot = get_visible_slot(MODULE_CRYPTOB);
     if (slot != -1) {
         pos = get_pos_for_item(slot, CRYPTO_ITEM, mode, selected_font, width, height);
-        crypto_b = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(crypto_b, GColorClear);
-        text_layer_set_text_alignment(crypto_b, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(crypto_b, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(crypto_b);
     }
 
-    slot = get_slot_for_module(MODULE_CRYPTOC);
+    slot = get_visible_slot(MODULE_CRYPTOC);
     if (slot != -1) {
         pos = get_pos_for_item(slot, CRYPTO_ITEM, mode, selected_font, width, height);
-        crypto_c = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(crypto_c, GColorClear);
-        text_layer_set_text_alignment(crypto_c, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(crypto_c, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(crypto_c);
     }
 
-    slot = get_slot_for_module(MODULE_CRYPTOD);
+    slot = get_visible_slot(MODULE_CRYPTOD);
     if (slot != -1) {
         pos = get_pos_for_item(slot, CRYPTO_ITEM, mode, selected_font, width, height);
-        crypto_d = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(crypto_d, GColorClear);
-        text_layer_set_text_alignment(crypto_d, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(crypto_d, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(crypto_d);
     }
     #endif
 
     #if defined(PBL_HEALTH)
-    slot = get_slot_for_module(MODULE_STEPS);
+    slot = get_visible_slot(MODULE_STEPS);
     if (slot != -1) {
         pos = get_pos_for_item(slot, STEPS_ITEM, mode, selected_font, width, height);
-        steps = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width: slot_width), 50));
-        text_layer_set_background_color(steps, GColorClear);
-        text_layer_set_text_alignment(steps, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(steps, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(steps);
     }
 
-    slot = get_slot_for_module(MODULE_DIST);
+    slot = get_visible_slot(MODULE_DIST);
     if (slot != -1) {
         pos = get_pos_for_item(slot, DIST_ITEM, mode, selected_font, width, height);
-        dist = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(dist, GColorClear);
-        text_layer_set_text_alignment(dist, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(dist, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(dist);
     }
 
-    slot = get_slot_for_module(MODULE_CAL);
+    slot = get_visible_slot(MODULE_CAL);
     if (slot != -1) {
         pos = get_pos_for_item(slot, CAL_ITEM, mode, selected_font, width, height);
-        cal = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(cal, GColorClear);
-        text_layer_set_text_alignment(cal, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(cal, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(cal);
     }
 
-    slot = get_slot_for_module(MODULE_SLEEP);
+    slot = get_visible_slot(MODULE_SLEEP);
     if (slot != -1) {
         pos = get_pos_for_item(slot, SLEEP_ITEM, mode, selected_font, width, height);
-        sleep = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(sleep, GColorClear);
-        text_layer_set_text_alignment(sleep, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(sleep, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(sleep);
     }
 
-    slot = get_slot_for_module(MODULE_DEEP);
+    slot = get_visible_slot(MODULE_DEEP);
     if (slot != -1) {
         pos = get_pos_for_item(slot, DEEP_ITEM, mode, selected_font, width, height);
-        deep = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(deep, GColorClear);
-        text_layer_set_text_alignment(deep, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(deep, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(deep);
     }
 
-    slot = get_slot_for_module(MODULE_ACTIVE);
+    slot = get_visible_slot(MODULE_ACTIVE);
     if (slot != -1) {
         pos = get_pos_for_item(slot, ACTIVE_ITEM, mode, selected_font, width, height);
-        active = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50));
-        text_layer_set_background_color(active, GColorClear);
-        text_layer_set_text_alignment(active, PBL_IF_ROUND_ELSE(GTextAlignmentCenter,
-                    is_simple_mode_enabled() || slot > 3 ? text_align : (slot % 2 == 0 ? GTextAlignmentLeft : GTextAlignmentRight)));
+        place_text_layer(active, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot > 3 ? width : slot_width), 50),
+                get_slot_alignment(slot, text_align));
+    } else {
+        hide_text_layer(active);
     }
 
-    slot = get_slot_for_module(MODULE_HEART);
+    slot = get_visible_slot(MODULE_HEART);
     if (slot != -1) {
         pos = get_pos_for_item(slot, HEART_ITEM, mode, selected_font, width, height);
-        heart = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot_width), 50));
-        text_layer_set_background_color(heart, GColorClear);
-        text_layer_set_text_alignment(heart, GTextAlignmentLeft);
+        place_text_layer(heart, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, slot_width), 50), GTextAlignmentLeft);
 
         pos = get_pos_for_item(slot, HEARTICON_ITEM, mode, selected_font, width, height);
-        heart_icon = text_layer_create(GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, 34), 50));
-        text_layer_set_background_color(heart_icon, GColorClear);
-        text_layer_set_text_alignment(heart_icon, GTextAlignmentLeft);
+        place_text_layer(heart_icon, GRect(pos.x, pos.y, PBL_IF_ROUND_ELSE(width, 34), 50), GTextAlignmentLeft);
+    } else {
+        hide_text_layer(heart);
+        hide_text_layer(heart_icon);
+    }
+    #endif
+}
+
+static void create_text_arena() {
+    size_t size = 0;
+    for (size_t i = 0; i < NUM_TEXT_SLOTS; ++i) {
+        if (*text_slots[i].item) {
+            size += text_slots[i].size;
+        }
+    }
+
+    text_arena = malloc(size);
+    profile_alloc(1);
+
+    char *next = text_arena;
+    for (size_t i = 0; i < NUM_TEXT_SLOTS; ++i) {
+        const struct TextSlot *slot = &text_slots[i];
+        if (text_arena && *slot->item) {
+            next[0] = '\0';
+            *slot->text = next;
+            next += slot->size;
+        } else {
+            *slot->text = NULL;
+        }
+    }
+}
+
+static void destroy_text_arena() {
+    for (size_t i = 0; i < NUM_TEXT_SLOTS; ++i) {
+        *text_slots[i].text = NULL;
     }
+    free(text_arena);
+    text_arena = NULL;
+}
+
+void create_text_layers(Window* window) {
+    Layer *window_layer = window_get_root_layer(window);
+
+    // layers are created for every module used in any slot state so that
+    // switching between normal, sleep, tap and wrist only needs a relayout
+    hours = create_text_layer();
+    date = create_text_layer();
+    quiettime = create_text_layer();
+    bluetooth = create_text_layer();
+    update = create_text_layer();
+
+    alt_time = create_module_layer(MODULE_TIMEZONE);
+    battery = create_module_layer(MODULE_BATTERY);
+
+    if (is_module_configured(MODULE_WEATHER)) {
+        weather = create_text_layer();
+        temp_cur = create_text_layer();
+    }
+
+    if (is_module_configured(MODULE_FORECAST)) {
+        temp_max = create_text_layer();
+        max_icon = create_text_layer();
+        temp_min = create_text_layer();
+        min_icon = create_text_layer();
+    }
+
+    if (is_module_configured(MODULE_WIND)) {
+        speed = create_text_layer();
+        direction = create_text_layer();
+        wind_unit = create_text_layer();
+    }
+
+    if (is_module_configured(MODULE_SUNRISE)) {
+        sunrise = create_text_layer();
+        sunrise_icon = create_text_layer();
+    }
+
+    if (is_module_configured(MODULE_SUNSET)) {
+        sunset = create_text_layer();
+        sunset_icon = create_text_layer();
+    }
+
+    if (is_module_configured(MODULE_COMPASS)) {
+        degrees = create_text_layer();
+        compass = create_text_layer();
+    }
+
+    seconds = create_module_layer(MODULE_SECONDS);
+
+    #if !defined PBL_PLATFORM_APLITE
+    alt_time_b = create_module_layer(MODULE_TIMEZONEB);
+    phonebattery = create_module_layer(MODULE_PHONEBATTERY);
+    customtext_a = create_module_layer(MODULE_CUSTOMTEXTA);
+    customtext_b = create_module_layer(MODULE_CUSTOMTEXTB);
+    crypto = create_module_layer(MODULE_CRYPTO);
+    crypto_b = create_module_layer(MODULE_CRYPTOB);
+    crypto_c = create_module_layer(MODULE_CRYPTOC);
+    crypto_d = create_module_layer(MODULE_CRYPTOD);
+    #endif
+
+    #if defined(PBL_HEALTH)
+    steps = create_module_layer(MODULE_STEPS);
+    dist = create_module_layer(MODULE_DIST);
+    cal = create_module_layer(MODULE_CAL);
+    sleep = create_module_layer(MODULE_SLEEP);
+    deep = create_module_layer(MODULE_DEEP);
+    active = create_module_layer(MODULE_ACTIVE);
+
+    if (is_module_configured(MODULE_HEART)) {
+        heart = create_text_layer();
+        heart_icon = create_text_layer();
+    }
+    #endif
+
+    create_text_arena();
+    layout_text_layers(window);
+
+    #if defined TIMEBOXED_CANVAS
+    full_redraw = true;
+    canvas = layer_create(layer_get_bounds(window_layer));
+    layer_set_update_proc(canvas, draw_text_items);
+    layer_add_child(window_layer, canvas);
+    profile_alloc(1);
     #endif
 
     add_text_layer(window_layer, hours);
@@ -648,10 +1140,47 @@ void destroy_text_layers() {
     delete_text_layer(heart_icon);
     heart_icon = NULL;
     #endif
+
+    #if defined TIMEBOXED_CANVAS
+    if (canvas) {
+        layer_destroy(canvas);
+        canvas = NULL;
+    }
+    num_text_items = 0;
+    #endif
+
+    destroy_text_arena();
+}
+
+static bool is_face_resource(uint32_t *resources, uint32_t resource_id) {
+    for (int i = 0; i < NUM_FACE_FONTS; ++i) {
+        if (resources[i] == resource_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static GFont get_fallback_font(int face) {
+    if (face == FACE_TIME) {
+        return fonts_get_system_font(FONT_KEY_ROBOTO_BOLD_SUBSET_49);
+    } else if (face == FACE_MEDIUM) {
+        return fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD);
+    }
+    return fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
+}
+
+static void release_face_fonts() {
+    for (int i = 0; i < NUM_FACE_FONTS; ++i) {
+        if (face_resources[i]) {
+            release_font(face_resources[i]);
+        }
+    }
 }
 
 void load_face_fonts() {
-    int selected_font = persist_exists(KEY_FONTTYPE) ? persist_read_int(KEY_FONTTYPE) : LECO_FONT;
+    int selected_font = get_font_type();
+    uint32_t resources[NUM_FACE_FONTS] = { 0 };
 
     if (selected_font == SYSTEM_FONT) {
         time_font = fonts_get_system_font(FONT_KEY_ROBOTO_BOLD_SUBSET_49);
@@ -659,56 +1188,91 @@ void load_face_fonts() {
         base_font = fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD);
         loaded_font = SYSTEM_FONT;
     } else if (selected_font == ARCHIVO_FONT) {
-        time_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_ARCHIVO_56));
-        medium_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_ARCHIVO_28));
-        base_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_ARCHIVO_18));
+        resources[FACE_TIME] = RESOURCE_ID_FONT_ARCHIVO_56;
+        resources[FACE_MEDIUM] = RESOURCE_ID_FONT_ARCHIVO_28;
+        resources[FACE_BASE] = RESOURCE_ID_FONT_ARCHIVO_18;
         loaded_font = ARCHIVO_FONT;
     } else if (selected_font == DIN_FONT) {
-        time_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_DIN_58));
-        medium_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_DIN_26));
-        base_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_DIN_20));
+        resources[FACE_TIME] = RESOURCE_ID_FONT_DIN_58;
+        resources[FACE_MEDIUM] = RESOURCE_ID_FONT_DIN_26;
+        resources[FACE_BASE] = RESOURCE_ID_FONT_DIN_20;
         loaded_font = DIN_FONT;
     } else if (selected_font == PROTOTYPE_FONT) {
-        time_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_PROTOTYPE_48));
-        medium_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_PROTOTYPE_22));
-        base_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_PROTOTYPE_16));
+        resources[FACE_TIME] = RESOURCE_ID_FONT_PROTOTYPE_48;
+        resources[FACE_MEDIUM] = RESOURCE_ID_FONT_PROTOTYPE_22;
+        resources[FACE_BASE] = RESOURCE_ID_FONT_PROTOTYPE_16;
         loaded_font = PROTOTYPE_FONT;
     } else if (selected_font == BLOCKO_BIG_FONT) {
-        time_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_BLOCKO_64));
-        medium_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_BLOCKO_32));
-        base_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_BLOCKO_19));
+        resources[FACE_TIME] = RESOURCE_ID_FONT_BLOCKO_64;
+        resources[FACE_MEDIUM] = RESOURCE_ID_FONT_BLOCKO_32;
+        resources[FACE_BASE] = RESOURCE_ID_FONT_BLOCKO_19;
         loaded_font = BLOCKO_BIG_FONT;
     } else if (selected_font == LECO_FONT) {
-        time_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_LECO_47));
-        medium_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_LECO_21));
-        base_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_LECO_14));
+        resources[FACE_TIME] = RESOURCE_ID_FONT_LECO_47;
+        resources[FACE_MEDIUM] = RESOURCE_ID_FONT_LECO_21;
+        resources[FACE_BASE] = RESOURCE_ID_FONT_LECO_14;
         loaded_font = LECO_FONT;
     } else if (selected_font == KONSTRUCT_FONT) {
-        time_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_KONSTRUCT_33));
-        medium_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_KONSTRUCT_17));
-        base_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_KONSTRUCT_11));
+        resources[FACE_TIME] = RESOURCE_ID_FONT_KONSTRUCT_33;
+        resources[FACE_MEDIUM] = RESOURCE_ID_FONT_KONSTRUCT_17;
+        resources[FACE_BASE] = RESOURCE_ID_FONT_KONSTRUCT_11;
         loaded_font = KONSTRUCT_FONT;
     } else {
-        time_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_BLOCKO_56));
-        medium_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_BLOCKO_24));
-        base_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_BLOCKO_16));
+        resources[FACE_TIME] = RESOURCE_ID_FONT_BLOCKO_56;
+        resources[FACE_MEDIUM] = RESOURCE_ID_FONT_BLOCKO_24;
+        resources[FACE_BASE] = RESOURCE_ID_FONT_BLOCKO_16;
         loaded_font = BLOCKO_FONT;
     }
 
-    weather_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_WEATHER_24));
-    weather_font_small = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_WEATHER_16));
-    custom_font = fonts_load_custom_font(resource_get_handle(RESOURCE_ID_FONT_ICONS_20));
+    // icon fonts are only kept for modules that can show up in some slot
+    if (is_module_configured(MODULE_WEATHER)) {
+        resources[FACE_WEATHER] = RESOURCE_ID_FONT_WEATHER_24;
+    }
+    if (is_module_configured(MODULE_SUNRISE) || is_module_configured(MODULE_SUNSET)) {
+        resources[FACE_WEATHER_SMALL] = RESOURCE_ID_FONT_WEATHER_16;
+    }
+    resources[FACE_ICONS] = RESOURCE_ID_FONT_ICONS_20;
+
+    #if defined TIMEBOXED_DIGIT_ATLAS
+    if (resources[FACE_TIME] != face_resources[FACE_TIME]) {
+        destroy_digit_atlas();
+    }
+    #endif
+
+    // drop the fonts the new set does not use before loading it, so the cache
+    // and the heap never hold two full sets; fonts in both stay loaded
+    for (int i = 0; i < NUM_FACE_FONTS; ++i) {
+        if (face_resources[i] && !is_face_resource(resources, face_resources[i])) {
+            release_font(face_resources[i]);
+            face_resources[i] = 0;
+        }
+    }
+
+    GFont *face_fonts[NUM_FACE_FONTS] = { &time_font, &medium_font, &base_font,
+        &weather_font, &weather_font_small, &custom_font };
+    for (int i = 0; i < NUM_FACE_FONTS; ++i) {
+        if (resources[i]) {
+            *face_fonts[i] = acquire_font(resources[i]);
+            if (!*face_fonts[i]) {
+                // out of heap: show the face in a system font rather than none
+                APP_LOG(APP_LOG_LEVEL_ERROR, "Could not load font %d", (int)resources[i]);
+                *face_fonts[i] = get_fallback_font(i);
+                resources[i] = 0;
+            }
+        } else if (i > FACE_BASE) {
+            *face_fonts[i] = NULL;
+        }
+    }
+    release_face_fonts();
+    memcpy(face_resources, resources, sizeof(face_resources));
 }
 
 void unload_face_fonts() {
-    if (loaded_font != SYSTEM_FONT) {
-        fonts_unload_custom_font(time_font);
-        fonts_unload_custom_font(medium_font);
-        fonts_unload_custom_font(base_font);
-    }
-    fonts_unload_custom_font(weather_font);
-    fonts_unload_custom_font(weather_font_small);
-    fonts_unload_custom_font(custom_font);
+    #if defined TIMEBOXED_DIGIT_ATLAS
+    destroy_digit_atlas();
+    #endif
+    release_face_fonts();
+    memset(face_resources, 0, sizeof(face_resources));
 }
 
 void set_face_fonts() {
@@ -761,82 +1325,88 @@ void set_face_fonts() {
 }
 
 void set_colors(Window *window) {
-    base_color = persist_exists(KEY_HOURSCOLOR) ? GColorFromHEX(persist_read_int(KEY_HOURSCOLOR)) : GColorWhite;
-    text_layer_set_text_color(hours, base_color);
+    base_color = has_color(COLOR_HOURS) ? get_color(COLOR_HOURS) : GColorWhite;
+    set_text_color(hours, base_color);
     enable_advanced = is_advanced_colors_enabled();
 
-    text_layer_set_text_color(date,
-            enable_advanced ? GColorFromHEX(persist_read_int(KEY_DATECOLOR)) : base_color);
+    set_text_color(date,
+            enable_advanced ? get_color(COLOR_DATE) : base_color);
 
     if (is_module_enabled(MODULE_TIMEZONE)) {
         set_text_color(alt_time,
-            enable_advanced ? GColorFromHEX(persist_read_int(KEY_ALTHOURSCOLOR)) : base_color);
+            enable_advanced ? get_color(COLOR_ALTHOURS) : base_color);
     }
 
     #if !defined PBL_PLATFORM_APLITE
     if (is_module_enabled(MODULE_TIMEZONEB)) {
         set_text_color(alt_time_b,
-            enable_advanced ? GColorFromHEX(persist_read_int(KEY_ALTHOURSBCOLOR)) : base_color);
+            enable_advanced ? get_color(COLOR_ALTHOURSB) : base_color);
     }
     #endif
 
     if (is_module_enabled(MODULE_BATTERY)) {
-        battery_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_BATTERYCOLOR)) : base_color;
-        battery_low_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_BATTERYLOWCOLOR)) : base_color;
+        battery_color = enable_advanced ? get_color(COLOR_BATTERY) : base_color;
+        battery_low_color = enable_advanced ? get_color(COLOR_BATTERYLOW) : base_color;
     }
 
     #if !defined PBL_PLATFORM_APLITE
     if (is_module_enabled(MODULE_PHONEBATTERY)) {
-        phonebattery_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_PHONEBATTERYCOLOR)) : base_color;
-        phonebattery_low_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_PHONEBATTERYLOWCOLOR)) : base_color;
+        phonebattery_color = enable_advanced ? get_color(COLOR_PHONEBATTERY) : base_color;
+        phonebattery_low_color = enable_advanced ? get_color(COLOR_PHONEBATTERYLOW) : base_color;
     }
     #endif
 
-    window_set_background_color(window, persist_read_int(KEY_BGCOLOR) ? GColorFromHEX(persist_read_int(KEY_BGCOLOR)) : GColorBlack);
+    #if defined TIMEBOXED_CANVAS
+    canvas_color = get_color_value(COLOR_BG) ? get_color(COLOR_BG) : GColorBlack;
+    window_set_background_color(window, GColorClear);
+    mark_canvas_dirty();
+    #else
+    window_set_background_color(window, get_color_value(COLOR_BG) ? get_color(COLOR_BG) : GColorBlack);
+    #endif
 
     #if defined(PBL_HEALTH)
     if (is_module_enabled(MODULE_STEPS)) {
-        steps_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_STEPSCOLOR)) : base_color;
-        steps_behind_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_STEPSBEHINDCOLOR)) : base_color;
+        steps_color = enable_advanced ? get_color(COLOR_STEPS) : base_color;
+        steps_behind_color = enable_advanced ? get_color(COLOR_STEPSBEHIND) : base_color;
     }
     if (is_module_enabled(MODULE_DIST)) {
-        dist_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_DISTCOLOR)) : base_color;
-        dist_behind_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_DISTBEHINDCOLOR)) : base_color;
+        dist_color = enable_advanced ? get_color(COLOR_DIST) : base_color;
+        dist_behind_color = enable_advanced ? get_color(COLOR_DISTBEHIND) : base_color;
     }
     if (is_module_enabled(MODULE_CAL)) {
-        cal_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_CALCOLOR)) : base_color;
-        cal_behind_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_CALBEHINDCOLOR)) : base_color;
+        cal_color = enable_advanced ? get_color(COLOR_CAL) : base_color;
+        cal_behind_color = enable_advanced ? get_color(COLOR_CALBEHIND) : base_color;
     }
     if (is_module_enabled(MODULE_SLEEP)) {
-        sleep_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_SLEEPCOLOR)) : base_color;
-        sleep_behind_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_SLEEPBEHINDCOLOR)) : base_color;
+        sleep_color = enable_advanced ? get_color(COLOR_SLEEP) : base_color;
+        sleep_behind_color = enable_advanced ? get_color(COLOR_SLEEPBEHIND) : base_color;
     }
     if (is_module_enabled(MODULE_DEEP)) {
-        deep_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_DEEPCOLOR)) : base_color;
-        deep_behind_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_DEEPBEHINDCOLOR)) : base_color;
+        deep_color = enable_advanced ? get_color(COLOR_DEEP) : base_color;
+        deep_behind_color = enable_advanced ? get_color(COLOR_DEEPBEHIND) : base_color;
     }
     if (is_module_enabled(MODULE_ACTIVE)) {
-        active_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_ACTIVECOLOR)) : base_color;
-        active_behind_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_ACTIVEBEHINDCOLOR)) : base_color;
+        active_color = enable_advanced ? get_color(COLOR_ACTIVE) : base_color;
+        active_behind_color = enable_advanced ? get_color(COLOR_ACTIVEBEHIND) : base_color;
     }
     if (is_module_enabled(MODULE_HEART)) {
-        heart_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_HEARTCOLOR)) : base_color;
-        heart_color_off = enable_advanced ? GColorFromHEX(persist_read_int(KEY_HEARTCOLOROFF)) : base_color;
-        heart_low = persist_exists(KEY_HEARTLOW) ? persist_read_int(KEY_HEARTLOW) : 0;
-        heart_high = persist_exists(KEY_HEARTHIGH) ? persist_read_int(KEY_HEARTHIGH) : 0;
+        heart_color = enable_advanced ? get_color(COLOR_HEART) : base_color;
+        heart_color_off = enable_advanced ? get_color(COLOR_HEARTOFF) : base_color;
+        heart_low = get_heart_low();
+        heart_high = get_heart_high();
     }
     #endif
 
     if (is_module_enabled(MODULE_WEATHER)) {
         set_text_color(weather,
-                enable_advanced ? GColorFromHEX(persist_read_int(KEY_WEATHERCOLOR)) : base_color);
+                enable_advanced ? get_color(COLOR_WEATHER) : base_color);
         set_text_color(temp_cur,
-                enable_advanced ? GColorFromHEX(persist_read_int(KEY_TEMPCOLOR)) : base_color);
+                enable_advanced ? get_color(COLOR_TEMP) : base_color);
     }
 
     if (is_module_enabled(MODULE_FORECAST)) {
-        GColor min_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_MINCOLOR)) : base_color;
-        GColor max_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_MAXCOLOR)) : base_color;
+        GColor min_color = enable_advanced ? get_color(COLOR_MIN) : base_color;
+        GColor max_color = enable_advanced ? get_color(COLOR_MAX) : base_color;
         set_text_color(temp_min, min_color);
         set_text_color(min_icon, min_color);
         set_text_color(temp_max, max_color);
@@ -844,68 +1414,68 @@ void set_colors(Window *window) {
     }
 
     if (is_module_enabled(MODULE_WIND)) {
-        set_text_color(speed, enable_advanced ? GColorFromHEX(persist_read_int(KEY_WINDSPEEDCOLOR)) : base_color);
-        set_text_color(wind_unit, enable_advanced ? GColorFromHEX(persist_read_int(KEY_WINDSPEEDCOLOR)) : base_color);
-        set_text_color(direction, enable_advanced ? GColorFromHEX(persist_read_int(KEY_WINDDIRCOLOR)) : base_color);
+        set_text_color(speed, enable_advanced ? get_color(COLOR_WINDSPEED) : base_color);
+        set_text_color(wind_unit, enable_advanced ? get_color(COLOR_WINDSPEED) : base_color);
+        set_text_color(direction, enable_advanced ? get_color(COLOR_WINDDIR) : base_color);
     }
 
     if (is_module_enabled(MODULE_COMPASS)) {
-        GColor compass_color = enable_advanced ? GColorFromHEX(persist_read_int(KEY_COMPASSCOLOR)) : base_color;
+        GColor compass_color = enable_advanced ? get_color(COLOR_COMPASS) : base_color;
         set_text_color(compass, compass_color);
         set_text_color(degrees, compass_color);
     }
 
     if (is_module_enabled(MODULE_SUNRISE)) {
-        GColor sunrise_color = enable_advanced && persist_read_int(KEY_SUNRISECOLOR) ? GColorFromHEX(persist_read_int(KEY_SUNRISECOLOR)) : base_color;
+        GColor sunrise_color = enable_advanced && get_color_value(COLOR_SUNRISE) ? get_color(COLOR_SUNRISE) : base_color;
         set_text_color(sunrise, sunrise_color);
         set_text_color(sunrise_icon, sunrise_color);
     }
     if (is_module_enabled(MODULE_SUNSET)) {
-        GColor sunset_color = enable_advanced && persist_read_int(KEY_SUNSETCOLOR) ? GColorFromHEX(persist_read_int(KEY_SUNSETCOLOR)) : base_color;
+        GColor sunset_color = enable_advanced && get_color_value(COLOR_SUNSET) ? get_color(COLOR_SUNSET) : base_color;
         set_text_color(sunset, sunset_color);
         set_text_color(sunset_icon, sunset_color);
     }
     if (is_module_enabled(MODULE_SECONDS)) {
-        set_text_color(seconds, enable_advanced && persist_read_int(KEY_SECONDSCOLOR) ? GColorFromHEX(persist_read_int(KEY_SECONDSCOLOR)) : base_color);
+        set_text_color(seconds, enable_advanced && get_color_value(COLOR_SECONDS) ? get_color(COLOR_SECONDS) : base_color);
     }
 
     #if !defined PBL_PLATFORM_APLITE
     if (is_module_enabled(MODULE_CUSTOMTEXTA)) {
-        set_text_color(customtext_a, enable_advanced && persist_read_int(KEY_CUSTOMTEXTACOLOR) ? GColorFromHEX(persist_read_int(KEY_CUSTOMTEXTACOLOR)) : base_color);
+        set_text_color(customtext_a, enable_advanced && get_color_value(COLOR_CUSTOMTEXTA) ? get_color(COLOR_CUSTOMTEXTA) : base_color);
     }
 
     if (is_module_enabled(MODULE_CUSTOMTEXTB)) {
-        set_text_color(customtext_b, enable_advanced && persist_read_int(KEY_CUSTOMTEXTBCOLOR) ? GColorFromHEX(persist_read_int(KEY_CUSTOMTEXTBCOLOR)) : base_color);
+        set_text_color(customtext_b, enable_advanced && get_color_value(COLOR_CUSTOMTEXTB) ? get_color(COLOR_CUSTOMTEXTB) : base_color);
     }
 
     if (is_module_enabled(MODULE_CRYPTO)) {
-        set_text_color(crypto, enable_advanced && persist_read_int(KEY_CRYPTOCOLOR) ? GColorFromHEX(persist_read_int(KEY_CRYPTOCOLOR)) : base_color);
+        set_text_color(crypto, enable_advanced && get_color_value(COLOR_CRYPTO) ? get_color(COLOR_CRYPTO) : base_color);
     }
     if (is_module_enabled(MODULE_CRYPTOB)) {
-        set_text_color(crypto_b, enable_advanced && persist_read_int(KEY_CRYPTOBCOLOR) ? GColorFromHEX(persist_read_int(KEY_CRYPTOBCOLOR)) : base_color);
+        set_text_color(crypto_b, enable_advanced && get_color_value(COLOR_CRYPTOB) ? get_color(COLOR_CRYPTOB) : base_color);
     }
     if (is_module_enabled(MODULE_CRYPTOC)) {
-        set_text_color(crypto_c, enable_advanced && persist_read_int(KEY_CRYPTOCCOLOR) ? GColorFromHEX(persist_read_int(KEY_CRYPTOCCOLOR)) : base_color);
+        set_text_color(crypto_c, enable_advanced && get_color_value(COLOR_CRYPTOC) ? get_color(COLOR_CRYPTOC) : base_color);
     }
     if (is_module_enabled(MODULE_CRYPTOD)) {
-        set_text_color(crypto_d, enable_advanced && persist_read_int(KEY_CRYPTODCOLOR) ? GColorFromHEX(persist_read_int(KEY_CRYPTODCOLOR)) : base_color);
+        set_text_color(crypto_d, enable_advanced && get_color_value(COLOR_CRYPTOD) ? get_color(COLOR_CRYPTOD) : base_color);
     }
     #endif
 }
 
 void set_bluetooth_color() {
     set_text_color(bluetooth,
-        enable_advanced && persist_exists(KEY_BLUETOOTHCOLOR) ? GColorFromHEX(persist_read_int(KEY_BLUETOOTHCOLOR)) : base_color);
+        enable_advanced && has_color(COLOR_BLUETOOTH) ? get_color(COLOR_BLUETOOTH) : base_color);
 }
 
 void set_quiet_time_color() {
     set_text_color(quiettime,
-        enable_advanced && persist_exists(KEY_QUIETTIMECOLOR) ? GColorFromHEX(persist_read_int(KEY_QUIETTIMECOLOR)) : base_color);
+        enable_advanced && has_color(COLOR_QUIETTIME) ? get_color(COLOR_QUIETTIME) : base_color);
 }
 
 void set_update_color() {
     set_text_color(update,
-        enable_advanced && persist_exists(KEY_UPDATECOLOR) ? GColorFromHEX(persist_read_int(KEY_UPDATECOLOR)) : base_color);
+        enable_advanced && has_color(COLOR_UPDATE) ? get_color(COLOR_UPDATE) : base_color);
 }
 
 void set_battery_color(int percentage) {
@@ -916,6 +1486,12 @@ void set_battery_color(int percentage) {
     }
 }
 
+#if defined TIMEBOXED_CANVAS
+void redraw_text_layers() {
+    mark_canvas_dirty();
+}
+#endif
+
 #if !defined PBL_PLATFORM_APLITE
 void set_phonebattery_color(int percentage) {
     if (percentage > 10) {
@@ -927,67 +1503,52 @@ void set_phonebattery_color(int percentage) {
 #endif
 
 void set_hours_layer_text(char* text) {
-    strcpy(hour_text, text);
-    set_text(hours, hour_text);
+    set_layer_text(hours, hour_text, HOUR_TEXT_SIZE, text, false);
 }
 
 void set_date_layer_text(char* text) {
-    strcpy(date_text, text);
-    if (loaded_font == LECO_FONT || loaded_font == KONSTRUCT_FONT) {
-        for (unsigned char i = 0; date_text[i]; ++i) {
-            date_text[i] = to_upper_case((unsigned char)date_text[i]);
-        }
-    }
-    set_text(date, date_text);
+    set_layer_text(date, date_text, DATE_TEXT_SIZE, text,
+            loaded_font == LECO_FONT || loaded_font == KONSTRUCT_FONT);
 }
 
 void set_alt_time_layer_text(char* text) {
-    strcpy(alt_time_text, text);
-    set_text(alt_time, alt_time_text);
+    set_layer_text(alt_time, alt_time_text, ALT_TIME_TEXT_SIZE, text, false);
 }
 
 #if !defined PBL_PLATFORM_APLITE
 void set_alt_time_b_layer_text(char* text) {
-    strcpy(alt_time_b_text, text);
-    set_text(alt_time_b, alt_time_b_text);
+    set_layer_text(alt_time_b, alt_time_b_text, ALT_TIME_B_TEXT_SIZE, text, false);
 }
 #endif
 
 void set_battery_layer_text(char* text) {
-    strcpy(battery_text, text);
-    set_text(battery, battery_text);
+    set_layer_text(battery, battery_text, BATTERY_TEXT_SIZE, text, false);
 }
 
 #if !defined PBL_PLATFORM_APLITE
 void set_phonebattery_layer_text(char* text) {
-    strcpy(phonebattery_text, text);
-    set_text(phonebattery, phonebattery_text);
+    set_layer_text(phonebattery, phonebattery_text, PHONEBATTERY_TEXT_SIZE, text, false);
 }
 #endif
 
 void set_bluetooth_layer_text(char* text) {
-    strcpy(bluetooth_text, text);
-    set_text(bluetooth, bluetooth_text);
+    set_layer_text(bluetooth, bluetooth_text, BLUETOOTH_TEXT_SIZE, text, false);
 }
 
 void set_quiet_time_layer_text(char* text) {
-    strcpy(quiettime_text, text);
-    set_text(quiettime, quiettime_text);
+    set_layer_text(quiettime, quiettime_text, QUIETTIME_TEXT_SIZE, text, false);
 }
 
 void set_temp_cur_layer_text(char* text) {
-    strcpy(temp_cur_text, text);
-    set_text(temp_cur, temp_cur_text);
+    set_layer_text(temp_cur, temp_cur_text, TEMP_CUR_TEXT_SIZE, text, false);
 }
 
 void set_temp_max_layer_text(char* text) {
-    strcpy(temp_max_text, text);
-    set_text(temp_max, temp_max_text);
+    set_layer_text(temp_max, temp_max_text, TEMP_MAX_TEXT_SIZE, text, false);
 }
 
 void set_temp_min_layer_text(char* text) {
-    strcpy(temp_min_text, text);
-    set_text(temp_min, temp_min_text);
+    set_layer_text(temp_min, temp_min_text, TEMP_MIN_TEXT_SIZE, text, false);
 }
 
 #if defined(PBL_HEALTH)
@@ -1030,79 +1591,70 @@ void set_progress_color_heart(int heart_value) {
 }
 
 void set_steps_layer_text(char* text) {
-    strcpy(steps_text, text);
-    set_text(steps, steps_text);
+    set_layer_text(steps, steps_text, STEPS_TEXT_SIZE, text, false);
 }
 
 void set_dist_layer_text(char* text) {
-    strcpy(dist_text, text);
-    if (loaded_font == LECO_FONT || loaded_font == KONSTRUCT_FONT) {
-        for (unsigned char i = 0; dist_text[i]; ++i) {
-            dist_text[i] = to_upper_case((unsigned char)dist_text[i]);
-        }
-    }
-    set_text(dist, dist_text);
+    set_layer_text(dist, dist_text, DIST_TEXT_SIZE, text,
+            loaded_font == LECO_FONT || loaded_font == KONSTRUCT_FONT);
 }
 
 void set_cal_layer_text(char* text) {
-    strcpy(cal_text, text);
-    if (loaded_font == LECO_FONT) {
-        for (unsigned char i = 0; cal_text[i]; ++i) {
-            cal_text[i] = to_upper_case((unsigned char)cal_text[i]);
-        }
-    }
-    set_text(cal, cal_text);
+    set_layer_text(cal, cal_text, CAL_TEXT_SIZE, text,
+            loaded_font == LECO_FONT);
 }
 
 void set_sleep_layer_text(char* text) {
-    strcpy(sleep_text, text);
-    if (loaded_font == LECO_FONT) {
-        for (unsigned char i = 0; sleep_text[i]; ++i) {
-            sleep_text[i] = to_upper_case((unsigned char)sleep_text[i]);
-        }
-    }
-    set_text(sleep, sleep_text);
+    set_layer_text(sleep, sleep_text, SLEEP_TEXT_SIZE, text,
+            loaded_font == LECO_FONT);
 }
 
 void set_deep_layer_text(char* text) {
-    strcpy(deep_text, text);
-    if (loaded_font == LECO_FONT || loaded_font == KONSTRUCT_FONT) {
-        for (unsigned char i = 0; deep_text[i]; ++i) {
-            deep_text[i] = to_upper_case((unsigned char)deep_text[i]);
-        }
-    }
-    set_text(deep, deep_text);
+    set_layer_text(deep, deep_text, DEEP_TEXT_SIZE, text,
+            loaded_font == LECO_FONT || loaded_font == KONSTRUCT_FONT);
 }
 
 void set_active_layer_text(char* text) {
-    strcpy(active_text, text);
-    if (loaded_font == LECO_FONT || loaded_font == KONSTRUCT_FONT) {
-        for (unsigned char i = 0; active_text[i]; ++i) {
-            active_text[i] = to_upper_case((unsigned char)active_text[i]);
-        }
-    }
-    set_text(active, active_text);
+    set_layer_text(active, active_text, ACTIVE_TEXT_SIZE, text,
+            loaded_font == LECO_FONT || loaded_font == KONSTRUCT_FONT);
 }
 
 void set_heart_layer_text(char* text) {
-    strcpy(heart_text, text);
-    if (loaded_font == LECO_FONT || loaded_font == KONSTRUCT_FONT) {
-        for (unsigned char i = 0; active_text[i]; ++i) {
-            active_text[i] = to_upper_case((unsigned char)active_text[i]);
-        }
-    }
-    set_text(heart, heart_text);
+    set_layer_text(heart, heart_text, HEART_TEXT_SIZE, text,
+            loaded_font == LECO_FONT || loaded_font == KONSTRUCT_FONT);
 }
 
 void set_heart_icon_layer_text(char* text) {
-    strcpy(heart_icon_text, text);
-    set_text(heart_icon, heart_icon_text);
+    set_layer_text(heart_icon, heart_icon_text, HEART_ICON_TEXT_SIZE, text, false);
+}
+
+const char* get_steps_layer_text() {
+    return steps_text;
+}
+
+const char* get_dist_layer_text() {
+    return dist_text;
+}
+
+const char* get_cal_layer_text() {
+    return cal_text;
+}
+
+const char* get_sleep_layer_text() {
+    return sleep_text;
+}
+
+const char* get_deep_layer_text() {
+    return deep_text;
+}
+
+const char* get_active_layer_text() {
+    return active_text;
 }
 #endif
 
 void set_weather_layer_text(char* text) {
-    strcpy(weather_text, text);
-    set_text(weather, weather_text);
+    set_layer_text(weather, weather_text, WEATHER_TEXT_SIZE, text, false);
 }
 
 void set_weather_layer_color(GColor8 color) {
@@ -1111,98 +1663,79 @@ void set_weather_layer_color(GColor8 color) {
 }
 
 void set_max_icon_layer_text(char* text) {
-    strcpy(max_icon_text, text);
-    set_text(max_icon, max_icon_text);
+    set_layer_text(max_icon, max_icon_text, MAX_ICON_TEXT_SIZE, text, false);
 }
 
 void set_min_icon_layer_text(char* text) {
-    strcpy(min_icon_text, text);
-    set_text(min_icon, min_icon_text);
+    set_layer_text(min_icon, min_icon_text, MIN_ICON_TEXT_SIZE, text, false);
 }
 
 void set_update_layer_text(char* text) {
-    strcpy(update_text, text);
-    set_text(update, update_text);
+    set_layer_text(update, update_text, UPDATE_TEXT_SIZE, text, false);
 }
 
 void set_wind_speed_layer_text(char* text) {
-    strcpy(speed_text, text);
-    set_text(speed, speed_text);
+    set_layer_text(speed, speed_text, SPEED_TEXT_SIZE, text, false);
 }
 
 void set_wind_direction_layer_text(char* text) {
-    strcpy(direction_text, text);
-    set_text(direction, direction_text);
+    set_layer_text(direction, direction_text, DIRECTION_TEXT_SIZE, text, false);
 }
 
 void set_wind_unit_layer_text(char* text) {
-    strcpy(wind_unit_text, text);
-    set_text(wind_unit, wind_unit_text);
+    set_layer_text(wind_unit, wind_unit_text, WIND_UNIT_TEXT_SIZE, text, false);
 }
 
 void set_sunrise_layer_text(char* text) {
-    strcpy(sunrise_text, text);
-    set_text(sunrise, sunrise_text);
+    set_layer_text(sunrise, sunrise_text, SUNRISE_TEXT_SIZE, text, false);
 }
 
 void set_sunrise_icon_layer_text(char* text) {
-    strcpy(sunrise_icon_text, text);
-    set_text(sunrise_icon, sunrise_icon_text);
+    set_layer_text(sunrise_icon, sunrise_icon_text, SUNRISE_ICON_TEXT_SIZE, text, false);
 }
 
 void set_sunset_layer_text(char* text) {
-    strcpy(sunset_text, text);
-    set_text(sunset, sunset_text);
+    set_layer_text(sunset, sunset_text, SUNSET_TEXT_SIZE, text, false);
 }
 
 void set_sunset_icon_layer_text(char* text) {
-    strcpy(sunset_icon_text, text);
-    set_text(sunset_icon, sunset_icon_text);
+    set_layer_text(sunset_icon, sunset_icon_text, SUNSET_ICON_TEXT_SIZE, text, false);
 }
 
 void set_degrees_layer_text(char* text) {
-    strcpy(degrees_text, text);
-    set_text(degrees, degrees_text);
+    set_layer_text(degrees, degrees_text, DEGREES_TEXT_SIZE, text, false);
 }
 
 void set_compass_layer_text(char* text) {
-    strcpy(compass_text, text);
-    set_text(compass, compass_text);
+    set_layer_text(compass, compass_text, COMPASS_TEXT_SIZE, text, false);
 }
 
 void set_seconds_layer_text(char* text) {
-    strcpy(seconds_text, text);
-    set_text(seconds, seconds_text);
+    set_layer_text(seconds, seconds_text, SECONDS_TEXT_SIZE, text, false);
 }
 
 #if !defined PBL_PLATFORM_APLITE
 void set_customtext_a_layer_text(char* text) {
-    strcpy(customtext_a_text, text);
-    set_text(customtext_a, customtext_a_text);
+    set_layer_text(customtext_a, customtext_a_text, CUSTOMTEXT_A_TEXT_SIZE, text, false);
 }
 
 void set_customtext_b_layer_text(char* text) {
-    strcpy(customtext_b_text, text);
-    set_text(customtext_b, customtext_b_text);
+    set_layer_text(customtext_b, customtext_b_text, CUSTOMTEXT_B_TEXT_SIZE, text, false);
 }
 
 void set_crypto_layer_text(char* text) {
-    strcpy(crypto_text, text);
-    set_text(crypto, crypto_text);
+    set_layer_text(crypto, crypto_text, CRYPTO_TEXT_SIZE, text, false);
 }
 
 void set_crypto_b_layer_text(char* text) {
-    strcpy(crypto_b_text, text);
-    set_text(crypto_b, crypto_b_text);
+    set_layer_text(crypto_b, crypto_b_text, CRYPTO_B_TEXT_SIZE, text, false);
 }
 
 void set_crypto_c_layer_text(char* text) {
-    strcpy(crypto_c_text, text);
-    set_text(crypto_c, crypto_c_text);
+    set_layer_text(crypto_c, crypto_c_text, CRYPTO_C_TEXT_SIZE, text, false);
 }
 
 void set_crypto_d_layer_text(char* text) {
-    strcpy(crypto_d_text, text);
-    set_text(crypto_d, crypto_d_text);
+    set_layer_text(crypto_d, crypto_d_text, CRYPTO_D_TEXT_SIZE, text, false);
 }
 #endif
@@ -6,8 +6,12 @@
 int to_upper_case(char);
 
 void create_text_layers(Window*);
+void layout_text_layers(Window*);
 
 void destroy_text_layers();
+#if defined TIMEBOXED_CANVAS
+void redraw_text_layers();
+#endif
 
 void load_face_fonts();
 void unload_face_fonts();
@@ -57,6 +61,13 @@ void set_deep_layer_text(char*);
 void set_active_layer_text(char*);
 void set_heart_layer_text(char*);
 void set_heart_icon_layer_text(char*);
+
+const char* get_steps_layer_text();
+const char* get_dist_layer_text();
+const char* get_cal_layer_text();
+const char* get_sleep_layer_text();
+const char* get_deep_layer_text();
+const char* get_active_layer_text();
 #endif
 
 void set_weather_layer_text(char*);
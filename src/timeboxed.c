@@ -13,507 +13,408 @@
 #include "crypto.h"
 #include "phonebattery.h"
 #include "customtext.h"
+#include "profiler.h"
+#include "scheduler.h"
+#include "outbox.h"
 
 static Window *watchface;
 
-#if defined(PBL_HEALTH)
-static int min_count = 0;
-static uint8_t health_color_keys[] = {
-    KEY_STEPSCOLOR,
-    KEY_STEPSBEHINDCOLOR,
-    KEY_DISTCOLOR,
-    KEY_DISTBEHINDCOLOR,
-    KEY_CALCOLOR,
-    KEY_CALBEHINDCOLOR,
-    KEY_SLEEPCOLOR,
-    KEY_SLEEPBEHINDCOLOR,
-    KEY_DEEPCOLOR,
-    KEY_DEEPBEHINDCOLOR,
-    KEY_ACTIVECOLOR,
-    KEY_ACTIVEBEHINDCOLOR,
-    KEY_HEARTCOLOR,
-    KEY_HEARTCOLOROFF
-};
-static uint8_t num_health_colors = 14;
-#endif
-
 #if !defined PBL_PLATFORM_APLITE
-static uint32_t slot_sleep_keys[] = {
-    KEY_SLEEPSLOTA,
-    KEY_SLEEPSLOTB,
-    KEY_SLEEPSLOTC,
-    KEY_SLEEPSLOTD,
-    KEY_SLEEPSLOTE,
-    KEY_SLEEPSLOTF,
-};
-static uint32_t slot_tap_keys[] = {
-    KEY_TAPSLOTA,
-    KEY_TAPSLOTB,
-    KEY_TAPSLOTC,
-    KEY_TAPSLOTD,
-    KEY_TAPSLOTE,
-    KEY_TAPSLOTF,
-};
-static uint32_t slot_wrist_keys[] = {
-    KEY_WRISTSLOTA,
-    KEY_WRISTSLOTB,
-    KEY_WRISTSLOTC,
-    KEY_WRISTSLOTD,
-    KEY_WRISTSLOTE,
-    KEY_WRISTSLOTF,
-};
 static int sec_count = 0;
 static int timeout_sec = 0;
 #endif
 
-static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
-    Tuple * error_tuple = dict_find(iterator, KEY_ERROR);
-
-    if (error_tuple) {
-        return;
-    }
-
-    Tuple *update_tuple = dict_find(iterator, KEY_HASUPDATE);
-    if (update_tuple) {
-        int update_val = update_tuple->value->int8;
-        persist_write_int(KEY_HASUPDATE, update_val);
-        notify_update(update_val);
-        return;
-    }
-
-    Tuple *temp_tuple = dict_find(iterator, KEY_TEMP);
-    Tuple *max_tuple = dict_find(iterator, KEY_MAX);
-    Tuple *min_tuple = dict_find(iterator, KEY_MIN);
-    Tuple *weather_tuple = dict_find(iterator, KEY_WEATHER);
-    Tuple *speed_tuple = dict_find(iterator, KEY_SPEED);
-    Tuple *direction_tuple = dict_find(iterator, KEY_DIRECTION);
-    Tuple *sunrise_tuple = dict_find(iterator, KEY_SUNRISE);
-    Tuple *sunset_tuple = dict_find(iterator, KEY_SUNSET);
-
-    if (temp_tuple || max_tuple || speed_tuple || sunrise_tuple || sunset_tuple) {
-        int temp_val = (int)temp_tuple->value->int32;
-        int max_val = (int)max_tuple->value->int32;
-        int min_val = (int)min_tuple->value->int32;
-        int weather_val = (int)weather_tuple->value->int32;
-
-        update_weather_values(temp_val, weather_val);
-        update_forecast_values(max_val, min_val);
-
-        int speed_val = (int)speed_tuple->value->int32;
-        int direction_val = (int)direction_tuple->value->int32;
-
-        int sunrise_val = (int)sunrise_tuple->value->int32;
-        int sunset_val = (int)sunset_tuple->value->int32;
-
-        update_wind_values(speed_val, direction_val);
-        update_sunrise(sunrise_val);
-        update_sunset(sunset_val);
-        store_weather_values(temp_val, max_val, min_val, weather_val, speed_val, direction_val, sunrise_val, sunset_val);
-        return;
-    }
-
-
-    #if !defined PBL_PLATFORM_APLITE
-    Tuple *custom_text_a = dict_find(iterator, KEY_CUSTOMTEXTATEXT);
-    Tuple *custom_text_b = dict_find(iterator, KEY_CUSTOMTEXTBTEXT);
-
-    if (custom_text_a || custom_text_b) {
-        if (custom_text_a) {
-            static char custom_text_val[22];
-            char* value = custom_text_a->value->cstring;
-            strcpy(custom_text_val, value);
-            update_customtext_a_text(custom_text_val);
-            store_customtext_a_text(custom_text_val);
-        }
-
-        if (custom_text_b) {
-            static char custom_text_val[22];
-            char* value = custom_text_b->value->cstring;
-            strcpy(custom_text_val, value);
-            update_customtext_b_text(custom_text_val);
-            store_customtext_b_text(custom_text_val);
-        }
-
-        return;
-    }
-    #endif
-
-    #if !defined PBL_PLATFORM_APLITE
-    Tuple *crypto_price = dict_find(iterator, KEY_CRYPTOPRICE);
-    Tuple *crypto_price_b = dict_find(iterator, KEY_CRYPTOPRICEB);
-    Tuple *crypto_price_c = dict_find(iterator, KEY_CRYPTOPRICEC);
-    Tuple *crypto_price_d = dict_find(iterator, KEY_CRYPTOPRICED);
-
-    if (crypto_price || crypto_price_b || crypto_price_c || crypto_price_d) {
-        if (crypto_price) {
-            static char crypto_val[8];
-            char* value = crypto_price->value->cstring;
-            strcpy(crypto_val, value);
-            update_crypto_price(crypto_val);
-            store_crypto_price(crypto_val);
-        }
-
-        if (crypto_price_b) {
-            static char crypto_val[8];
-            char* value = crypto_price_b->value->cstring;
-            strcpy(crypto_val, value);
-            update_crypto_price_b(crypto_val);
-            store_crypto_price_b(crypto_val);
-        }
-
-        if (crypto_price_c) {
-            static char crypto_val[8];
-            char* value = crypto_price_c->value->cstring;
-            strcpy(crypto_val, value);
-            update_crypto_price_c(crypto_val);
-            store_crypto_price_c(crypto_val);
-        }
-
-        if (crypto_price_d) {
-            static char crypto_val[8];
-            char* value = crypto_price_d->value->cstring;
-            strcpy(crypto_val, value);
-            update_crypto_price_d(crypto_val);
-            store_crypto_price_d(crypto_val);
-        }
-        return;
-    }
-    #endif
+#define INBOX_NONE 0
+#define INBOX_ERROR 1
+#define INBOX_UPDATE 2
+#define INBOX_WEATHER 3
+#define INBOX_CUSTOMTEXT 4
+#define INBOX_CRYPTO 5
+#define INBOX_PHONEBATTERY 6
+#define INBOX_TIMEZONE 7
+#define INBOX_TOGGLE 8
+#define INBOX_INT 9
+#define INBOX_INT32 10
+#define INBOX_COLOR 11
+#define INBOX_SLOT 12
+#define INBOX_LOCATION 13
+#define INBOX_CONFIGDONE 14
+
+#define INBOX_KEYS (KEY_CONFIGDONE + 1)
+
+// indices into the tuples collected for data messages
+#define DATA_WEATHER 0
+#define DATA_CUSTOMTEXTA 1
+#define DATA_CUSTOMTEXTB 2
+#define DATA_CRYPTO 3
+#define DATA_PHONEBATTERY_LEVEL 7
+#define DATA_PHONEBATTERY_CHARGING 8
+#define NUM_DATA 9
+
+#define INBOX_SLOT_ARG(state, slot) ((state) << 3 | (slot))
+
+struct InboxKey {
+    uint8_t type;
+    uint8_t arg;
+};
 
+// every key the phone can send, routed to what it updates
+static const struct InboxKey inbox_keys[INBOX_KEYS] = {
+    [KEY_ERROR] = { INBOX_ERROR, 0 },
+    [KEY_HASUPDATE] = { INBOX_UPDATE, 0 },
+
+    [KEY_WEATHERDATA] = { INBOX_WEATHER, DATA_WEATHER },
+
+    [KEY_TIMEZONES] = { INBOX_TIMEZONE, 0 },
+    [KEY_TIMEZONESMINUTES] = { INBOX_TIMEZONE, 0 },
+    [KEY_TIMEZONESCODE] = { INBOX_TIMEZONE, 0 },
+    [KEY_OVERRIDELOCATION] = { INBOX_LOCATION, 0 },
+    [KEY_CONFIGDONE] = { INBOX_CONFIGDONE, 0 },
+
+    [KEY_WEATHER] = { INBOX_TOGGLE, 0 },
+    [KEY_SHOWSLEEP] = { INBOX_TOGGLE, 1 },
+    [KEY_USECELSIUS] = { INBOX_TOGGLE, 2 },
+    [KEY_ENABLEADVANCED] = { INBOX_TOGGLE, 3 },
+    [KEY_BLUETOOTHDISCONNECT] = { INBOX_TOGGLE, 4 },
+    [KEY_UPDATE] = { INBOX_TOGGLE, 5 },
+    [KEY_LEADINGZERO] = { INBOX_TOGGLE, 6 },
+    [KEY_SIMPLEMODE] = { INBOX_TOGGLE, 7 },
+    [KEY_QUICKVIEW] = { INBOX_TOGGLE, 8 },
+    [KEY_SHOWTAP] = { INBOX_TOGGLE, 9 },
+    [KEY_SHOWWRIST] = { INBOX_TOGGLE, 10 },
+    [KEY_MUTEONQUIET] = { INBOX_TOGGLE, 11 },
+    [KEY_DATELEADINGZERO] = { INBOX_TOGGLE, 12 },
+
+    [KEY_FONTTYPE] = { INBOX_INT, 0 },
+    [KEY_LOCALE] = { INBOX_INT, 0 },
+    [KEY_DATEFORMAT] = { INBOX_INT, 0 },
+    [KEY_TEXTALIGN] = { INBOX_INT, 0 },
+    [KEY_SPEEDUNIT] = { INBOX_INT, 0 },
+    [KEY_WEATHERTIME] = { INBOX_INT, 0 },
+    [KEY_DATESEPARATOR] = { INBOX_INT, 0 },
+
+    [KEY_BGCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_HOURSCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_ALTHOURSCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_DATECOLOR] = { INBOX_COLOR, 0 },
+    [KEY_BLUETOOTHCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_UPDATECOLOR] = { INBOX_COLOR, 0 },
+    [KEY_BATTERYCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_BATTERYLOWCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_TEMPCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_WEATHERCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_MINCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_MAXCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_WINDDIRCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_WINDSPEEDCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_COMPASSCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_SUNRISECOLOR] = { INBOX_COLOR, 0 },
+    [KEY_SUNSETCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_SECONDSCOLOR] = { INBOX_COLOR, 0 },
+
+    [KEY_SLOTA] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_NORMAL, SLOT_A) },
+    [KEY_SLOTB] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_NORMAL, SLOT_B) },
+    [KEY_SLOTC] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_NORMAL, SLOT_C) },
+    [KEY_SLOTD] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_NORMAL, SLOT_D) },
+    [KEY_SLOTE] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_NORMAL, SLOT_E) },
+    [KEY_SLOTF] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_NORMAL, SLOT_F) },
 
     #if !defined PBL_PLATFORM_APLITE
-    Tuple *phonebattery_level = dict_find(iterator, KEY_PHONEBATTERY_LEVEL);
-    Tuple *phonebattery_charging = dict_find(iterator, KEY_PHONEBATTERY_CHARGING);
-
-    if (phonebattery_level || phonebattery_charging) {
-
-        int phbatt_lvl_val = (int)phonebattery_level->value->int32;
-        int phbatt_chg_val = (int)phonebattery_charging->value->int32;
-
-        update_phonebattery_value(phbatt_lvl_val,phbatt_chg_val);
-        store_phonebattery_vals(phbatt_lvl_val, phbatt_chg_val);
-        return;
-    }
+    [KEY_CUSTOMTEXTATEXT] = { INBOX_CUSTOMTEXT, DATA_CUSTOMTEXTA },
+    [KEY_CUSTOMTEXTBTEXT] = { INBOX_CUSTOMTEXT, DATA_CUSTOMTEXTB },
+
+    [KEY_CRYPTOPRICE] = { INBOX_CRYPTO, DATA_CRYPTO },
+    [KEY_CRYPTOPRICEB] = { INBOX_CRYPTO, DATA_CRYPTO + 1 },
+    [KEY_CRYPTOPRICEC] = { INBOX_CRYPTO, DATA_CRYPTO + 2 },
+    [KEY_CRYPTOPRICED] = { INBOX_CRYPTO, DATA_CRYPTO + 3 },
+
+    [KEY_PHONEBATTERY_LEVEL] = { INBOX_PHONEBATTERY, DATA_PHONEBATTERY_LEVEL },
+    [KEY_PHONEBATTERY_CHARGING] = { INBOX_PHONEBATTERY, DATA_PHONEBATTERY_CHARGING },
+
+    [KEY_TIMEZONESB] = { INBOX_TIMEZONE, 0 },
+    [KEY_TIMEZONESBMINUTES] = { INBOX_TIMEZONE, 0 },
+    [KEY_TIMEZONESBCODE] = { INBOX_TIMEZONE, 0 },
+
+    [KEY_CRYPTOTIME] = { INBOX_INT, 0 },
+    [KEY_PHONEBATTERYTIME] = { INBOX_INT, 0 },
+    [KEY_TAPTIME] = { INBOX_INT, 0 },
+
+    [KEY_PHONEBATTERYCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_PHONEBATTERYLOWCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_ALTHOURSBCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_CRYPTOCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_CRYPTOBCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_CRYPTOCCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_CRYPTODCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_CUSTOMTEXTACOLOR] = { INBOX_COLOR, 0 },
+    [KEY_CUSTOMTEXTBCOLOR] = { INBOX_COLOR, 0 },
+
+    [KEY_SLEEPSLOTA] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_SLEEP, SLOT_A) },
+    [KEY_SLEEPSLOTB] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_SLEEP, SLOT_B) },
+    [KEY_SLEEPSLOTC] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_SLEEP, SLOT_C) },
+    [KEY_SLEEPSLOTD] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_SLEEP, SLOT_D) },
+    [KEY_SLEEPSLOTE] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_SLEEP, SLOT_E) },
+    [KEY_SLEEPSLOTF] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_SLEEP, SLOT_F) },
+    [KEY_TAPSLOTA] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_TAP, SLOT_A) },
+    [KEY_TAPSLOTB] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_TAP, SLOT_B) },
+    [KEY_TAPSLOTC] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_TAP, SLOT_C) },
+    [KEY_TAPSLOTD] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_TAP, SLOT_D) },
+    [KEY_TAPSLOTE] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_TAP, SLOT_E) },
+    [KEY_TAPSLOTF] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_TAP, SLOT_F) },
+    [KEY_WRISTSLOTA] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_WRIST, SLOT_A) },
+    [KEY_WRISTSLOTB] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_WRIST, SLOT_B) },
+    [KEY_WRISTSLOTC] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_WRIST, SLOT_C) },
+    [KEY_WRISTSLOTD] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_WRIST, SLOT_D) },
+    [KEY_WRISTSLOTE] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_WRIST, SLOT_E) },
+    [KEY_WRISTSLOTF] = { INBOX_SLOT, INBOX_SLOT_ARG(STATE_WRIST, SLOT_F) },
     #endif
 
-    int configs = 0;
-    signed int tz_hour = 0;
-    uint8_t tz_minute = 0;
-    static char tz_name[TZ_LEN];
-
-    #if !defined PBL_PLATFORM_APLITE
-    signed int tz_hour_b = 0;
-    uint8_t tz_minute_b = 0;
-    static char tz_name_b[TZ_LEN];
+    #if defined(PBL_HEALTH)
+    [KEY_STEPSCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_STEPSBEHINDCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_DISTCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_DISTBEHINDCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_CALCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_CALBEHINDCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_SLEEPCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_SLEEPBEHINDCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_DEEPCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_DEEPBEHINDCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_ACTIVECOLOR] = { INBOX_COLOR, 0 },
+    [KEY_ACTIVEBEHINDCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_HEARTCOLOR] = { INBOX_COLOR, 0 },
+    [KEY_HEARTCOLOROFF] = { INBOX_COLOR, 0 },
+    [KEY_HEARTLOW] = { INBOX_INT32, 0 },
+    [KEY_HEARTHIGH] = { INBOX_INT32, 0 },
     #endif
+};
 
-    Tuple *key_value = NULL;
-
-    // Timezone A
-    key_value = NULL; key_value = dict_find(iterator, KEY_TIMEZONES);
-    if (key_value) {
-        persist_write_int(KEY_TIMEZONES, key_value->value->int8);
-        tz_hour = key_value->value->int8;
-    }
+static const uint32_t config_flags[] = {
+    FLAG_WEATHER,
+    FLAG_SLEEP,
+    FLAG_CELSIUS,
+    FLAG_ADVANCED,
+    FLAG_BLUETOOTH,
+    FLAG_UPDATE,
+    FLAG_LEADINGZERO,
+    FLAG_SIMPLEMODE,
+    FLAG_QUICKVIEW,
+    FLAG_TAP,
+    FLAG_WRIST,
+    FLAG_MUTEONQUIET,
+    FLAG_DATELEADINGZERO
+};
+static const bool config_defaults[] = {
+    true,
+    true,
+    true,
+    true,
+    true,
+    false,
+    false,
+    true,
+    false,
+    true,
+    true,
+    false,
+    false
+};
 
-    key_value = NULL; key_value = dict_find(iterator, KEY_TIMEZONESMINUTES);
-    if (key_value) {
-        persist_write_int(KEY_TIMEZONESMINUTES, key_value->value->int8);
-        tz_minute = key_value->value->int8;
+#if !defined PBL_PLATFORM_APLITE
+static void handle_customtext_message(Tuple **data) {
+    if (data[DATA_CUSTOMTEXTA]) {
+        char *custom_text_val = data[DATA_CUSTOMTEXTA]->value->cstring;
+        update_customtext_a_text(custom_text_val);
+        store_customtext_a_text(custom_text_val);
     }
 
-    key_value = NULL; key_value = dict_find(iterator, KEY_TIMEZONESCODE);
-    if (key_value) {
-        char* tz_code = key_value->value->cstring;
-        persist_write_string(KEY_TIMEZONESCODE, tz_code);
-        strcpy(tz_name, tz_code);
+    if (data[DATA_CUSTOMTEXTB]) {
+        char *custom_text_val = data[DATA_CUSTOMTEXTB]->value->cstring;
+        update_customtext_b_text(custom_text_val);
+        store_customtext_b_text(custom_text_val);
     }
+}
 
-    #if !defined PBL_PLATFORM_APLITE
-    // Timezone B
-    key_value = NULL; key_value = dict_find(iterator, KEY_TIMEZONESB);
-    if (key_value) {
-        persist_write_int(KEY_TIMEZONESB, key_value->value->int8);
-        tz_hour_b = key_value->value->int8;
-    }
+static void handle_crypto_message(Tuple **data) {
+    // the text layers keep their own copy, so the tuple strings are used as is
+    void (*updates[4])(char*) = { update_crypto_price, update_crypto_price_b, update_crypto_price_c, update_crypto_price_d };
+    void (*stores[4])(char*) = { store_crypto_price, store_crypto_price_b, store_crypto_price_c, store_crypto_price_d };
 
-    key_value = NULL; key_value = dict_find(iterator, KEY_TIMEZONESBMINUTES);
-    if (key_value) {
-        persist_write_int(KEY_TIMEZONESBMINUTES, key_value->value->int8);
-        tz_minute_b = key_value->value->int8;
+    for (int i = 0; i < 4; ++i) {
+        if (data[DATA_CRYPTO + i]) {
+            updates[i](data[DATA_CRYPTO + i]->value->cstring);
+            stores[i](data[DATA_CRYPTO + i]->value->cstring);
+        }
     }
+}
 
-    key_value = NULL; key_value = dict_find(iterator, KEY_TIMEZONESBCODE);
-    if (key_value) {
-        char* tz_code = key_value->value->cstring;
-        persist_write_string(KEY_TIMEZONESBCODE, tz_code);
-        strcpy(tz_name_b, tz_code);
+static void handle_phonebattery_message(Tuple **data) {
+    // the level means nothing without the charging state, so wait for both
+    if (!data[DATA_PHONEBATTERY_LEVEL] || !data[DATA_PHONEBATTERY_CHARGING]) {
+        return;
     }
-    #endif
 
-    uint32_t config_keys[] = {
-        KEY_WEATHER,
-        KEY_SHOWSLEEP,
-        KEY_USECELSIUS,
-        KEY_ENABLEADVANCED,
-        KEY_BLUETOOTHDISCONNECT,
-        KEY_UPDATE,
-        KEY_LEADINGZERO,
-        KEY_SIMPLEMODE,
-        KEY_QUICKVIEW,
-        KEY_SHOWTAP,
-        KEY_SHOWWRIST,
-        KEY_MUTEONQUIET,
-        KEY_DATELEADINGZERO
-    };
+    int phbatt_lvl_val = (int)data[DATA_PHONEBATTERY_LEVEL]->value->int32;
+    int phbatt_chg_val = (int)data[DATA_PHONEBATTERY_CHARGING]->value->int32;
 
-    uint32_t config_flags[] = {
-        FLAG_WEATHER,
-        FLAG_SLEEP,
-        FLAG_CELSIUS,
-        FLAG_ADVANCED,
-        FLAG_BLUETOOTH,
-        FLAG_UPDATE,
-        FLAG_LEADINGZERO,
-        FLAG_SIMPLEMODE,
-        FLAG_QUICKVIEW,
-        FLAG_TAP,
-        FLAG_WRIST,
-        FLAG_MUTEONQUIET,
-        FLAG_DATELEADINGZERO
-    };
-    bool config_defaults[] = {
-        true,
-        true,
-        true,
-        true,
-        true,
-        false,
-        false,
-        true,
-        false,
-        true,
-        true,
-        false,
-        false
-    };
-    uint8_t num_configs = 13;
+    update_phonebattery_value(phbatt_lvl_val,phbatt_chg_val);
+    store_phonebattery_vals(phbatt_lvl_val, phbatt_chg_val);
+}
+#endif
 
-    // configs
-    for (int i = 0; i < num_configs; ++i) {
-        key_value = NULL; key_value = dict_find(iterator, config_keys[i]);
-        if (key_value) {
-            if (!!key_value->value->int8 == config_defaults[i]) configs += config_flags[i];
+static void handle_config_message(DictionaryIterator *iterator) {
+    // the phone only sends the settings that changed, possibly split over several
+    // messages, so everything is applied on top of the current settings and the
+    // screen is reloaded once the last chunk arrives
+    int configs = get_config_toggles();
+    bool done = false;
+    int32_t generation = 0;
+
+    for (Tuple *tuple = dict_read_first(iterator); tuple; tuple = dict_read_next(iterator)) {
+        if (tuple->key >= INBOX_KEYS) {
+            continue;
+        }
+        const struct InboxKey *entry = &inbox_keys[tuple->key];
+
+        switch (entry->type) {
+            case INBOX_TOGGLE:
+                if (!!tuple->value->int8 == config_defaults[entry->arg]) {
+                    configs |= config_flags[entry->arg];
+                } else {
+                    configs &= ~config_flags[entry->arg];
+                }
+                break;
+            case INBOX_INT:
+                set_int_setting(tuple->key, tuple->value->int8);
+                #if !defined PBL_PLATFORM_APLITE
+                if (tuple->key == KEY_TAPTIME) {
+                    timeout_sec = tuple->value->int8;
+                }
+                #endif
+                break;
+            case INBOX_INT32:
+                set_int_setting(tuple->key, tuple->value->int32);
+                break;
+            case INBOX_COLOR:
+                set_color_setting(tuple->key, tuple->value->int32);
+                break;
+            case INBOX_SLOT:
+                set_module(entry->arg & 7, tuple->value->int8, entry->arg >> 3);
+                break;
+            case INBOX_LOCATION:
+                persist_write_string(KEY_OVERRIDELOCATION, tuple->value->cstring);
+                break;
+            case INBOX_TIMEZONE:
+                if (tuple->type == TUPLE_CSTRING) {
+                    persist_write_string(tuple->key, tuple->value->cstring);
+                } else {
+                    persist_write_int(tuple->key, tuple->value->int8);
+                }
+                break;
+            case INBOX_CONFIGDONE:
+                done = true;
+                generation = tuple->value->int32;
+                break;
         }
     }
 
-    #if !defined PBL_PLATFORM_APLITE
-    uint32_t int_keys[] = {
-        KEY_FONTTYPE,
-        KEY_LOCALE,
-        KEY_DATEFORMAT,
-        KEY_TEXTALIGN,
-        KEY_SPEEDUNIT,
-        KEY_WEATHERTIME,
-        KEY_DATESEPARATOR,
-        KEY_CRYPTOTIME,
-        KEY_PHONEBATTERYTIME,
-    };
-    uint8_t num_int = 9;
-    #else
-    uint32_t int_keys[] = {
-        KEY_FONTTYPE,
-        KEY_LOCALE,
-        KEY_DATEFORMAT,
-        KEY_TEXTALIGN,
-        KEY_SPEEDUNIT,
-        KEY_WEATHERTIME,
-        KEY_DATESEPARATOR,
-    };
-    uint8_t num_int = 7;
-    #endif
-
-    // options
-    for (int i = 0; i < num_int; ++i) {
-        key_value = NULL; key_value = dict_find(iterator, int_keys[i]);
-        if (key_value) {
-            persist_write_int(int_keys[i], key_value->value->int8);
-        }
+    set_config_toggles(configs);
+    if (!done) {
+        return;
     }
 
+    save_settings();
+    set_config_generation(generation);
+    load_timezone_from_storage();
+
     #if !defined PBL_PLATFORM_APLITE
-    uint32_t color_keys[] = {
-        KEY_BGCOLOR,
-        KEY_HOURSCOLOR,
-        KEY_ALTHOURSCOLOR,
-        KEY_DATECOLOR,
-        KEY_BLUETOOTHCOLOR,
-        KEY_UPDATECOLOR,
-        KEY_BATTERYCOLOR,
-        KEY_BATTERYLOWCOLOR,
-        KEY_PHONEBATTERYCOLOR,
-        KEY_PHONEBATTERYLOWCOLOR,
-        KEY_TEMPCOLOR,
-        KEY_WEATHERCOLOR,
-        KEY_MINCOLOR,
-        KEY_MAXCOLOR,
-        KEY_WINDDIRCOLOR,
-        KEY_WINDSPEEDCOLOR,
-        KEY_COMPASSCOLOR,
-        KEY_SUNRISECOLOR,
-        KEY_SUNSETCOLOR,
-        KEY_SECONDSCOLOR,
-        KEY_ALTHOURSBCOLOR,
-        KEY_CRYPTOCOLOR,
-        KEY_CRYPTOBCOLOR,
-        KEY_CRYPTOCCOLOR,
-        KEY_CRYPTODCOLOR,
-	KEY_CUSTOMTEXTACOLOR,
-	KEY_CUSTOMTEXTBCOLOR,
-    };
-    uint8_t num_colors = 27;
-    #else
-    uint32_t color_keys[] = {
-        KEY_BGCOLOR,
-        KEY_HOURSCOLOR,
-        KEY_ALTHOURSCOLOR,
-        KEY_DATECOLOR,
-        KEY_BLUETOOTHCOLOR,
-        KEY_UPDATECOLOR,
-        KEY_BATTERYCOLOR,
-        KEY_BATTERYLOWCOLOR,
-        KEY_TEMPCOLOR,
-        KEY_WEATHERCOLOR,
-        KEY_MINCOLOR,
-        KEY_MAXCOLOR,
-        KEY_WINDDIRCOLOR,
-        KEY_WINDSPEEDCOLOR,
-        KEY_COMPASSCOLOR,
-        KEY_SUNRISECOLOR,
-        KEY_SUNSETCOLOR,
-        KEY_SECONDSCOLOR,
-    };
-    uint8_t num_colors = 18;
+    init_accel_service(watchface);
     #endif
+    #if defined PBL_COMPASS
+    init_compass_service(watchface);
+    #endif
+    reload_fonts();
+    recreate_text_layers(watchface);
+    load_screen(RELOAD_CONFIGS, watchface);
+}
 
-    // colors
-    for (int i = 0; i < num_colors; ++i) {
-        key_value = NULL; key_value = dict_find(iterator, color_keys[i]);
-        if (key_value) {
-            persist_write_int(color_keys[i], key_value->value->int32);
-        }
-    }
+static void handle_inbox_message(DictionaryIterator *iterator) {
+    // one pass to find out what kind of message this is and collect the data tuples
+    Tuple *data[NUM_DATA] = { NULL };
+    Tuple *update_tuple = NULL;
+    uint16_t types = 0;
 
-    #if defined(PBL_HEALTH)
-    // health colors
-    for (int i = 0; i < num_health_colors; ++i) {
-        key_value = NULL; key_value = dict_find(iterator, health_color_keys[i]);
-        if (key_value) {
-            persist_write_int(health_color_keys[i], key_value->value->int32);
+    for (Tuple *tuple = dict_read_first(iterator); tuple; tuple = dict_read_next(iterator)) {
+        if (tuple->key >= INBOX_KEYS) {
+            continue;
+        }
+        const struct InboxKey *entry = &inbox_keys[tuple->key];
+        types |= 1 << entry->type;
+
+        switch (entry->type) {
+            case INBOX_UPDATE:
+                update_tuple = tuple;
+                break;
+            case INBOX_WEATHER:
+            case INBOX_CUSTOMTEXT:
+            case INBOX_CRYPTO:
+            case INBOX_PHONEBATTERY:
+                data[entry->arg] = tuple;
+                break;
         }
     }
 
-    key_value = NULL; key_value = dict_find(iterator, KEY_HEARTLOW);
-    if (key_value) {
-        persist_write_int(KEY_HEARTLOW, key_value->value->int32);
+    if (types & (1 << INBOX_ERROR)) {
+        return;
     }
 
-    key_value = NULL; key_value = dict_find(iterator, KEY_HEARTHIGH);
-    if (key_value) {
-        persist_write_int(KEY_HEARTHIGH, key_value->value->int32);
- }
-    #endif
-
-    key_value = NULL; key_value = dict_find(iterator, KEY_OVERRIDELOCATION);
-    if (key_value) {
-        persist_write_string(KEY_OVERRIDELOCATION, key_value->value->cstring);
+    if (update_tuple) {
+        int update_val = update_tuple->value->int8;
+        persist_write_int(KEY_HASUPDATE, update_val);
+        notify_update(update_val);
+        return;
     }
 
-    uint32_t slot_keys[] = {
-        KEY_SLOTA,
-        KEY_SLOTB,
-        KEY_SLOTC,
-        KEY_SLOTD,
-        KEY_SLOTE,
-        KEY_SLOTF,
-    };
-    uint32_t slot_values[] = {
-        SLOT_A,
-        SLOT_B,
-        SLOT_C,
-        SLOT_D,
-        SLOT_E,
-        SLOT_F,
-    };
-    uint8_t num_slots = 6;
-
-    // slots
-    for (int i = 0; i < num_slots; ++i) {
-        key_value = NULL; key_value = dict_find(iterator, slot_keys[i]);
-        if (key_value) {
-            set_module(slot_values[i], key_value->value->int8, STATE_NORMAL);
-            persist_write_int(slot_keys[i], key_value->value->int8);
-        }
+    if (types & (1 << INBOX_WEATHER)) {
+        update_weather_from_payload(data[DATA_WEATHER]->value->data, data[DATA_WEATHER]->length);
+        return;
     }
 
     #if !defined PBL_PLATFORM_APLITE
-    // sleep slots
-    for (int i = 0; i < num_slots; ++i) {
-        key_value = NULL; key_value = dict_find(iterator, slot_sleep_keys[i]);
-        if (key_value) {
-            set_module(slot_values[i], key_value->value->int8, STATE_SLEEP);
-            persist_write_int(slot_sleep_keys[i], key_value->value->int8);
-        }
-    }
-
-    // tap slots
-    for (int i = 0; i < num_slots; ++i) {
-        key_value = NULL; key_value = dict_find(iterator, slot_tap_keys[i]);
-        if (key_value) {
-            set_module(slot_values[i], key_value->value->int8, STATE_TAP);
-            persist_write_int(slot_tap_keys[i], key_value->value->int8);
-        }
+    if (types & (1 << INBOX_CUSTOMTEXT)) {
+        handle_customtext_message(data);
+        return;
     }
 
-    // wrist slots
-    for (int i = 0; i < num_slots; ++i) {
-        key_value = NULL; key_value = dict_find(iterator, slot_wrist_keys[i]);
-        if (key_value) {
-            set_module(slot_values[i], key_value->value->int8, STATE_WRIST);
-            persist_write_int(slot_wrist_keys[i], key_value->value->int8);
-        }
+    if (types & (1 << INBOX_CRYPTO)) {
+        handle_crypto_message(data);
+        return;
     }
 
-    key_value = NULL; key_value = dict_find(iterator, KEY_TAPTIME);
-    if (key_value) {
-        timeout_sec = key_value->value->int8;
-        persist_write_int(KEY_TAPTIME, key_value->value->int8);
+    if (types & (1 << INBOX_PHONEBATTERY)) {
+        handle_phonebattery_message(data);
+        return;
     }
     #endif
 
-    persist_write_int(KEY_CONFIGS, configs);
-    set_config_toggles(configs);
-    set_timezone(tz_name, tz_hour, tz_minute);
+    handle_config_message(iterator);
+}
 
-    #if !defined PBL_PLATFORM_APLITE
-    set_timezone_b(tz_name_b, tz_hour_b, tz_minute_b);
-    init_accel_service(watchface);
-    #endif
-    #if defined PBL_COMPASS
-    init_compass_service(watchface);
-    #endif
-    reload_fonts();
-    recreate_text_layers(watchface);
-    load_screen(RELOAD_CONFIGS, watchface);
+static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
+    profile_begin(PROFILE_INBOX);
+    handle_inbox_message(iterator);
+    profile_end(PROFILE_INBOX);
 }
 
 static void inbox_dropped_callback(AppMessageResult reason, void *context) {
 }
 
 static void outbox_failed_callback(DictionaryIterator *iterator, AppMessageResult reason, void *context) {
+    outbox_failed();
 }
 
 static void outbox_sent_callback(DictionaryIterator *iterator, void *context) {
+    outbox_sent();
 }
 
 #if !defined PBL_PLATFORM_APLITE && !defined PBL_PLATFORM_CHALK
@@ -522,7 +423,7 @@ static void unobstructed_area_handle_changes() {
     GRect full_bounds = layer_get_bounds(window_layer);
     GRect bounds = layer_get_unobstructed_bounds(window_layer);
     toggle_center_slots(bounds.size.h == full_bounds.size.h);
-    recreate_text_layers(watchface);
+    layout_text_layers(watchface);
     load_screen(RELOAD_REDRAW, watchface);
 }
 
@@ -540,7 +441,7 @@ static void watchface_load(Window *window) {
 
     load_timezone_from_storage();
     #if !defined PBL_PLATFORM_APLITE
-    timeout_sec = persist_exists(KEY_TAPTIME) ? persist_read_int(KEY_TAPTIME) : 7;
+    timeout_sec = get_tap_timeout();
     #endif
 }
 
@@ -554,50 +455,8 @@ static void watchface_unload(Window *window) {
     destroy_text_layers();
 }
 
-static void request_update_from_js() {
-  int current_time = (int)time(NULL);
-  #if !defined PBL_PLATFORM_APLITE
-  bool needupdate = (is_weather_need_update() ||
-                     is_phonebattery_need_update() ||
-                     is_crypto_need_update());
-  #else
-  bool needupdate = (is_weather_need_update());
-  #endif
-  if (needupdate == true) {
-    DictionaryIterator *iter;
-    AppMessageResult result = app_message_outbox_begin(&iter);
-    if (result == APP_MSG_OK) {
-      if (is_weather_need_update()) {
-        dict_write_uint8(iter, KEY_REQUESTWEATHER, 1);
-      }
-
-      #if !defined PBL_PLATFORM_APLITE
-      if (is_phonebattery_need_update()) {
-        dict_write_uint8(iter, KEY_REQUESTPHONEBATTERY, 1);
-      }
-      if (is_crypto_need_update()) {
-        dict_write_uint8(iter, KEY_REQUESTCRYPTO, 1);
-      }
-      #endif
-      result = app_message_outbox_send();
-      if (result == APP_MSG_OK) {
-        if (is_weather_need_update()) {
-          weather_set_updatetime(current_time);
-        }
-        #if !defined PBL_PLATFORM_APLITE
-        if (is_phonebattery_need_update()) {
-          phonebattery_set_updatetime(current_time);
-        }
-        if (is_crypto_need_update()) {
-          crypto_set_updatetime(current_time);
-        }
-        #endif
-      }
-    }
-  }
-}
-
 static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+    profile_begin(PROFILE_TICK);
     if (is_module_enabled(MODULE_SECONDS)) {
         update_seconds(tick_time);
     }
@@ -621,42 +480,37 @@ static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
 
     if (units_changed & MINUTE_UNIT) {
         #if defined(PBL_HEALTH)
-        if (is_user_sleeping()) {
-            min_count++;
-            if (min_count > 90) {
-              request_update_from_js();
-              min_count = 0;
-            }
-        } else {
-          request_update_from_js();
-        }
+        run_due_tasks(is_user_sleeping());
         #else
-        request_update_from_js();
+        run_due_tasks(false);
         #endif
         if (tick_time->tm_min % 5 == 0) {
         update_time();
         }
-        if (!is_update_disabled() && tick_time->tm_hour == 4 && tick_time->tm_min == 0) { // updates at 4:00am
-            check_for_updates();
-        }
 
         #if defined(PBL_HEALTH)
         if (!tap_mode_visible() && !wrist_mode_visible()) {
             show_sleep_data_if_visible(watchface);
         }
-
-        if (
-            ((tick_time->tm_min % 2 == 0 || is_module_enabled(MODULE_HEART)) && !is_user_sleeping()) || // check for health updates only every 2 minutes (or 1 min if heart rate is enabled)
-            (is_user_sleeping() && tick_time->tm_min == 0)
-        ) {
-            get_health_data();
-        }
         #endif
     }
+    profile_end(PROFILE_TICK);
 }
 
+#if defined TIMEBOXED_CANVAS
+static void app_did_focus(bool in_focus) {
+    // whatever covered the face may have drawn over the framebuffer
+    if (in_focus) {
+        redraw_text_layers();
+    }
+}
+#endif
+
 static void init(void) {
-    tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
+    profile_reset();
+    load_settings();
+    init_scheduler();
+    init_tick_service(tick_handler);
 
     #if defined(PBL_HEALTH)
     init_sleep_data();
@@ -680,6 +534,12 @@ static void init(void) {
 
     battery_state_service_subscribe(battery_handler);
 
+    #if defined TIMEBOXED_CANVAS
+    app_focus_service_subscribe_handlers((AppFocusHandlers) {
+        .did_focus = app_did_focus,
+    });
+    #endif
+
     window_stack_push(watchface, true);
 
     #if !defined PBL_PLATFORM_APLITE && !defined PBL_PLATFORM_CHALK
@@ -705,11 +565,16 @@ static void init(void) {
         .pebble_app_connection_handler = bt_handler
     });
 
+    // tell the phone which config the watch holds, in case it has to resend it
+    outbox_request(KEY_CONFIGDONE);
+    outbox_flush();
+
     load_screen(RELOAD_DEFAULT, watchface);
     notify_update(false);
 }
 
 static void deinit(void) {
+    profile_dump();
     window_destroy(watchface);
 }
 
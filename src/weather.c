@@ -3,14 +3,37 @@
 #include "text.h"
 #include "configs.h"
 #include "clock.h"
+#include "scheduler.h"
 
 static bool weather_enabled;
-static bool force_update = false;
 static bool use_celsius;
-static int last_update = 0;
 static int last_successful_update = 0;
 static int weather_interval = 30;
 
+// packed weather message from the phone, little endian:
+// version, condition, temp, max, min, speed, direction (int16), sunrise, sunset (int32)
+#define WEATHER_PAYLOAD_VERSION 1
+#define WEATHER_PAYLOAD_SIZE 20
+
+// layout of the record stored under KEY_WEATHERDATA, bump on any change
+#define WEATHER_DATA_VERSION 1
+
+struct WeatherData {
+    uint8_t version;
+    int16_t temp;
+    int16_t max;
+    int16_t min;
+    int16_t speed;
+    int16_t direction;
+    uint8_t condition;
+    int32_t sunrise;
+    int32_t sunset;
+    int32_t updated;
+};
+
+static struct WeatherData weather;
+static bool weather_loaded;
+
 static char* weather_conditions[] = {
     "\U0000F07B", // 'unknown': 0,
     "\U0000F00D", // 'clear': 1,
@@ -72,28 +95,7 @@ void update_expired_weather(int current_time) {
   else if(current_time - last_successful_update >= stale_weather_threshold * 60)
     set_weather_layer_color(GColorFromHEX(0xFF5500));
   else
-    set_weather_layer_color(GColorFromHEX(persist_read_int(KEY_TEMPCOLOR)));
-}
-
-void update_weather(bool force) {
-    int current_time = (int)time(NULL);
-    if (force || last_update == 0 || (current_time - last_update) >= weather_interval * 60) {
-        DictionaryIterator *iter;
-        AppMessageResult result = app_message_outbox_begin(&iter);
-        if (result == APP_MSG_OK) {
-            dict_write_uint8(iter, KEY_REQUESTWEATHER, 1);
-            result = app_message_outbox_send();
-
-            if (result == APP_MSG_OK) {
-                last_update = current_time;
-            }
-        }
-    }
-    // If we're on a color screen, color stale weather using hard-coded colors.
-    // TODO: Make these colors and the times to show them configurable.
-#if defined(PBL_COLOR)
-    update_expired_weather(current_time);
-#endif
+    set_weather_layer_color(get_color(COLOR_TEMP));
 }
 
 char* get_wind_direction_text(int degrees) {
@@ -281,29 +283,67 @@ static bool get_weather_enabled() {
     return is_weather_toggle_enabled() || weather_module_available;
 }
 
-static void update_weather_from_storage() {
-    if (persist_exists(KEY_TEMP)) {
-        update_weather_values(persist_read_int(KEY_TEMP), persist_read_int(KEY_WEATHER));
+static uint8_t get_condition(int condition) {
+    // conditions this build has no icon for show as unknown
+    if (condition < 0 || condition >= (int)ARRAY_LENGTH(weather_conditions)) {
+        return 0;
     }
+    return condition;
+}
 
-    if (persist_exists(KEY_MIN)) {
-        update_forecast_values(persist_read_int(KEY_MAX), persist_read_int(KEY_MIN));
-    }
+static void save_weather() {
+    weather.version = WEATHER_DATA_VERSION;
+    persist_write_data(KEY_WEATHERDATA, &weather, sizeof(weather));
+}
 
-    if (persist_exists(KEY_SPEED)) {
-        update_wind_values(persist_read_int(KEY_SPEED), persist_read_int(KEY_DIRECTION));
-    }
+static void show_weather(struct WeatherData *data) {
+    update_weather_values(data->temp, data->condition);
+    update_forecast_values(data->max, data->min);
+    update_wind_values(data->speed, data->direction);
+    update_sunrise(data->sunrise);
+    update_sunset(data->sunset);
+}
 
-    if (persist_exists(KEY_SUNRISE)) {
-        update_sunrise(persist_read_int(KEY_SUNRISE));
-    }
+static void load_legacy_weather() {
+    weather.temp = persist_read_int(KEY_TEMP);
+    weather.max = persist_read_int(KEY_MAX);
+    weather.min = persist_read_int(KEY_MIN);
+    weather.condition = get_condition(persist_read_int(KEY_WEATHER));
+    weather.speed = persist_read_int(KEY_SPEED);
+    weather.direction = persist_read_int(KEY_DIRECTION);
+    weather.sunrise = persist_read_int(KEY_SUNRISE);
+    weather.sunset = persist_read_int(KEY_SUNSET);
+    weather.updated = persist_read_int(KEY_WEATHER_LAST_UPDATED);
+
+    save_weather();
+    persist_delete(KEY_TEMP);
+    persist_delete(KEY_MAX);
+    persist_delete(KEY_MIN);
+    persist_delete(KEY_WEATHER);
+    persist_delete(KEY_SPEED);
+    persist_delete(KEY_DIRECTION);
+    persist_delete(KEY_SUNRISE);
+    persist_delete(KEY_SUNSET);
+    persist_delete(KEY_WEATHER_LAST_UPDATED);
+}
 
-    if (persist_exists(KEY_SUNSET)) {
-        update_sunset(persist_read_int(KEY_SUNSET));
+static void update_weather_from_storage() {
+    if (!weather_loaded) {
+        // a record from another build or a partial write is dropped, the next
+        // request fills it again
+        if (persist_exists(KEY_WEATHERDATA) &&
+            persist_read_data(KEY_WEATHERDATA, &weather, sizeof(weather)) == sizeof(weather) &&
+            weather.version == WEATHER_DATA_VERSION) {
+            weather_loaded = true;
+        } else if (persist_exists(KEY_TEMP)) {
+            load_legacy_weather();
+            weather_loaded = true;
+        }
     }
 
-    if (persist_exists(KEY_WEATHER_LAST_UPDATED)) {
-      last_successful_update = persist_read_int(KEY_WEATHER_LAST_UPDATED);
+    if (weather_loaded) {
+        show_weather(&weather);
+        last_successful_update = weather.updated;
     }
     update_expired_weather(0);
 }
@@ -311,13 +351,14 @@ static void update_weather_from_storage() {
 void toggle_weather(uint8_t reload_origin) {
     weather_enabled = get_weather_enabled();
     if (reload_origin == RELOAD_CONFIGS || reload_origin == RELOAD_DEFAULT) {
-        weather_interval = persist_exists(KEY_WEATHERTIME) ? persist_read_int(KEY_WEATHERTIME) : 30;
+        weather_interval = get_weather_interval();
     }
+    set_task(TASK_WEATHER, weather_enabled, weather_interval * SECONDS_PER_MINUTE);
     if (weather_enabled) {
         use_celsius = is_use_celsius_enabled();
         update_weather_from_storage();
         if (reload_origin == RELOAD_MODULE || reload_origin == RELOAD_CONFIGS) {
-          force_update = true;
+            force_task(TASK_WEATHER);
         }
     } else {
         set_temp_cur_layer_text("");
@@ -335,27 +376,32 @@ void toggle_weather(uint8_t reload_origin) {
     }
 }
 
-void store_weather_values(int temp, int max, int min, int weather, int speed, int direction, int sunrise, int sunset) {
-    persist_write_int(KEY_TEMP, temp);
-    persist_write_int(KEY_MAX, max);
-    persist_write_int(KEY_MIN, min);
-    persist_write_int(KEY_WEATHER, weather);
-    persist_write_int(KEY_SPEED, speed);
-    persist_write_int(KEY_DIRECTION, direction);
-    persist_write_int(KEY_SUNRISE, sunrise);
-    persist_write_int(KEY_SUNSET, sunset);
-    last_successful_update = (int)time(NULL);
-    persist_write_int(KEY_WEATHER_LAST_UPDATED, last_successful_update);
-    update_expired_weather(0);
+static int16_t read_int16(const uint8_t *bytes) {
+    return (int16_t)(bytes[0] | bytes[1] << 8);
 }
 
-bool is_weather_need_update() {
-    int current_time = (int)time(NULL);
-    bool fup = force_update;
-    force_update = false;
-    return (weather_enabled && (fup || last_update == 0 || (current_time - last_update) >= weather_interval * 60));
+static int32_t read_int32(const uint8_t *bytes) {
+    return (int32_t)((uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24);
 }
 
-void weather_set_updatetime(int updtime) {
-  last_update = updtime;
+void update_weather_from_payload(const uint8_t *bytes, uint16_t length) {
+    if (length < WEATHER_PAYLOAD_SIZE || bytes[0] != WEATHER_PAYLOAD_VERSION) {
+        return;
+    }
+
+    weather.condition = get_condition(bytes[1]);
+    weather.temp = read_int16(bytes + 2);
+    weather.max = read_int16(bytes + 4);
+    weather.min = read_int16(bytes + 6);
+    weather.speed = read_int16(bytes + 8);
+    weather.direction = read_int16(bytes + 10);
+    weather.sunrise = read_int32(bytes + 12);
+    weather.sunset = read_int32(bytes + 16);
+    weather.updated = (int32_t)time(NULL);
+    weather_loaded = true;
+
+    show_weather(&weather);
+    save_weather();
+    last_successful_update = weather.updated;
+    update_expired_weather(0);
 }
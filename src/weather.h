@@ -3,15 +3,13 @@
 
 #include <pebble.h>
 
-void weather_set_updatetime(int updtime);
 void update_weather_values(int temp_val, int weather_val);
 void update_forecast_values(int max_val, int min_val);
 void update_wind_values(int speed, int direction);
 void update_sunrise(int sunrise);
 void update_sunset(int sunset);
-void store_weather_values(int temp_val, int max_val, int min_val, int weather_val, int speed_val, int direction_val, int sunrise_val, int sunset_val);
+void update_weather_from_payload(const uint8_t *bytes, uint16_t length);
 void toggle_weather(uint8_t reload_origin);
-bool is_weather_need_update();
 char* get_wind_direction(int degrees);
 char* get_wind_direction_text(int degrees);
 
@@ -0,0 +1,46 @@
+#!/bin/sh
+# replays the same day with the canvas renderer drawing the hours as text and
+# as digits from the atlas, and prints what drawing cost in each.
+#
+#   ./atlas_bench.sh [make options]
+#   ./atlas_bench.sh PLATFORM=aplite
+set -e
+
+RUNS=15
+
+cd "$(dirname "$0")"
+
+# the run with the median render time; the rest of each report is the same
+# in every run
+bench() {
+    make --no-print-directory "$@" PROFILE=1 all > /dev/null
+    build=$(make --no-print-directory -s "$@" PROFILE=1 print-build)
+    for run in $(seq $RUNS); do
+        "$build/day" -v > "$build/bench-$run.txt" 2>&1
+        echo "$(awk '$1 == "render" { print $3 }' "$build/bench-$run.txt") $run"
+    done | sort -n | awk -v middle=$(((RUNS + 1) / 2)) 'NR == middle { print $2 }' > "$build/median.txt"
+    cp "$build/bench-$(cat "$build/median.txt").txt" "$build/median-run.txt"
+    awk '
+        $1 == "render" { frames = $2; ms = $3; max = $5 }
+        $1 == "profile:" && $2 == "hours" { hours = $3; hours_heap = $7 }
+        /^draw calls/ { text = $6 + 0; bitmap = $8 }
+        /^pixels painted/ { pixels = $3 }
+        /^heap allocations/ { allocs = $3; peak = $7 }
+        /^font loads/ { fonts = $3 }
+        /fonts resident/ { resident = $4 }
+        END {
+            printf "%d %.3f %.2f %.2f %d %d %d %d %d %d %d %d %d\n", frames, ms, ms * 1000 / frames, max,
+                hours, text, bitmap, pixels, allocs, peak, hours_heap, fonts, resident
+        }' "$build/median-run.txt"
+}
+
+text=$(bench "$@" CANVAS=1)
+atlas=$(bench "$@" ATLAS=1)
+
+echo "$text $atlas" | awk '{
+    split("frames,render ms,render us per frame,slowest frame us,hours redrawn,text draws,bitmap draws,pixels painted,heap allocations,heap peak bytes,hours heap bytes,font loads,fonts resident bytes", names, ",")
+    printf "%-22s %12s %12s\n", "", "text", "atlas"
+    for (i = 1; i <= 13; ++i) {
+        printf "%-22s %12s %12s\n", names[i], $i, $(i + 13)
+    }
+}'
@@ -0,0 +1,36 @@
+#!/bin/sh
+# replays the same day on another revision of src/ and on the working tree
+# and diffs the two reports.
+#
+#   ./compare.sh <revision> [make options]
+#   ./compare.sh 068745b PLATFORM=aplite
+set -e
+
+if [ -z "$1" ]; then
+    echo "usage: $0 <revision> [make options]" >&2
+    exit 1
+fi
+rev=$1
+shift
+
+cd "$(dirname "$0")"
+root=$(git rev-parse --show-toplevel)
+name=$(git rev-parse --short "$rev")
+tree=build/rev-$name
+rm -rf "$tree"
+mkdir -p "$tree"
+git -C "$root" archive "$rev" src | tar -x -C "$tree"
+
+# revisions before the packed weather payload expect the per-key tuples
+extra=
+if ! grep -q update_weather_from_payload "$tree/src/weather.h"; then
+    extra=-DHOST_LEGACY_WEATHER
+fi
+
+make --no-print-directory SRC="$tree/src" BUILD="$tree/out" EXTRA="$extra" "$@" "$tree/out/day" > /dev/null
+make --no-print-directory "$@" > /dev/null
+current=$(make --no-print-directory -s "$@" print-build)
+
+"$tree/out/day" > "$tree/before.txt"
+"$current/day" > "$tree/after.txt"
+diff -u --label "$name" --label "working tree" "$tree/before.txt" "$tree/after.txt" || true
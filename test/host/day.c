@@ -0,0 +1,123 @@
+// replays a day on the simulated watch: minute ticks, health updates, phone
+// requests, a battery that drains and charges, a bluetooth drop and a few
+// wrist taps, then prints what every handler cost
+
+#include <pebble.h>
+#include <getopt.h>
+#include "keys.h"
+#include "host.h"
+#include "phone.h"
+#include "scenario.h"
+
+#define MINUTE_MS (60 * 1000ULL)
+#define HOUR_MS (60 * MINUTE_MS)
+
+int watchface_main(void);
+
+static uint64_t started_ms;
+static uint32_t replay_minutes = 24 * 60;
+
+static void drain_battery(void *data) {
+    uint64_t minute = (host_now_ms() - started_ms) / MINUTE_MS;
+    uint64_t hour = minute / 60;
+    // charge for an hour in the evening, drain a percent every 20 minutes otherwise
+    bool charging = hour == 19;
+    uint8_t percent = battery_state_service_peek().charge_percent;
+    if (charging && percent < 100) {
+        percent += 1;
+    } else if (!charging && minute % 20 == 0 && percent > 5) {
+        percent -= 1;
+    }
+    host_set_battery(percent, charging);
+    host_schedule(host_now_ms() + MINUTE_MS, drain_battery, NULL);
+}
+
+static void set_connected(void *data) {
+    host_set_connected(data != NULL);
+}
+
+static uint64_t tap_at_ms;
+
+static void tap(void *data) {
+    tap_at_ms = host_now_ms();
+}
+
+static void fill_accel(AccelData *data, uint32_t num_samples, uint64_t at_ms) {
+    // a flick of the wrist: a spike up, one down and back to rest
+    if (!tap_at_ms || tap_at_ms > at_ms || num_samples < 8) {
+        return;
+    }
+    data[2].z += 400;
+    data[3].z -= 400;
+    tap_at_ms = 0;
+}
+
+static void replay(void) {
+    started_ms = host_now_ms();
+    host_schedule(started_ms + MINUTE_MS, drain_battery, NULL);
+    host_schedule(started_ms + 13 * HOUR_MS, set_connected, NULL);
+    host_schedule(started_ms + 13 * HOUR_MS + 20 * MINUTE_MS, set_connected, (void *)1);
+    for (int hour = 8; hour < 22; hour += 2) {
+        host_schedule(started_ms + hour * HOUR_MS + 17 * MINUTE_MS, tap, NULL);
+    }
+    host_run_until(started_ms + replay_minutes * MINUTE_MS);
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-m minutes] [-l launches] [-f] [-v]\n", name);
+    fprintf(stderr, "  -m  minutes to replay, a full day by default\n");
+    fprintf(stderr, "  -l  launch the watchface this many times, reporting the last one\n");
+    fprintf(stderr, "  -f  start from a fresh install instead of a configured watch\n");
+    fprintf(stderr, "  -v  show the app's log\n");
+}
+
+int main(int argc, char **argv) {
+    bool fresh = false;
+    int launches = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:l:fv")) != -1) {
+        switch (opt) {
+            case 'm':
+                replay_minutes = atoi(optarg);
+                break;
+            case 'l':
+                launches = atoi(optarg);
+                break;
+            case 'f':
+                fresh = true;
+                break;
+            case 'v':
+                host_log_level = APP_LOG_LEVEL_DEBUG;
+                break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    setenv("TZ", "UTC", 1);
+    tzset();
+    host_set_time(SCENARIO_START);
+    host_set_battery(90, false);
+    host_set_phone(phone_on_message);
+    host_set_accel_source(fill_accel);
+    if (!fresh) {
+        scenario_seed_config();
+    }
+
+    host_set_event_loop(replay);
+    for (int i = 0; i < launches; ++i) {
+        // storage carries over, the counters only cover the last launch
+        host_reset_stats();
+        host_handler_begin(HOST_INIT);
+        watchface_main();
+        host_handler_end(HOST_DEINIT);
+    }
+
+    printf("replayed %u minutes on %s, launch %d\n\n", replay_minutes, SCENARIO_PLATFORM, launches);
+    host_report(stdout, replay_minutes);
+    printf("phone requests: weather %u, crypto %u, battery %u, config reports %u\n",
+            phone_request_count(PHONE_WEATHER), phone_request_count(PHONE_CRYPTO), phone_request_count(PHONE_BATTERY),
+            phone_request_count(PHONE_CONFIG));
+    return 0;
+}
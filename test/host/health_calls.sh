@@ -0,0 +1,32 @@
+#!/bin/sh
+# replays the same day on another revision of src/ and on the working tree
+# and prints the health api calls of each hour side by side.
+#
+#   ./health_calls.sh <revision> [make options]
+#   ./health_calls.sh d201181^ PLATFORM=diorite
+set -e
+
+if [ -z "$1" ]; then
+    echo "usage: $0 <revision> [make options]" >&2
+    exit 1
+fi
+
+cd "$(dirname "$0")"
+name=$(git rev-parse --short "$1")
+./compare.sh "$@" > /dev/null
+tree=build/rev-$name
+
+hourly() {
+    grep '^health api calls by hour' "$1" | cut -d: -f2
+}
+
+echo "$(hourly "$tree/before.txt")" "$(hourly "$tree/after.txt")" | awk -v name="$name" '{
+    printf "%-6s %10s %12s\n", "hour", name, "working tree"
+    for (hour = 0; hour < 24; ++hour) {
+        before += $(hour + 1)
+        after += $(hour + 25)
+        printf "%02d     %10d %12d\n", hour, $(hour + 1), $(hour + 25)
+    }
+    printf "%-6s %10d %12d\n", "day", before, after
+    printf "%-6s %10.1f %12.1f\n", "hourly", before / 24, after / 24
+}'
@@ -0,0 +1,106 @@
+#ifndef __TIMEBOXED_HOST_
+#define __TIMEBOXED_HOST_
+
+#include <pebble.h>
+
+// what the fake SDK attributes time and allocations to
+#define HOST_INIT 0
+#define HOST_DEINIT 1
+#define HOST_TICK 2
+#define HOST_TIMER 3
+#define HOST_INBOX 4
+#define HOST_OUTBOX_SENT 5
+#define HOST_OUTBOX_FAILED 6
+#define HOST_BATTERY 7
+#define HOST_CONNECTION 8
+#define HOST_ACCEL 9
+#define HOST_TAP 10
+#define HOST_HEALTH 11
+#define HOST_COMPASS 12
+#define HOST_FOCUS 13
+#define HOST_UNOBSTRUCTED 14
+#define HOST_RENDER 15
+#define HOST_HANDLERS 16
+
+struct HostHandlerStats {
+    uint32_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint32_t allocs;
+    int32_t heap_delta;
+};
+
+struct HostCounters {
+    uint32_t persist_reads;
+    uint32_t persist_writes;
+    uint32_t persist_bytes_written;
+    uint32_t text_updates;
+    uint32_t dirty_marks;
+    uint32_t frames;
+    uint64_t pixels;
+    uint32_t fill_rects;
+    uint32_t text_draws;
+    uint32_t bitmap_draws;
+    uint32_t font_loads;
+    uint32_t outbox_sends;
+    uint32_t outbox_bytes;
+    uint32_t inbox_messages;
+    uint32_t inbox_bytes;
+    uint32_t health_calls;
+    uint32_t health_sum_calls;
+    uint32_t health_average_calls;
+    uint32_t health_hour_calls[24];
+    uint32_t vibrations;
+    uint32_t allocs;
+};
+
+extern struct HostHandlerStats host_handlers[HOST_HANDLERS];
+extern struct HostCounters host_counters;
+extern uint8_t host_log_level;
+
+// simulated clock, in milliseconds since the epoch
+void host_set_time(time_t seconds);
+uint64_t host_now_ms(void);
+
+// the driver supplies the event loop the app blocks in
+void host_set_event_loop(void (*event_loop)(void));
+void host_run_until(uint64_t end_ms);
+void host_schedule(uint64_t at_ms, void (*callback)(void *data), void *data);
+
+// handler accounting for anything the driver calls into directly
+void host_handler_begin(uint8_t handler);
+void host_handler_end(uint8_t handler);
+void host_reset_stats(void);
+
+// device state
+void host_set_battery(uint8_t percent, bool charging);
+void host_set_connected(bool connected);
+void host_set_quiet_time(bool active);
+void host_set_health_permission(bool granted);
+void host_emit_tap(AccelAxisType axis, int32_t direction);
+void host_emit_compass(int32_t heading);
+void host_emit_focus(bool in_focus);
+void host_set_accel_source(void (*fill)(AccelData *data, uint32_t num_samples, uint64_t at_ms));
+bool host_accel_subscribed(void);
+
+// phone side of the message link
+void host_set_phone(void (*on_message)(DictionaryIterator *iter));
+void host_dict_init(DictionaryIterator *iter, uint8_t *buffer, size_t size);
+size_t host_dict_size(const DictionaryIterator *iter);
+void host_deliver_inbox(uint32_t delay_ms, const uint8_t *buffer, size_t size);
+
+// storage
+void host_persist_clear(void);
+size_t host_heap_limit(void);
+size_t host_heap_peak(void);
+
+// screen
+GSize host_screen_size(void);
+GBitmap *host_frame_buffer(void);
+GContext *host_screen_context(void);
+void host_render(void);
+uint8_t host_pixel(int16_t x, int16_t y);
+
+void host_report(FILE *out, double minutes);
+
+#endif
@@ -0,0 +1,81 @@
+// the module lookups in src/configs.c from before the slot index (fc53e90),
+// kept so lookup_bench can time the two; they read the settings of the
+// configs.c they are included after
+
+#if !defined PBL_PLATFORM_APLITE
+static uint8_t* get_visible_modules() {
+    struct Settings *current = get_settings();
+    if (tap_mode_visible()) {
+        return current->modules[STATE_TAP];
+    } else if (wrist_mode_visible()) {
+        return current->modules[STATE_WRIST];
+    } else if (should_show_sleep_data()) {
+        return current->modules[STATE_SLEEP];
+    }
+    return current->modules[STATE_NORMAL];
+}
+
+bool is_module_enabled_any(int module) {
+    uint8_t (*modules)[6] = get_settings()->modules;
+    for (unsigned int i = 0; i < 6; ++i) {
+        if (modules[STATE_NORMAL][i] == module ||
+            modules[STATE_TAP][i] == module ||
+            modules[STATE_WRIST][i] == module ||
+            modules[STATE_SLEEP][i] == module) {
+            return i <= 3 || (i > 3 && center_slots_enabled);
+        }
+    }
+    return false;
+}
+
+bool is_module_configured(int module) {
+    uint8_t (*modules)[6] = get_settings()->modules;
+    for (unsigned int i = 0; i < 6; ++i) {
+        if (modules[STATE_NORMAL][i] == module ||
+            modules[STATE_TAP][i] == module ||
+            modules[STATE_WRIST][i] == module ||
+            modules[STATE_SLEEP][i] == module) {
+            return true;
+        }
+    }
+    return false;
+}
+#else
+static uint8_t* get_visible_modules() {
+    return get_settings()->modules[STATE_NORMAL];
+}
+
+bool is_module_enabled_any(int module) {
+    return is_module_enabled(module);
+}
+
+bool is_module_configured(int module) {
+    uint8_t *modules = get_settings()->modules[STATE_NORMAL];
+    for (unsigned int i = 0; i < 6; ++i) {
+        if (modules[i] == module) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+bool is_module_enabled(int module) {
+    uint8_t *modules = get_visible_modules();
+    for (unsigned int i = 0; i < 6; ++i) {
+        if (modules[i] == module) {
+            return i <= 3 || (i > 3 && center_slots_enabled);
+        }
+    }
+    return false;
+}
+
+int get_slot_for_module(int module) {
+    uint8_t *modules = get_visible_modules();
+    for (unsigned int i = 0; i < 6; ++i) {
+        if (modules[i] == module) {
+            return i;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,178 @@
+// counts the module lookups the face makes while it replays a day, then times
+// the same lookups through the slot index in src/configs.c and through the
+// slot scans it replaced (legacy/lookups.c). both have to give the same
+// answer for every lookup.
+//
+// the lookups are caught with the linker's --wrap, so only the calls from
+// outside configs.c are seen.
+
+#include <pebble.h>
+#include <time.h>
+#include "keys.h"
+#include "host.h"
+#include "phone.h"
+#include "scenario.h"
+#include "lookups.h"
+
+#define MINUTE_MS (60 * 1000ULL)
+#define REPEATS 200
+
+#define LOOKUP_ENABLED 0
+#define LOOKUP_ENABLED_ANY 1
+#define LOOKUP_CONFIGURED 2
+#define LOOKUP_SLOT 3
+#define LOOKUP_KINDS 4
+
+struct Lookup {
+    uint8_t kind;
+    int8_t module;
+};
+
+int watchface_main(void);
+
+bool __real_is_module_enabled(int module);
+bool __real_is_module_enabled_any(int module);
+bool __real_is_module_configured(int module);
+int __real_get_slot_for_module(int module);
+
+static const char *kind_names[LOOKUP_KINDS] = {
+    "is_module_enabled", "is_module_enabled_any", "is_module_configured", "get_slot_for_module",
+};
+
+static struct Lookup *lookups;
+static uint32_t num_lookups;
+static uint32_t max_lookups;
+static uint32_t kind_counts[LOOKUP_KINDS];
+static bool recording = true;
+static uint32_t replay_minutes = 24 * 60;
+
+static void record(uint8_t kind, int module) {
+    if (!recording) {
+        return;
+    }
+    if (num_lookups == max_lookups) {
+        max_lookups = max_lookups ? max_lookups * 2 : 4096;
+        lookups = realloc(lookups, max_lookups * sizeof(*lookups));
+    }
+    lookups[num_lookups++] = (struct Lookup) { kind, module };
+    kind_counts[kind]++;
+}
+
+bool __wrap_is_module_enabled(int module) {
+    record(LOOKUP_ENABLED, module);
+    return __real_is_module_enabled(module);
+}
+
+bool __wrap_is_module_enabled_any(int module) {
+    record(LOOKUP_ENABLED_ANY, module);
+    return __real_is_module_enabled_any(module);
+}
+
+bool __wrap_is_module_configured(int module) {
+    record(LOOKUP_CONFIGURED, module);
+    return __real_is_module_configured(module);
+}
+
+int __wrap_get_slot_for_module(int module) {
+    record(LOOKUP_SLOT, module);
+    return __real_get_slot_for_module(module);
+}
+
+static int current_lookup(struct Lookup *lookup) {
+    switch (lookup->kind) {
+        case LOOKUP_ENABLED:
+            return __real_is_module_enabled(lookup->module);
+        case LOOKUP_ENABLED_ANY:
+            return __real_is_module_enabled_any(lookup->module);
+        case LOOKUP_CONFIGURED:
+            return __real_is_module_configured(lookup->module);
+    }
+    return __real_get_slot_for_module(lookup->module);
+}
+
+static int legacy_lookup(struct Lookup *lookup) {
+    switch (lookup->kind) {
+        case LOOKUP_ENABLED:
+            return legacy_is_module_enabled(lookup->module);
+        case LOOKUP_ENABLED_ANY:
+            return legacy_is_module_enabled_any(lookup->module);
+        case LOOKUP_CONFIGURED:
+            return legacy_is_module_configured(lookup->module);
+    }
+    return legacy_get_slot_for_module(lookup->module);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+// runs every recorded lookup REPEATS times and returns the nanoseconds per run
+static double time_lookups(int (*lookup)(struct Lookup *lookup)) {
+    volatile int sink = 0;
+    uint64_t started = now_ns();
+    for (int r = 0; r < REPEATS; ++r) {
+        for (uint32_t i = 0; i < num_lookups; ++i) {
+            sink += lookup(&lookups[i]);
+        }
+    }
+    return (double)(now_ns() - started) / REPEATS;
+}
+
+static int check_lookups(void) {
+    for (uint32_t i = 0; i < num_lookups; ++i) {
+        int now = current_lookup(&lookups[i]), before = legacy_lookup(&lookups[i]);
+        if (now != before) {
+            fprintf(stderr, "%s(%d) is %d but was %d before\n",
+                    kind_names[lookups[i].kind], lookups[i].module, now, before);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int result;
+
+static void replay(void) {
+    host_run_until(host_now_ms() + replay_minutes * MINUTE_MS);
+    recording = false;
+
+    // the face is still up here, with the settings and state it ended the day in
+    uint32_t frames = host_counters.frames ? host_counters.frames : 1;
+    printf("replayed %u minutes on %s: %u frames, %u module lookups, %.1f per frame\n",
+            replay_minutes, SCENARIO_PLATFORM, host_counters.frames, num_lookups, (double)num_lookups / frames);
+    for (int kind = 0; kind < LOOKUP_KINDS; ++kind) {
+        printf("  %-22s %7u\n", kind_names[kind], kind_counts[kind]);
+    }
+    if (check_lookups()) {
+        result = 1;
+        return;
+    }
+
+    double before_ns = time_lookups(legacy_lookup);
+    double now_ns = time_lookups(current_lookup);
+    printf("\n%-10s %12s %12s\n", "lookups", "ns per day", "ns per frame");
+    printf("%-10s %12.0f %12.1f\n", "scan", before_ns, before_ns / frames);
+    printf("%-10s %12.0f %12.1f\n", "index", now_ns, now_ns / frames);
+    printf("\nthe index and the scans agree on all %u lookups\n", num_lookups);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        replay_minutes = atoi(argv[1]);
+    }
+
+    setenv("TZ", "UTC", 1);
+    tzset();
+    host_set_time(SCENARIO_START);
+    host_set_battery(90, false);
+    host_set_phone(phone_on_message);
+    scenario_seed_config();
+
+    host_set_event_loop(replay);
+    host_reset_stats();
+    watchface_main();
+    free(lookups);
+    return result;
+}
@@ -0,0 +1,12 @@
+#ifndef __TIMEBOXED_HOST_LOOKUPS_
+#define __TIMEBOXED_HOST_LOOKUPS_
+
+#include <pebble.h>
+
+// the module lookups from before the slot index, over the current settings
+bool legacy_is_module_enabled(int module);
+bool legacy_is_module_enabled_any(int module);
+bool legacy_is_module_configured(int module);
+int legacy_get_slot_for_module(int module);
+
+#endif
@@ -0,0 +1,11 @@
+// src/configs.c with the old module lookups built next to it, so both read
+// the same settings
+
+#include "lookups.h"
+#include "configs.c"
+
+#define is_module_enabled legacy_is_module_enabled
+#define is_module_enabled_any legacy_is_module_enabled_any
+#define is_module_configured legacy_is_module_configured
+#define get_slot_for_module legacy_get_slot_for_module
+#include "legacy/lookups.c"
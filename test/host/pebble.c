@@ -0,0 +1,2026 @@
+// fake Pebble services for the host build. everything runs on a simulated
+// clock; the driver decides what happens and when, see day.c
+
+#define HOST_SDK_IMPL
+#include <pebble.h>
+#include <stdarg.h>
+#include "host.h"
+
+#define NS_PER_SECOND 1000000000ULL
+
+struct HostHandlerStats host_handlers[HOST_HANDLERS];
+struct HostCounters host_counters;
+uint8_t host_log_level = APP_LOG_LEVEL_WARNING;
+
+void host_log(uint8_t level, const char *fmt, ...) {
+    if (level > host_log_level) {
+        return;
+    }
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+// clock
+
+static uint64_t clock_ms;
+
+void host_set_time(time_t seconds) {
+    clock_ms = (uint64_t)seconds * 1000;
+}
+
+uint64_t host_now_ms(void) {
+    return clock_ms;
+}
+
+time_t host_time(time_t *tloc) {
+    time_t now = (time_t)(clock_ms / 1000);
+    if (tloc) {
+        *tloc = now;
+    }
+    return now;
+}
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+    uint16_t millis = clock_ms % 1000;
+    host_time(tloc);
+    if (out_ms) {
+        *out_ms = millis;
+    }
+    return millis;
+}
+
+time_t time_start_of_today(void) {
+    time_t now = host_time(NULL);
+    struct tm *local = localtime(&now);
+    local->tm_hour = 0;
+    local->tm_min = 0;
+    local->tm_sec = 0;
+    return mktime(local);
+}
+
+bool clock_is_24h_style(void) {
+    return true;
+}
+
+// heap: the app heap is modelled with the platform's size so running out of
+// memory behaves like it would on the watch
+
+#if defined PBL_PLATFORM_APLITE
+#define HEAP_LIMIT (24 * 1024)
+#else
+#define HEAP_LIMIT (64 * 1024)
+#endif
+
+// rough firmware sizes for the objects the SDK allocates on the app heap
+#define LAYER_BYTES 44
+#define TEXT_LAYER_BYTES 72
+#define WINDOW_BYTES 112
+#define TIMER_BYTES 28
+#define BITMAP_BYTES 24
+#define FONT_BYTES 128
+
+struct HeapBlock {
+    size_t size;
+    size_t charged;
+};
+
+static size_t heap_used;
+static size_t heap_peak;
+static int current_handler = -1;
+
+static void *heap_alloc(size_t size, size_t charged) {
+    if (heap_used + charged > HEAP_LIMIT) {
+        return NULL;
+    }
+    struct HeapBlock *block = calloc(1, sizeof(struct HeapBlock) + size);
+    block->size = size;
+    block->charged = charged;
+    heap_used += charged;
+    if (heap_used > heap_peak) {
+        heap_peak = heap_used;
+    }
+    host_counters.allocs++;
+    if (current_handler >= 0) {
+        host_handlers[current_handler].allocs++;
+    }
+    return block + 1;
+}
+
+static void heap_release(void *ptr) {
+    if (!ptr) {
+        return;
+    }
+    struct HeapBlock *block = (struct HeapBlock *)ptr - 1;
+    heap_used -= block->charged;
+    free(block);
+}
+
+void *host_malloc(size_t size) {
+    // the firmware allocator rounds up to 4 bytes and keeps a small header
+    return heap_alloc(size, ((size + 3) & ~(size_t)3) + 4);
+}
+
+void *host_calloc(size_t count, size_t size) {
+    return host_malloc(count * size);
+}
+
+void *host_realloc(void *ptr, size_t size) {
+    void *resized = host_malloc(size);
+    if (resized && ptr) {
+        struct HeapBlock *block = (struct HeapBlock *)ptr - 1;
+        memcpy(resized, ptr, block->size < size ? block->size : size);
+        heap_release(ptr);
+    }
+    return resized;
+}
+
+void host_free(void *ptr) {
+    heap_release(ptr);
+}
+
+size_t heap_bytes_used(void) {
+    return heap_used;
+}
+
+size_t heap_bytes_free(void) {
+    return HEAP_LIMIT - heap_used;
+}
+
+size_t host_heap_limit(void) {
+    return HEAP_LIMIT;
+}
+
+size_t host_heap_peak(void) {
+    return heap_peak;
+}
+
+// handler accounting
+
+static uint64_t wall_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * NS_PER_SECOND + now.tv_nsec;
+}
+
+static uint64_t handler_started_at;
+static size_t handler_heap_at;
+
+void host_handler_begin(uint8_t handler) {
+    current_handler = handler;
+    host_handlers[handler].calls++;
+    handler_heap_at = heap_used;
+    handler_started_at = wall_ns();
+}
+
+void host_handler_end(uint8_t handler) {
+    uint64_t elapsed = wall_ns() - handler_started_at;
+    struct HostHandlerStats *stats = &host_handlers[handler];
+    stats->total_ns += elapsed;
+    if (elapsed > stats->max_ns) {
+        stats->max_ns = elapsed;
+    }
+    stats->heap_delta += (int32_t)heap_used - (int32_t)handler_heap_at;
+    current_handler = -1;
+}
+
+void host_reset_stats(void) {
+    memset(host_handlers, 0, sizeof(host_handlers));
+    memset(&host_counters, 0, sizeof(host_counters));
+    heap_peak = heap_used;
+}
+
+// geometry and colors
+
+bool grect_equal(const GRect *a, const GRect *b) {
+    return a->origin.x == b->origin.x && a->origin.y == b->origin.y &&
+        a->size.w == b->size.w && a->size.h == b->size.h;
+}
+
+bool gpoint_equal(const GPoint *a, const GPoint *b) {
+    return a->x == b->x && a->y == b->y;
+}
+
+bool gsize_equal(const GSize *a, const GSize *b) {
+    return a->w == b->w && a->h == b->h;
+}
+
+GColor8 host_color_from_hex(uint32_t hex) {
+    uint8_t r = (hex >> 16) & 0xFF;
+    uint8_t g = (hex >> 8) & 0xFF;
+    uint8_t b = hex & 0xFF;
+    return (GColor8){ .argb = 0xC0 | (r >> 6) << 4 | (g >> 6) << 2 | (b >> 6) };
+}
+
+bool gcolor_equal(GColor8 a, GColor8 b) {
+    // every fully transparent color is the same
+    return a.argb == b.argb || ((a.argb >> 6) == 0 && (b.argb >> 6) == 0);
+}
+
+static bool is_clear(GColor color) {
+    return (color.argb >> 6) == 0;
+}
+
+static GRect intersect(GRect a, GRect b) {
+    int16_t x0 = MAX(a.origin.x, b.origin.x);
+    int16_t y0 = MAX(a.origin.y, b.origin.y);
+    int16_t x1 = MIN(a.origin.x + a.size.w, b.origin.x + b.size.w);
+    int16_t y1 = MIN(a.origin.y + a.size.h, b.origin.y + b.size.h);
+    if (x1 <= x0 || y1 <= y0) {
+        return GRectZero;
+    }
+    return GRect(x0, y0, x1 - x0, y1 - y0);
+}
+
+// bitmaps and the frame buffer
+
+struct GBitmap {
+    uint8_t *data;
+    uint16_t row_bytes;
+    GRect bounds;
+    GBitmapFormat format;
+    GColor *palette;
+    bool owns_data;
+    bool owns_palette;
+};
+
+#if defined PBL_PLATFORM_CHALK
+#define SCREEN_WIDTH 180
+#define SCREEN_HEIGHT 180
+#else
+#define SCREEN_WIDTH 144
+#define SCREEN_HEIGHT 168
+#endif
+
+#if defined PBL_COLOR
+static uint8_t frame_data[SCREEN_HEIGHT * SCREEN_WIDTH];
+static GBitmap frame_buffer = {
+    frame_data, SCREEN_WIDTH, { { 0, 0 }, { SCREEN_WIDTH, SCREEN_HEIGHT } },
+#if defined PBL_PLATFORM_CHALK
+    GBitmapFormat8BitCircular,
+#else
+    GBitmapFormat8Bit,
+#endif
+    NULL, false, false,
+};
+#else
+#define FRAME_ROW_BYTES 20
+static uint8_t frame_data[SCREEN_HEIGHT * FRAME_ROW_BYTES];
+static GBitmap frame_buffer = {
+    frame_data, FRAME_ROW_BYTES, { { 0, 0 }, { SCREEN_WIDTH, SCREEN_HEIGHT } },
+    GBitmapFormat1Bit, NULL, false, false,
+};
+#endif
+
+GSize host_screen_size(void) {
+    return GSize(SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+GBitmap *host_frame_buffer(void) {
+    return &frame_buffer;
+}
+
+static void get_row_range(const GBitmap *bitmap, int16_t y, int16_t *min_x, int16_t *max_x) {
+    *min_x = bitmap->bounds.origin.x;
+    *max_x = bitmap->bounds.origin.x + bitmap->bounds.size.w - 1;
+    if (bitmap->format == GBitmapFormat8BitCircular) {
+        // only the pixels inside the display circle exist
+        int r = SCREEN_WIDTH / 2;
+        int dy = y - r;
+        int dx = 0;
+        while ((dx + 1) * (dx + 1) + dy * dy <= r * r) {
+            dx++;
+        }
+        *min_x = r - dx;
+        *max_x = r + dx - 1;
+    }
+}
+
+static uint8_t get_pixel(const GBitmap *bitmap, int16_t x, int16_t y) {
+    const uint8_t *row = bitmap->data + y * bitmap->row_bytes;
+    switch (bitmap->format) {
+        case GBitmapFormat1Bit:
+            return (row[x / 8] >> (x % 8)) & 1 ? GColorWhiteARGB8 : GColorBlackARGB8;
+        case GBitmapFormat1BitPalette:
+            return bitmap->palette[(row[x / 8] >> (7 - x % 8)) & 1].argb;
+        default:
+            return row[x];
+    }
+}
+
+static void set_pixel(GBitmap *bitmap, int16_t x, int16_t y, uint8_t argb) {
+    uint8_t *row = bitmap->data + y * bitmap->row_bytes;
+    if (bitmap->format == GBitmapFormat1Bit) {
+        // black and white displays round every color to one of the two
+        bool white = (argb & 0x3F) > 0x15;
+        if (white) {
+            row[x / 8] |= 1 << (x % 8);
+        } else {
+            row[x / 8] &= ~(1 << (x % 8));
+        }
+    } else {
+        row[x] = argb;
+    }
+}
+
+uint8_t host_pixel(int16_t x, int16_t y) {
+    return get_pixel(&frame_buffer, x, y);
+}
+
+static uint16_t get_row_bytes(GSize size, GBitmapFormat format) {
+    switch (format) {
+        case GBitmapFormat1Bit:
+            return ((size.w + 31) / 32) * 4;
+        case GBitmapFormat1BitPalette:
+            return (size.w + 7) / 8;
+        default:
+            return size.w;
+    }
+}
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+    uint16_t row_bytes = get_row_bytes(size, format);
+    GBitmap *bitmap = heap_alloc(sizeof(GBitmap), BITMAP_BYTES);
+    if (!bitmap) {
+        return NULL;
+    }
+    bitmap->data = host_malloc(row_bytes * size.h);
+    if (!bitmap->data) {
+        heap_release(bitmap);
+        return NULL;
+    }
+    memset(bitmap->data, 0, row_bytes * size.h);
+    bitmap->row_bytes = row_bytes;
+    bitmap->bounds = GRect(0, 0, size.w, size.h);
+    bitmap->format = format;
+    bitmap->owns_data = true;
+    return bitmap;
+}
+
+GBitmap *gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format, GColor *palette, bool free_on_destroy) {
+    GBitmap *bitmap = gbitmap_create_blank(size, format);
+    if (bitmap) {
+        bitmap->palette = palette;
+        bitmap->owns_palette = free_on_destroy;
+    }
+    return bitmap;
+}
+
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *parent, GRect sub_rect) {
+    GBitmap *bitmap = heap_alloc(sizeof(GBitmap), BITMAP_BYTES);
+    if (!bitmap) {
+        return NULL;
+    }
+    *bitmap = *parent;
+    bitmap->bounds = intersect(sub_rect, parent->bounds);
+    bitmap->owns_data = false;
+    bitmap->owns_palette = false;
+    return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+    if (!bitmap) {
+        return;
+    }
+    if (bitmap->owns_data) {
+        host_free(bitmap->data);
+    }
+    if (bitmap->owns_palette) {
+        host_free(bitmap->palette);
+    }
+    heap_release(bitmap);
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+    return bitmap->bounds;
+}
+
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds) {
+    bitmap->bounds = bounds;
+}
+
+uint8_t *gbitmap_get_data(const GBitmap *bitmap) {
+    return bitmap->data;
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+    return bitmap->row_bytes;
+}
+
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap) {
+    return bitmap->format;
+}
+
+void gbitmap_set_palette(GBitmap *bitmap, GColor *palette, bool free_on_destroy) {
+    bitmap->palette = palette;
+    bitmap->owns_palette = free_on_destroy;
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y) {
+    GBitmapDataRowInfo info;
+    info.data = bitmap->data + y * bitmap->row_bytes;
+    get_row_range(bitmap, y, &info.min_x, &info.max_x);
+    return info;
+}
+
+// fonts: every glyph is a fixed pattern in a box, which is enough to measure
+// how much is drawn and to compare two ways of drawing the same string
+
+struct HostFont {
+    int16_t height;
+    bool custom;
+};
+
+struct HostResource {
+    int16_t font_height;
+};
+
+static struct HostResource resources[HOST_NUM_RESOURCES] = {
+    [RESOURCE_ID_FONT_WEATHER_24] = { 24 },
+    [RESOURCE_ID_FONT_WEATHER_16] = { 16 },
+    [RESOURCE_ID_FONT_ICONS_20] = { 20 },
+    [RESOURCE_ID_FONT_BLOCKO_19] = { 19 },
+    [RESOURCE_ID_FONT_BLOCKO_32] = { 32 },
+    [RESOURCE_ID_FONT_BLOCKO_64] = { 64 },
+    [RESOURCE_ID_FONT_BLOCKO_16] = { 16 },
+    [RESOURCE_ID_FONT_BLOCKO_24] = { 24 },
+    [RESOURCE_ID_FONT_BLOCKO_56] = { 56 },
+    [RESOURCE_ID_FONT_LECO_14] = { 14 },
+    [RESOURCE_ID_FONT_LECO_21] = { 21 },
+    [RESOURCE_ID_FONT_LECO_47] = { 47 },
+    [RESOURCE_ID_FONT_KONSTRUCT_11] = { 11 },
+    [RESOURCE_ID_FONT_KONSTRUCT_17] = { 17 },
+    [RESOURCE_ID_FONT_KONSTRUCT_33] = { 33 },
+    [RESOURCE_ID_FONT_ARCHIVO_18] = { 18 },
+    [RESOURCE_ID_FONT_ARCHIVO_28] = { 28 },
+    [RESOURCE_ID_FONT_ARCHIVO_56] = { 56 },
+    [RESOURCE_ID_FONT_DIN_20] = { 20 },
+    [RESOURCE_ID_FONT_DIN_26] = { 26 },
+    [RESOURCE_ID_FONT_DIN_58] = { 58 },
+    [RESOURCE_ID_FONT_PROTOTYPE_16] = { 16 },
+    [RESOURCE_ID_FONT_PROTOTYPE_22] = { 22 },
+    [RESOURCE_ID_FONT_PROTOTYPE_48] = { 48 },
+};
+
+static struct HostFont system_fonts[] = { { 14, false }, { 18, false }, { 24, false }, { 28, false }, { 49, false } };
+
+ResHandle resource_get_handle(uint32_t resource_id) {
+    if (resource_id == 0 || resource_id >= HOST_NUM_RESOURCES) {
+        return NULL;
+    }
+    return &resources[resource_id];
+}
+
+size_t resource_size(ResHandle handle) {
+    // glyph data grows with the square of the height
+    return handle ? (size_t)handle->font_height * handle->font_height * 4 : 0;
+}
+
+GFont fonts_get_system_font(const char *font_key) {
+    if (strstr(font_key, "_14")) {
+        return &system_fonts[0];
+    } else if (strstr(font_key, "_18")) {
+        return &system_fonts[1];
+    } else if (strstr(font_key, "_24")) {
+        return &system_fonts[2];
+    } else if (strstr(font_key, "_28")) {
+        return &system_fonts[3];
+    }
+    return &system_fonts[4];
+}
+
+GFont fonts_load_custom_font(ResHandle handle) {
+    if (!handle) {
+        return NULL;
+    }
+    // the firmware keeps the font header and a glyph cache on the app heap
+    struct HostFont *font = heap_alloc(sizeof(struct HostFont), FONT_BYTES + handle->font_height * 8);
+    if (font) {
+        font->height = handle->font_height;
+        font->custom = true;
+        host_counters.font_loads++;
+    }
+    return font;
+}
+
+void fonts_unload_custom_font(GFont font) {
+    if (font && font->custom) {
+        heap_release(font);
+    }
+}
+
+static int16_t get_advance(GFont font, char c) {
+    if (c == ':' || c == '.' || c == ' ') {
+        return font->height / 4 + 1;
+    }
+    return font->height / 2 + 1;
+}
+
+static bool is_glyph_dot(char c, int16_t gx, int16_t gy, int16_t w, int16_t h) {
+    if (c == ' ' || gx == 0 || gx >= w - 1 || gy < h / 5 || gy >= h - h / 8) {
+        return false;
+    }
+    return ((gx * 31 + gy * 17 + (unsigned char)c * 7) % 5) < 2;
+}
+
+static GSize get_text_size(const char *text, GFont font, int16_t max_width, int16_t *lines) {
+    int16_t width = 0;
+    int16_t line_width = 0;
+    *lines = 1;
+    for (const char *c = text; *c; ++c) {
+        int16_t advance = get_advance(font, *c);
+        if (line_width + advance > max_width && line_width > 0) {
+            (*lines)++;
+            line_width = 0;
+        }
+        line_width += advance;
+        width = MAX(width, line_width);
+    }
+    return GSize(width, text[0] ? font->height * *lines : 0);
+}
+
+// graphics
+
+struct GContext {
+    GBitmap *target;
+    GPoint offset;
+    GRect clip;
+    GColor fill_color;
+    GColor stroke_color;
+    GColor text_color;
+    GCompOp compositing;
+    bool captured;
+};
+
+static GContext screen_context;
+
+GContext *host_screen_context(void) {
+    return &screen_context;
+}
+
+static GRect to_screen(GContext *ctx, GRect rect) {
+    rect.origin.x += ctx->offset.x;
+    rect.origin.y += ctx->offset.y;
+    return intersect(rect, ctx->clip);
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+    ctx->fill_color = color;
+}
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+    ctx->stroke_color = color;
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+    ctx->text_color = color;
+}
+
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) {
+    ctx->compositing = mode;
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, int corner_mask) {
+    host_counters.fill_rects++;
+    if (is_clear(ctx->fill_color)) {
+        return;
+    }
+    GRect area = to_screen(ctx, rect);
+    for (int16_t y = area.origin.y; y < area.origin.y + area.size.h; ++y) {
+        for (int16_t x = area.origin.x; x < area.origin.x + area.size.w; ++x) {
+            set_pixel(ctx->target, x, y, ctx->fill_color.argb);
+        }
+    }
+    host_counters.pixels += (uint64_t)area.size.w * area.size.h;
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, const GFont font, const GRect box,
+        const GTextOverflowMode overflow_mode, const GTextAlignment alignment, GTextAttributes *text_attributes) {
+    host_counters.text_draws++;
+    if (!text || !font || !text[0]) {
+        return;
+    }
+    int16_t lines;
+    GSize size = get_text_size(text, font, box.size.w, &lines);
+    int16_t x = box.origin.x;
+    if (alignment == GTextAlignmentCenter) {
+        x += (box.size.w - size.w) / 2;
+    } else if (alignment == GTextAlignmentRight) {
+        x += box.size.w - size.w;
+    }
+    GRect drawn = to_screen(ctx, GRect(x, box.origin.y, size.w, size.h));
+    host_counters.pixels += (uint64_t)drawn.size.w * drawn.size.h;
+    if (is_clear(ctx->text_color)) {
+        return;
+    }
+
+    int16_t y = box.origin.y;
+    int16_t line_x = x;
+    for (const char *c = text; *c; ++c) {
+        int16_t advance = get_advance(font, *c);
+        if (line_x + advance > x + box.size.w && line_x > x) {
+            line_x = x;
+            y += font->height;
+        }
+        for (int16_t gy = 0; gy < font->height; ++gy) {
+            for (int16_t gx = 0; gx < advance; ++gx) {
+                int16_t px = line_x + gx + ctx->offset.x;
+                int16_t py = y + gy + ctx->offset.y;
+                GRect pixel = intersect(GRect(px, py, 1, 1), ctx->clip);
+                if (pixel.size.w && is_glyph_dot(*c, gx, gy, advance, font->height)) {
+                    set_pixel(ctx->target, px, py, ctx->text_color.argb);
+                }
+            }
+        }
+        line_x += advance;
+    }
+}
+
+GSize graphics_text_layout_get_content_size(const char *text, const GFont font, const GRect box,
+        const GTextOverflowMode overflow_mode, const GTextAlignment alignment) {
+    int16_t lines;
+    if (!text || !font) {
+        return GSizeZero;
+    }
+    return get_text_size(text, font, box.size.w, &lines);
+}
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+    host_counters.bitmap_draws++;
+    if (!bitmap) {
+        return;
+    }
+    GRect area = to_screen(ctx, rect);
+    host_counters.pixels += (uint64_t)area.size.w * area.size.h;
+    int16_t origin_x = rect.origin.x + ctx->offset.x;
+    int16_t origin_y = rect.origin.y + ctx->offset.y;
+    for (int16_t y = area.origin.y; y < area.origin.y + area.size.h; ++y) {
+        for (int16_t x = area.origin.x; x < area.origin.x + area.size.w; ++x) {
+            // bitmaps smaller than the rect are tiled
+            int16_t sx = bitmap->bounds.origin.x + (x - origin_x) % bitmap->bounds.size.w;
+            int16_t sy = bitmap->bounds.origin.y + (y - origin_y) % bitmap->bounds.size.h;
+            uint8_t argb = get_pixel(bitmap, sx, sy);
+            if (bitmap->format == GBitmapFormat1Bit) {
+                bool set = argb == GColorWhiteARGB8;
+                if (ctx->compositing == GCompOpSet && set) {
+                    set_pixel(ctx->target, x, y, GColorWhiteARGB8);
+                } else if (ctx->compositing == GCompOpClear && set) {
+                    set_pixel(ctx->target, x, y, GColorBlackARGB8);
+                } else if (ctx->compositing == GCompOpAssign) {
+                    set_pixel(ctx->target, x, y, argb);
+                }
+            } else if (ctx->compositing != GCompOpSet || (argb >> 6) != 0) {
+                set_pixel(ctx->target, x, y, argb);
+            }
+        }
+    }
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+    if (ctx->captured) {
+        return NULL;
+    }
+    ctx->captured = true;
+    return ctx->target;
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+    bool was_captured = ctx->captured;
+    ctx->captured = false;
+    return was_captured;
+}
+
+// layers and windows
+
+struct Layer {
+    GRect frame;
+    GRect bounds;
+    Layer *parent;
+    Layer *first_child;
+    Layer *next_sibling;
+    LayerUpdateProc update_proc;
+    Window *window;
+    bool hidden;
+    void *data;
+};
+
+struct TextLayer {
+    Layer layer;
+    const char *text;
+    GFont font;
+    GColor text_color;
+    GColor background_color;
+    GTextAlignment alignment;
+    GTextOverflowMode overflow;
+};
+
+struct Window {
+    Layer root;
+    WindowHandlers handlers;
+    GColor background_color;
+    bool loaded;
+};
+
+static Window *top_window;
+static bool render_pending;
+
+static Window *find_window(const Layer *layer) {
+    while (layer && !layer->window) {
+        layer = layer->parent;
+    }
+    return layer ? layer->window : NULL;
+}
+
+static void init_layer(Layer *layer, GRect frame) {
+    memset(layer, 0, sizeof(Layer));
+    layer->frame = frame;
+    layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+}
+
+Layer *layer_create(GRect frame) {
+    Layer *layer = heap_alloc(sizeof(Layer), LAYER_BYTES);
+    if (layer) {
+        init_layer(layer, frame);
+    }
+    return layer;
+}
+
+Layer *layer_create_with_data(GRect frame, size_t data_size) {
+    Layer *layer = heap_alloc(sizeof(Layer) + data_size, LAYER_BYTES + data_size);
+    if (layer) {
+        init_layer(layer, frame);
+        layer->data = layer + 1;
+    }
+    return layer;
+}
+
+void *layer_get_data(const Layer *layer) {
+    return layer->data;
+}
+
+void layer_mark_dirty(Layer *layer) {
+    host_counters.dirty_marks++;
+    // the compositor repaints the whole window whenever anything in it is dirty
+    if (top_window && find_window(layer) == top_window) {
+        render_pending = true;
+    }
+}
+
+void layer_remove_from_parent(Layer *child) {
+    Layer *parent = child->parent;
+    if (!parent) {
+        return;
+    }
+    layer_mark_dirty(parent);
+    Layer **link = &parent->first_child;
+    while (*link && *link != child) {
+        link = &(*link)->next_sibling;
+    }
+    if (*link) {
+        *link = child->next_sibling;
+    }
+    child->parent = NULL;
+    child->next_sibling = NULL;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+    if (child->parent) {
+        layer_remove_from_parent(child);
+    }
+    Layer **link = &parent->first_child;
+    while (*link) {
+        link = &(*link)->next_sibling;
+    }
+    *link = child;
+    child->parent = parent;
+    layer_mark_dirty(child);
+}
+
+void layer_destroy(Layer *layer) {
+    if (!layer) {
+        return;
+    }
+    layer_remove_from_parent(layer);
+    heap_release(layer);
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+    layer->update_proc = update_proc;
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+    if (layer->hidden != hidden) {
+        layer->hidden = hidden;
+        layer_mark_dirty(layer);
+    }
+}
+
+bool layer_get_hidden(const Layer *layer) {
+    return layer->hidden;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+    if (grect_equal(&layer->frame, &frame)) {
+        return;
+    }
+    layer->frame = frame;
+    layer->bounds.size = frame.size;
+    layer_mark_dirty(layer);
+}
+
+GRect layer_get_frame(const Layer *layer) {
+    return layer->frame;
+}
+
+void layer_set_bounds(Layer *layer, GRect bounds) {
+    layer->bounds = bounds;
+    layer_mark_dirty(layer);
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+    return layer->bounds;
+}
+
+GRect layer_get_unobstructed_bounds(const Layer *layer) {
+    return layer->bounds;
+}
+
+Window *layer_get_window(const Layer *layer) {
+    return find_window(layer);
+}
+
+static void text_layer_update_proc(Layer *layer, GContext *ctx) {
+    TextLayer *text_layer = (TextLayer *)layer;
+    if (!is_clear(text_layer->background_color)) {
+        graphics_context_set_fill_color(ctx, text_layer->background_color);
+        graphics_fill_rect(ctx, layer->bounds, 0, GCornerNone);
+    }
+    if (text_layer->text && text_layer->text[0]) {
+        graphics_context_set_text_color(ctx, text_layer->text_color);
+        graphics_draw_text(ctx, text_layer->text, text_layer->font, layer->bounds,
+                text_layer->overflow, text_layer->alignment, NULL);
+    }
+}
+
+TextLayer *text_layer_create(GRect frame) {
+    TextLayer *text_layer = heap_alloc(sizeof(TextLayer), TEXT_LAYER_BYTES);
+    if (!text_layer) {
+        return NULL;
+    }
+    init_layer(&text_layer->layer, frame);
+    text_layer->layer.update_proc = text_layer_update_proc;
+    text_layer->font = &system_fonts[1];
+    text_layer->text_color = GColorBlack;
+    text_layer->background_color = GColorWhite;
+    text_layer->alignment = GTextAlignmentLeft;
+    text_layer->overflow = GTextOverflowModeWordWrap;
+    return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+    if (text_layer) {
+        layer_destroy(&text_layer->layer);
+    }
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+    return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+    host_counters.text_updates++;
+    text_layer->text = text;
+    layer_mark_dirty(&text_layer->layer);
+}
+
+const char *text_layer_get_text(TextLayer *text_layer) {
+    return text_layer->text;
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {
+    text_layer->font = font;
+    layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {
+    text_layer->text_color = color;
+    layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {
+    text_layer->background_color = color;
+    layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment) {
+    text_layer->alignment = text_alignment;
+    layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode) {
+    text_layer->overflow = line_mode;
+    layer_mark_dirty(&text_layer->layer);
+}
+
+GSize text_layer_get_content_size(TextLayer *text_layer) {
+    int16_t lines;
+    if (!text_layer->text || !text_layer->font) {
+        return GSizeZero;
+    }
+    return get_text_size(text_layer->text, text_layer->font, text_layer->layer.frame.size.w, &lines);
+}
+
+Window *window_create(void) {
+    Window *window = heap_alloc(sizeof(Window), WINDOW_BYTES);
+    if (!window) {
+        return NULL;
+    }
+    memset(window, 0, sizeof(Window));
+    init_layer(&window->root, GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT));
+    window->root.window = window;
+    window->background_color = GColorWhite;
+    return window;
+}
+
+void window_destroy(Window *window) {
+    if (!window) {
+        return;
+    }
+    if (window->loaded && window->handlers.unload) {
+        window->handlers.unload(window);
+    }
+    window->loaded = false;
+    if (top_window == window) {
+        top_window = NULL;
+    }
+    heap_release(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+    window->handlers = handlers;
+}
+
+Layer *window_get_root_layer(const Window *window) {
+    return (Layer *)&window->root;
+}
+
+void window_set_background_color(Window *window, GColor background_color) {
+    window->background_color = background_color;
+    layer_mark_dirty(&window->root);
+}
+
+void window_stack_push(Window *window, bool animated) {
+    top_window = window;
+    if (!window->loaded) {
+        window->loaded = true;
+        if (window->handlers.load) {
+            window->handlers.load(window);
+        }
+    }
+    if (window->handlers.appear) {
+        window->handlers.appear(window);
+    }
+    render_pending = true;
+}
+
+static void render_layer(Layer *layer, GPoint origin, GRect clip) {
+    if (layer->hidden) {
+        return;
+    }
+    GPoint at = GPoint(origin.x + layer->frame.origin.x, origin.y + layer->frame.origin.y);
+    GRect frame = intersect(GRect(at.x, at.y, layer->frame.size.w, layer->frame.size.h), clip);
+    if (!frame.size.w || !frame.size.h) {
+        return;
+    }
+    GPoint content = GPoint(at.x + layer->bounds.origin.x, at.y + layer->bounds.origin.y);
+    if (layer->update_proc) {
+        screen_context.offset = content;
+        screen_context.clip = frame;
+        screen_context.compositing = GCompOpAssign;
+        layer->update_proc(layer, &screen_context);
+    }
+    for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+        render_layer(child, content, frame);
+    }
+}
+
+void host_render(void) {
+    if (!render_pending || !top_window) {
+        return;
+    }
+    render_pending = false;
+    host_handler_begin(HOST_RENDER);
+    host_counters.frames++;
+    screen_context.target = &frame_buffer;
+    screen_context.offset = GPointZero;
+    screen_context.clip = GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (!is_clear(top_window->background_color)) {
+        graphics_context_set_fill_color(&screen_context, top_window->background_color);
+        graphics_fill_rect(&screen_context, screen_context.clip, 0, GCornerNone);
+    }
+    Layer *root = &top_window->root;
+    render_layer(root, GPointZero, GRect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT));
+    host_handler_end(HOST_RENDER);
+}
+
+// timers and scheduled driver events
+
+struct AppTimer {
+    uint64_t due_ms;
+    AppTimerCallback callback;
+    void *data;
+    AppTimer *next;
+};
+
+struct HostEvent {
+    uint64_t due_ms;
+    void (*callback)(void *data);
+    void *data;
+    struct HostEvent *next;
+};
+
+static AppTimer *timers;
+static struct HostEvent *events;
+
+static void insert_timer(AppTimer *timer) {
+    AppTimer **link = &timers;
+    while (*link && (*link)->due_ms <= timer->due_ms) {
+        link = &(*link)->next;
+    }
+    timer->next = *link;
+    *link = timer;
+}
+
+static bool unlink_timer(AppTimer *timer) {
+    for (AppTimer **link = &timers; *link; link = &(*link)->next) {
+        if (*link == timer) {
+            *link = timer->next;
+            return true;
+        }
+    }
+    return false;
+}
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+    AppTimer *timer = heap_alloc(sizeof(AppTimer), TIMER_BYTES);
+    if (!timer) {
+        return NULL;
+    }
+    timer->due_ms = clock_ms + timeout_ms;
+    timer->callback = callback;
+    timer->data = callback_data;
+    insert_timer(timer);
+    return timer;
+}
+
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms) {
+    if (!timer || !unlink_timer(timer)) {
+        return false;
+    }
+    timer->due_ms = clock_ms + new_timeout_ms;
+    insert_timer(timer);
+    return true;
+}
+
+void app_timer_cancel(AppTimer *timer) {
+    if (timer && unlink_timer(timer)) {
+        heap_release(timer);
+    }
+}
+
+void host_schedule(uint64_t at_ms, void (*callback)(void *data), void *data) {
+    struct HostEvent *event = calloc(1, sizeof(struct HostEvent));
+    event->due_ms = at_ms;
+    event->callback = callback;
+    event->data = data;
+    struct HostEvent **link = &events;
+    while (*link && (*link)->due_ms <= at_ms) {
+        link = &(*link)->next;
+    }
+    event->next = *link;
+    *link = event;
+}
+
+// tick service
+
+static TickHandler tick_handler;
+static TimeUnits tick_units;
+static uint64_t last_tick_ms;
+
+void tick_timer_service_subscribe(TimeUnits tick_units_value, TickHandler handler) {
+    tick_handler = handler;
+    tick_units = tick_units_value;
+    last_tick_ms = clock_ms;
+}
+
+void tick_timer_service_unsubscribe(void) {
+    tick_handler = NULL;
+}
+
+static uint64_t next_tick_ms(void) {
+    uint64_t period = tick_units & SECOND_UNIT ? 1000 : 60 * 1000;
+    return (last_tick_ms / period + 1) * period;
+}
+
+static void fire_tick(void) {
+    last_tick_ms = clock_ms;
+    time_t now = host_time(NULL);
+    struct tm tick_time = *localtime(&now);
+    TimeUnits changed = SECOND_UNIT;
+    if (tick_time.tm_sec == 0) {
+        changed |= MINUTE_UNIT;
+        if (tick_time.tm_min == 0) {
+            changed |= HOUR_UNIT;
+            if (tick_time.tm_hour == 0) {
+                changed |= DAY_UNIT;
+            }
+        }
+    }
+    if (changed & tick_units) {
+        host_handler_begin(HOST_TICK);
+        tick_handler(&tick_time, changed);
+        host_handler_end(HOST_TICK);
+    }
+}
+
+// storage
+
+#define PERSIST_SLOTS 256
+#define E_DOES_NOT_EXIST -9
+
+struct PersistSlot {
+    bool used;
+    uint32_t key;
+    uint16_t size;
+    uint8_t data[PERSIST_DATA_MAX_LENGTH];
+};
+
+static struct PersistSlot persist_slots[PERSIST_SLOTS];
+
+static struct PersistSlot *find_slot(uint32_t key) {
+    for (int i = 0; i < PERSIST_SLOTS; ++i) {
+        if (persist_slots[i].used && persist_slots[i].key == key) {
+            return &persist_slots[i];
+        }
+    }
+    return NULL;
+}
+
+static int write_slot(uint32_t key, const void *data, size_t size) {
+    struct PersistSlot *slot = find_slot(key);
+    for (int i = 0; !slot && i < PERSIST_SLOTS; ++i) {
+        if (!persist_slots[i].used) {
+            slot = &persist_slots[i];
+        }
+    }
+    if (!slot) {
+        return -6;
+    }
+    size = MIN(size, PERSIST_DATA_MAX_LENGTH);
+    slot->used = true;
+    slot->key = key;
+    slot->size = size;
+    memcpy(slot->data, data, size);
+    host_counters.persist_writes++;
+    host_counters.persist_bytes_written += size;
+    return (int)size;
+}
+
+void host_persist_clear(void) {
+    memset(persist_slots, 0, sizeof(persist_slots));
+}
+
+bool persist_exists(const uint32_t key) {
+    host_counters.persist_reads++;
+    return find_slot(key) != NULL;
+}
+
+int persist_get_size(const uint32_t key) {
+    host_counters.persist_reads++;
+    struct PersistSlot *slot = find_slot(key);
+    return slot ? slot->size : E_DOES_NOT_EXIST;
+}
+
+int32_t persist_read_int(const uint32_t key) {
+    host_counters.persist_reads++;
+    struct PersistSlot *slot = find_slot(key);
+    int32_t value = 0;
+    if (slot) {
+        memcpy(&value, slot->data, MIN(slot->size, sizeof(value)));
+    }
+    return value;
+}
+
+bool persist_read_bool(const uint32_t key) {
+    return persist_read_int(key) != 0;
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+    host_counters.persist_reads++;
+    struct PersistSlot *slot = find_slot(key);
+    if (!slot) {
+        return E_DOES_NOT_EXIST;
+    }
+    size_t size = MIN(slot->size, buffer_size);
+    memcpy(buffer, slot->data, size);
+    return (int)size;
+}
+
+int persist_read_string(const uint32_t key, char *buffer, const size_t buffer_size) {
+    host_counters.persist_reads++;
+    struct PersistSlot *slot = find_slot(key);
+    if (!slot || buffer_size == 0) {
+        return E_DOES_NOT_EXIST;
+    }
+    size_t size = MIN(slot->size, buffer_size);
+    memcpy(buffer, slot->data, size);
+    buffer[size - 1] = '\0';
+    return (int)size;
+}
+
+int persist_write_int(const uint32_t key, const int32_t value) {
+    return write_slot(key, &value, sizeof(value));
+}
+
+int persist_write_bool(const uint32_t key, const bool value) {
+    return persist_write_int(key, value);
+}
+
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+    return write_slot(key, data, size);
+}
+
+int persist_write_string(const uint32_t key, const char *cstring) {
+    return write_slot(key, cstring, strlen(cstring) + 1);
+}
+
+int persist_delete(const uint32_t key) {
+    struct PersistSlot *slot = find_slot(key);
+    if (!slot) {
+        return E_DOES_NOT_EXIST;
+    }
+    slot->used = false;
+    host_counters.persist_writes++;
+    return 0;
+}
+
+// dictionaries
+
+#define TUPLE_HEADER 7
+
+void host_dict_init(DictionaryIterator *iter, uint8_t *buffer, size_t size) {
+    // the first byte holds the number of tuples, like the firmware's Dictionary
+    iter->begin = buffer;
+    iter->end = buffer + 1;
+    iter->limit = buffer + size;
+    iter->cursor = NULL;
+    buffer[0] = 0;
+}
+
+size_t host_dict_size(const DictionaryIterator *iter) {
+    return iter->end - iter->begin;
+}
+
+Tuple *dict_read_first(DictionaryIterator *iter) {
+    iter->cursor = (Tuple *)(iter->begin + 1);
+    return (uint8_t *)iter->cursor < iter->end ? iter->cursor : NULL;
+}
+
+Tuple *dict_read_next(DictionaryIterator *iter) {
+    if (!iter->cursor) {
+        return NULL;
+    }
+    uint8_t *next = (uint8_t *)iter->cursor + TUPLE_HEADER + iter->cursor->length;
+    iter->cursor = (Tuple *)next;
+    return next < iter->end ? iter->cursor : NULL;
+}
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key) {
+    uint8_t *at = iter->begin + 1;
+    while (at < iter->end) {
+        Tuple *tuple = (Tuple *)at;
+        if (tuple->key == key) {
+            return tuple;
+        }
+        at += TUPLE_HEADER + tuple->length;
+    }
+    return NULL;
+}
+
+static DictionaryResult write_tuple(DictionaryIterator *iter, uint32_t key, TupleType type, const void *data, uint16_t size) {
+    if (iter->end + TUPLE_HEADER + size > iter->limit) {
+        return DICT_NOT_ENOUGH_STORAGE;
+    }
+    Tuple *tuple = (Tuple *)iter->end;
+    tuple->key = key;
+    tuple->type = type;
+    tuple->length = size;
+    memcpy(tuple->value->data, data, size);
+    iter->end += TUPLE_HEADER + size;
+    iter->begin[0]++;
+    return DICT_OK;
+}
+
+DictionaryResult dict_write_data(DictionaryIterator *iter, const uint32_t key, const uint8_t *data, const uint16_t size) {
+    return write_tuple(iter, key, TUPLE_BYTE_ARRAY, data, size);
+}
+
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, const uint32_t key, const char *cstring) {
+    return write_tuple(iter, key, TUPLE_CSTRING, cstring, strlen(cstring) + 1);
+}
+
+DictionaryResult dict_write_int(DictionaryIterator *iter, const uint32_t key, const void *integer, const uint8_t width_bytes, const bool is_signed) {
+    return write_tuple(iter, key, is_signed ? TUPLE_INT : TUPLE_UINT, integer, width_bytes);
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, const uint32_t key, const uint8_t value) {
+    return dict_write_int(iter, key, &value, 1, false);
+}
+
+DictionaryResult dict_write_uint32(DictionaryIterator *iter, const uint32_t key, const uint32_t value) {
+    return dict_write_int(iter, key, &value, 4, false);
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value) {
+    return dict_write_int(iter, key, &value, 4, true);
+}
+
+// app messages: the phone answers through host_deliver_inbox, acks and
+// failures come back after a short link delay
+
+#define ACK_DELAY_MS 150
+#define MAX_MESSAGE 2048
+
+struct Message {
+    uint64_t due_ms;
+    uint8_t kind;
+    AppMessageResult result;
+    uint16_t size;
+    uint8_t data[MAX_MESSAGE];
+    struct Message *next;
+};
+
+#define MESSAGE_INBOX 0
+#define MESSAGE_SENT 1
+#define MESSAGE_FAILED 2
+
+static AppMessageInboxReceived inbox_received;
+static AppMessageInboxDropped inbox_dropped;
+static AppMessageOutboxSent outbox_sent;
+static AppMessageOutboxFailed outbox_failed;
+static uint32_t inbox_size;
+static uint32_t outbox_size;
+static uint8_t outbox_buffer[MAX_MESSAGE];
+static DictionaryIterator outbox_iter;
+static bool outbox_open;
+static bool outbox_busy;
+static struct Message *messages;
+static void (*phone)(DictionaryIterator *iter);
+static bool connected = true;
+
+static void queue_message(uint32_t delay_ms, uint8_t kind, AppMessageResult result, const uint8_t *data, size_t size) {
+    struct Message *message = calloc(1, sizeof(struct Message));
+    message->due_ms = clock_ms + delay_ms;
+    message->kind = kind;
+    message->result = result;
+    message->size = MIN(size, MAX_MESSAGE);
+    if (data) {
+        memcpy(message->data, data, message->size);
+    }
+    struct Message **link = &messages;
+    while (*link && (*link)->due_ms <= message->due_ms) {
+        link = &(*link)->next;
+    }
+    message->next = *link;
+    *link = message;
+}
+
+void host_set_phone(void (*on_message)(DictionaryIterator *iter)) {
+    phone = on_message;
+}
+
+void host_deliver_inbox(uint32_t delay_ms, const uint8_t *buffer, size_t size) {
+    queue_message(delay_ms, MESSAGE_INBOX, APP_MSG_OK, buffer, size);
+}
+
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound) {
+    inbox_size = MIN(size_inbound, MAX_MESSAGE);
+    outbox_size = MIN(size_outbound, MAX_MESSAGE);
+    return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator) {
+    if (!outbox_size) {
+        return APP_MSG_INVALID_ARGS;
+    }
+    if (outbox_busy || outbox_open) {
+        return APP_MSG_BUSY;
+    }
+    host_dict_init(&outbox_iter, outbox_buffer, outbox_size);
+    outbox_open = true;
+    *iterator = &outbox_iter;
+    return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_send(void) {
+    if (!outbox_open) {
+        return APP_MSG_INVALID_ARGS;
+    }
+    outbox_open = false;
+    outbox_busy = true;
+    host_counters.outbox_sends++;
+    host_counters.outbox_bytes += host_dict_size(&outbox_iter);
+    if (!connected) {
+        queue_message(ACK_DELAY_MS, MESSAGE_FAILED, APP_MSG_NOT_CONNECTED, NULL, 0);
+        return APP_MSG_OK;
+    }
+    if (phone) {
+        DictionaryIterator copy = outbox_iter;
+        phone(&copy);
+    }
+    queue_message(ACK_DELAY_MS, MESSAGE_SENT, APP_MSG_OK, NULL, 0);
+    return APP_MSG_OK;
+}
+
+void app_message_register_inbox_received(AppMessageInboxReceived received_callback) {
+    inbox_received = received_callback;
+}
+
+void app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback) {
+    inbox_dropped = dropped_callback;
+}
+
+void app_message_register_outbox_sent(AppMessageOutboxSent sent_callback) {
+    outbox_sent = sent_callback;
+}
+
+void app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback) {
+    outbox_failed = failed_callback;
+}
+
+uint32_t app_message_inbox_size_maximum(void) {
+    return MAX_MESSAGE;
+}
+
+uint32_t app_message_outbox_size_maximum(void) {
+    return MAX_MESSAGE;
+}
+
+static void deliver_message(struct Message *message) {
+    DictionaryIterator iter;
+    if (message->kind == MESSAGE_INBOX) {
+        host_counters.inbox_messages++;
+        host_counters.inbox_bytes += message->size;
+        if (!connected || message->size > inbox_size) {
+            if (inbox_dropped) {
+                host_handler_begin(HOST_INBOX);
+                inbox_dropped(connected ? APP_MSG_BUFFER_OVERFLOW : APP_MSG_NOT_CONNECTED, NULL);
+                host_handler_end(HOST_INBOX);
+            }
+            return;
+        }
+        iter.begin = message->data;
+        iter.end = message->data + message->size;
+        iter.limit = iter.end;
+        iter.cursor = NULL;
+        if (inbox_received) {
+            host_handler_begin(HOST_INBOX);
+            inbox_received(&iter, NULL);
+            host_handler_end(HOST_INBOX);
+        }
+        return;
+    }
+
+    outbox_busy = false;
+    if (message->kind == MESSAGE_SENT && outbox_sent) {
+        host_handler_begin(HOST_OUTBOX_SENT);
+        outbox_sent(&outbox_iter, NULL);
+        host_handler_end(HOST_OUTBOX_SENT);
+    } else if (message->kind == MESSAGE_FAILED && outbox_failed) {
+        host_handler_begin(HOST_OUTBOX_FAILED);
+        outbox_failed(&outbox_iter, message->result, NULL);
+        host_handler_end(HOST_OUTBOX_FAILED);
+    }
+}
+
+// accelerometer
+
+#define ACCEL_MAX_BATCH 100
+
+static AccelDataHandler accel_handler;
+static AccelTapHandler tap_handler;
+static uint32_t accel_batch = 25;
+static uint32_t accel_rate = ACCEL_SAMPLING_25HZ;
+static uint64_t last_accel_ms;
+static void (*accel_source)(AccelData *data, uint32_t num_samples, uint64_t at_ms);
+
+void accel_data_service_subscribe(uint32_t samples_per_update, AccelDataHandler handler) {
+    accel_handler = handler;
+    accel_batch = MIN(samples_per_update, ACCEL_MAX_BATCH);
+    last_accel_ms = clock_ms;
+}
+
+void accel_data_service_unsubscribe(void) {
+    accel_handler = NULL;
+}
+
+int accel_service_set_sampling_rate(AccelSamplingRate rate) {
+    accel_rate = rate;
+    return 0;
+}
+
+int accel_service_set_samples_per_update(uint32_t num_samples) {
+    accel_batch = MIN(num_samples, ACCEL_MAX_BATCH);
+    return 0;
+}
+
+void accel_tap_service_subscribe(AccelTapHandler handler) {
+    tap_handler = handler;
+}
+
+void accel_tap_service_unsubscribe(void) {
+    tap_handler = NULL;
+}
+
+void host_set_accel_source(void (*fill)(AccelData *data, uint32_t num_samples, uint64_t at_ms)) {
+    accel_source = fill;
+}
+
+bool host_accel_subscribed(void) {
+    return accel_handler != NULL;
+}
+
+static uint64_t next_accel_ms(void) {
+    return last_accel_ms + accel_batch * 1000 / accel_rate;
+}
+
+static void fire_accel(void) {
+    AccelData samples[ACCEL_MAX_BATCH];
+    uint64_t started = last_accel_ms;
+    last_accel_ms = next_accel_ms();
+    for (uint32_t i = 0; i < accel_batch; ++i) {
+        samples[i] = (AccelData){ 0, 0, -1000, false, started + i * 1000 / accel_rate };
+    }
+    if (accel_source) {
+        accel_source(samples, accel_batch, started);
+    }
+    host_handler_begin(HOST_ACCEL);
+    accel_handler(samples, accel_batch);
+    host_handler_end(HOST_ACCEL);
+}
+
+void host_emit_tap(AccelAxisType axis, int32_t direction) {
+    if (tap_handler) {
+        host_handler_begin(HOST_TAP);
+        tap_handler(axis, direction);
+        host_handler_end(HOST_TAP);
+    }
+}
+
+// battery, connection and the other system services
+
+static BatteryStateHandler battery_handler;
+static BatteryChargeState battery_state = { 80, false, false };
+static ConnectionHandlers connection_handlers;
+static bool quiet_time;
+static CompassHeadingHandler compass_handler;
+static AppFocusHandlers focus_handlers;
+static UnobstructedAreaHandlers unobstructed_handlers;
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+    battery_handler = handler;
+}
+
+void battery_state_service_unsubscribe(void) {
+    battery_handler = NULL;
+}
+
+BatteryChargeState battery_state_service_peek(void) {
+    return battery_state;
+}
+
+void host_set_battery(uint8_t percent, bool charging) {
+    if (battery_state.charge_percent == percent && battery_state.is_charging == charging) {
+        return;
+    }
+    battery_state = (BatteryChargeState){ percent, charging, charging };
+    if (battery_handler) {
+        host_handler_begin(HOST_BATTERY);
+        battery_handler(battery_state);
+        host_handler_end(HOST_BATTERY);
+    }
+}
+
+void connection_service_subscribe(ConnectionHandlers conn_handlers) {
+    connection_handlers = conn_handlers;
+}
+
+void connection_service_unsubscribe(void) {
+    memset(&connection_handlers, 0, sizeof(connection_handlers));
+}
+
+bool connection_service_peek_pebble_app_connection(void) {
+    return connected;
+}
+
+bool bluetooth_connection_service_peek(void) {
+    return connected;
+}
+
+void host_set_connected(bool is_connected) {
+    if (connected == is_connected) {
+        return;
+    }
+    connected = is_connected;
+    if (connection_handlers.pebble_app_connection_handler) {
+        host_handler_begin(HOST_CONNECTION);
+        connection_handlers.pebble_app_connection_handler(connected);
+        host_handler_end(HOST_CONNECTION);
+    }
+}
+
+bool quiet_time_is_active(void) {
+    return quiet_time;
+}
+
+void host_set_quiet_time(bool active) {
+    quiet_time = active;
+}
+
+void vibes_enqueue_custom_pattern(VibePattern pattern) {
+    host_counters.vibrations++;
+}
+
+void vibes_short_pulse(void) {
+    host_counters.vibrations++;
+}
+
+void vibes_long_pulse(void) {
+    host_counters.vibrations++;
+}
+
+void vibes_double_pulse(void) {
+    host_counters.vibrations++;
+}
+
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void *context) {
+    unobstructed_handlers = handlers;
+}
+
+void unobstructed_area_service_unsubscribe(void) {
+    memset(&unobstructed_handlers, 0, sizeof(unobstructed_handlers));
+}
+
+void compass_service_subscribe(CompassHeadingHandler handler) {
+    compass_handler = handler;
+}
+
+void compass_service_unsubscribe(void) {
+    compass_handler = NULL;
+}
+
+int compass_service_set_heading_filter(CompassHeading filter) {
+    return 0;
+}
+
+int compass_service_peek(CompassHeadingData *data) {
+    *data = (CompassHeadingData){ 0, 0, CompassStatusCalibrated, true };
+    return 0;
+}
+
+void host_emit_compass(int32_t heading) {
+    if (compass_handler) {
+        host_handler_begin(HOST_COMPASS);
+        compass_handler((CompassHeadingData){ heading, heading, CompassStatusCalibrated, true });
+        host_handler_end(HOST_COMPASS);
+    }
+}
+
+void app_focus_service_subscribe_handlers(AppFocusHandlers handlers) {
+    focus_handlers = handlers;
+}
+
+void app_focus_service_unsubscribe(void) {
+    memset(&focus_handlers, 0, sizeof(focus_handlers));
+}
+
+void host_emit_focus(bool in_focus) {
+    host_handler_begin(HOST_FOCUS);
+    if (focus_handlers.will_focus) {
+        focus_handlers.will_focus(in_focus);
+    }
+    if (focus_handlers.did_focus) {
+        focus_handlers.did_focus(in_focus);
+    }
+    host_handler_end(HOST_FOCUS);
+}
+
+// health: a wearer who sleeps from 23:00 to 7:00 and walks during the day.
+// every day has the same shape, scaled a little by the day of the week
+
+#define WAKE_UP_HOUR 7
+#define BED_TIME_HOUR 23
+#define DAILY_STEPS 9000
+
+static HealthEventHandler health_handler;
+static bool health_permission = true;
+static uint64_t last_health_ms;
+
+void host_set_health_permission(bool granted) {
+    health_permission = granted;
+}
+
+static bool is_asleep_at(time_t t) {
+    int hour = localtime(&t)->tm_hour;
+    return hour >= BED_TIME_HOUR || hour < WAKE_UP_HOUR;
+}
+
+static int32_t get_day_scale(time_t day_start) {
+    // percent of an average day, so weekdays differ from each other
+    return 85 + (localtime(&day_start)->tm_wday * 5);
+}
+
+static int64_t get_day_progress(HealthMetric metric, int32_t seconds) {
+    int32_t awake_from = WAKE_UP_HOUR * SECONDS_PER_HOUR;
+    int32_t awake_to = BED_TIME_HOUR * SECONDS_PER_HOUR;
+    int32_t awake = MAX(0, MIN(seconds, awake_to) - awake_from);
+    int32_t awake_total = awake_to - awake_from;
+    int32_t asleep = MIN(seconds, awake_from) + MAX(0, seconds - awake_to);
+    switch (metric) {
+        case HealthMetricStepCount:
+            return (int64_t)DAILY_STEPS * awake / awake_total;
+        case HealthMetricWalkedDistanceMeters:
+            return (int64_t)DAILY_STEPS * 3 / 4 * awake / awake_total;
+        case HealthMetricActiveSeconds:
+            return (int64_t)DAILY_STEPS / 2 * awake / awake_total;
+        case HealthMetricActiveKCalories:
+            return (int64_t)DAILY_STEPS / 25 * awake / awake_total;
+        case HealthMetricRestingKCalories:
+            return (int64_t)1600 * seconds / SECONDS_PER_DAY;
+        case HealthMetricSleepSeconds:
+            return asleep;
+        case HealthMetricSleepRestfulSeconds:
+            return asleep * 2 / 5;
+        default:
+            return 0;
+    }
+}
+
+static int64_t get_cumulative(HealthMetric metric, time_t t) {
+    // everything recorded from the start of the simulated history up to t
+    time_t day_start = t - (t % SECONDS_PER_DAY);
+    int64_t total = 0;
+    for (int day = 1; day <= 30; ++day) {
+        time_t past = day_start - day * SECONDS_PER_DAY;
+        total += get_day_progress(metric, SECONDS_PER_DAY) * get_day_scale(past) / 100;
+    }
+    return total + get_day_progress(metric, (int32_t)(t - day_start)) * get_day_scale(day_start) / 100;
+}
+
+static void count_health_call(void) {
+    time_t now = host_time(NULL);
+    host_counters.health_calls++;
+    host_counters.health_hour_calls[localtime(&now)->tm_hour]++;
+}
+
+HealthServiceAccessibilityMask health_service_metric_accessible(HealthMetric metric, time_t time_start, time_t time_end) {
+    count_health_call();
+    return health_permission ? HealthServiceAccessibilityMaskAvailable : HealthServiceAccessibilityMaskNoPermission;
+}
+
+HealthServiceAccessibilityMask health_service_metric_averaged_accessible(HealthMetric metric,
+        time_t time_start, time_t time_end, HealthServiceTimeScope scope) {
+    count_health_call();
+    return health_permission ? HealthServiceAccessibilityMaskAvailable : HealthServiceAccessibilityMaskNoPermission;
+}
+
+HealthValue health_service_sum(HealthMetric metric, time_t time_start, time_t time_end) {
+    count_health_call();
+    host_counters.health_sum_calls++;
+    return (HealthValue)(get_cumulative(metric, time_end) - get_cumulative(metric, time_start));
+}
+
+HealthValue health_service_sum_today(HealthMetric metric) {
+    return health_service_sum(metric, time_start_of_today(), host_time(NULL));
+}
+
+HealthValue health_service_sum_averaged(HealthMetric metric, time_t time_start, time_t time_end, HealthServiceTimeScope scope) {
+    count_health_call();
+    host_counters.health_average_calls++;
+    time_t day_start = time_start - (time_start % SECONDS_PER_DAY);
+    return (HealthValue)(get_day_progress(metric, (int32_t)(time_end - day_start)) -
+            get_day_progress(metric, (int32_t)(time_start - day_start)));
+}
+
+HealthValue health_service_peek_current_value(HealthMetric metric) {
+    count_health_call();
+    if (metric != HealthMetricHeartRateBPM && metric != HealthMetricHeartRateRawBPM) {
+        return 0;
+    }
+    time_t now = host_time(NULL);
+    return is_asleep_at(now) ? 52 : 64 + (now / SECONDS_PER_MINUTE) % 20;
+}
+
+HealthActivityMask health_service_peek_current_activities(void) {
+    count_health_call();
+    time_t now = host_time(NULL);
+    if (!is_asleep_at(now)) {
+        return HealthActivityNone;
+    }
+    int hour = localtime(&now)->tm_hour;
+    return HealthActivitySleep | (hour >= 1 && hour < 4 ? HealthActivityRestfulSleep : 0);
+}
+
+bool health_service_events_subscribe(HealthEventHandler handler, void *context) {
+    health_handler = handler;
+    last_health_ms = clock_ms;
+    return true;
+}
+
+bool health_service_events_unsubscribe(void) {
+    health_handler = NULL;
+    return true;
+}
+
+MeasurementSystem health_service_get_measurement_system_for_display(HealthMetric metric) {
+    return MeasurementSystemMetric;
+}
+
+static uint64_t next_health_ms(void) {
+    // movement updates arrive about once a minute while awake, sleep updates
+    // every quarter of an hour
+    time_t at = (time_t)(last_health_ms / 1000);
+    return last_health_ms + (is_asleep_at(at) ? 15 : 1) * 60 * 1000;
+}
+
+static void fire_health(void) {
+    last_health_ms = next_health_ms();
+    time_t at = (time_t)(last_health_ms / 1000);
+    host_handler_begin(HOST_HEALTH);
+    health_handler(is_asleep_at(at) ? HealthEventSleepUpdate : HealthEventMovementUpdate, NULL);
+    host_handler_end(HOST_HEALTH);
+}
+
+// event loop
+
+static void (*event_loop)(void);
+
+void host_set_event_loop(void (*loop)(void)) {
+    event_loop = loop;
+}
+
+void app_event_loop(void) {
+    host_handler_end(HOST_INIT);
+    host_render();
+    if (event_loop) {
+        event_loop();
+    }
+    host_handler_begin(HOST_DEINIT);
+}
+
+#define EVENT_NONE 0
+#define EVENT_TICK 1
+#define EVENT_TIMER 2
+#define EVENT_MESSAGE 3
+#define EVENT_ACCEL 4
+#define EVENT_HEALTH 5
+#define EVENT_DRIVER 6
+
+static void pick(uint8_t *kind, uint64_t *due, uint8_t candidate, uint64_t at) {
+    if (at < *due) {
+        *kind = candidate;
+        *due = at;
+    }
+}
+
+void host_run_until(uint64_t end_ms) {
+    for (;;) {
+        uint8_t kind = EVENT_NONE;
+        uint64_t due = end_ms + 1;
+        // driver events go first so device state changes land before the app reacts
+        if (events) {
+            pick(&kind, &due, EVENT_DRIVER, events->due_ms);
+        }
+        if (messages) {
+            pick(&kind, &due, EVENT_MESSAGE, messages->due_ms);
+        }
+        if (timers) {
+            pick(&kind, &due, EVENT_TIMER, timers->due_ms);
+        }
+        if (tick_handler) {
+            pick(&kind, &due, EVENT_TICK, next_tick_ms());
+        }
+        if (accel_handler) {
+            pick(&kind, &due, EVENT_ACCEL, next_accel_ms());
+        }
+        if (health_handler) {
+            pick(&kind, &due, EVENT_HEALTH, next_health_ms());
+        }
+        if (kind == EVENT_NONE) {
+            clock_ms = end_ms;
+            return;
+        }
+
+        if (due > clock_ms) {
+            clock_ms = due;
+        }
+        switch (kind) {
+            case EVENT_DRIVER: {
+                struct HostEvent *event = events;
+                events = event->next;
+                event->callback(event->data);
+                free(event);
+                break;
+            }
+            case EVENT_MESSAGE: {
+                struct Message *message = messages;
+                messages = message->next;
+                deliver_message(message);
+                free(message);
+                break;
+            }
+            case EVENT_TIMER: {
+                AppTimer *timer = timers;
+                timers = timer->next;
+                AppTimerCallback callback = timer->callback;
+                void *data = timer->data;
+                heap_release(timer);
+                host_handler_begin(HOST_TIMER);
+                callback(data);
+                host_handler_end(HOST_TIMER);
+                break;
+            }
+            case EVENT_TICK:
+                fire_tick();
+                break;
+            case EVENT_ACCEL:
+                fire_accel();
+                break;
+            case EVENT_HEALTH:
+                fire_health();
+                break;
+        }
+        host_render();
+    }
+}
+
+// report
+
+static const char *handler_names[HOST_HANDLERS] = {
+    "init",
+    "deinit",
+    "tick",
+    "timer",
+    "inbox",
+    "outbox_sent",
+    "outbox_failed",
+    "battery",
+    "connection",
+    "accel",
+    "tap",
+    "health",
+    "compass",
+    "focus",
+    "unobstructed",
+    "render",
+};
+
+void host_report(FILE *out, double minutes) {
+    fprintf(out, "%-14s %8s %10s %9s %9s %8s %10s\n", "handler", "calls", "total_ms", "avg_us", "max_us", "allocs", "heap_delta");
+    for (int i = 0; i < HOST_HANDLERS; ++i) {
+        struct HostHandlerStats *stats = &host_handlers[i];
+        if (!stats->calls) {
+            continue;
+        }
+        fprintf(out, "%-14s %8u %10.3f %9.2f %9.2f %8u %10d\n", handler_names[i], stats->calls,
+                stats->total_ns / 1e6, stats->total_ns / 1e3 / stats->calls, stats->max_ns / 1e3,
+                stats->allocs, stats->heap_delta);
+    }
+
+    struct HostCounters *c = &host_counters;
+    double hours = minutes / 60;
+    fprintf(out, "\n");
+    fprintf(out, "persist reads %u, writes %u (%u bytes)\n", c->persist_reads, c->persist_writes, c->persist_bytes_written);
+    fprintf(out, "text updates %u, dirty marks %u\n", c->text_updates, c->dirty_marks);
+    fprintf(out, "frames %u, %.1f per minute\n", c->frames, c->frames / minutes);
+    fprintf(out, "pixels painted %llu, %.0f per minute\n", (unsigned long long)c->pixels, c->pixels / minutes);
+    fprintf(out, "draw calls: fill %u, text %u, bitmap %u\n", c->fill_rects, c->text_draws, c->bitmap_draws);
+    // every draw call paints one rect: a fill, a text box or a bitmap
+    uint32_t rects = c->fill_rects + c->text_draws + c->bitmap_draws;
+    fprintf(out, "rects drawn %u, %.1f per minute, %.1f per frame, %.0f pixels per frame\n", rects, rects / minutes,
+            c->frames ? (double)rects / c->frames : 0, c->frames ? (double)c->pixels / c->frames : 0);
+    fprintf(out, "font loads %u\n", c->font_loads);
+    fprintf(out, "outbox %u messages (%u bytes), inbox %u messages (%u bytes)\n",
+            c->outbox_sends, c->outbox_bytes, c->inbox_messages, c->inbox_bytes);
+    fprintf(out, "health api calls %u, %.1f per hour (sums %u, averages %u)\n",
+            c->health_calls, hours > 0 ? c->health_calls / hours : 0, c->health_sum_calls, c->health_average_calls);
+    fprintf(out, "health api calls by hour of day:");
+    for (int hour = 0; hour < 24; ++hour) {
+        fprintf(out, " %u", c->health_hour_calls[hour]);
+    }
+    fprintf(out, "\n");
+    fprintf(out, "vibrations %u\n", c->vibrations);
+    fprintf(out, "heap allocations %u, used %zu, peak %zu of %d\n", c->allocs, heap_used, heap_peak, HEAP_LIMIT);
+}
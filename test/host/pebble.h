@@ -0,0 +1,514 @@
+#ifndef __TIMEBOXED_HOST_PEBBLE_
+#define __TIMEBOXED_HOST_PEBBLE_
+
+// a small stand-in for the Pebble SDK header, enough to compile src/*.c on the
+// host. the services behind it are faked in pebble.c and driven by host.h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined PBL_PLATFORM_CHALK
+#define PBL_ROUND
+#define PBL_IF_ROUND_ELSE(a, b) (a)
+#define PBL_IF_RECT_ELSE(a, b) (b)
+#else
+#define PBL_RECT
+#define PBL_IF_ROUND_ELSE(a, b) (b)
+#define PBL_IF_RECT_ELSE(a, b) (a)
+#endif
+
+#if defined PBL_COLOR
+#define PBL_IF_COLOR_ELSE(a, b) (a)
+#else
+#define PBL_IF_COLOR_ELSE(a, b) (b)
+#endif
+
+#define APP_LOG_LEVEL_ERROR 1
+#define APP_LOG_LEVEL_WARNING 50
+#define APP_LOG_LEVEL_INFO 100
+#define APP_LOG_LEVEL_DEBUG 200
+#define APP_LOG_LEVEL_DEBUG_VERBOSE 255
+void host_log(uint8_t level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+#define APP_LOG(level, fmt, ...) host_log(level, fmt, ##__VA_ARGS__)
+
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof((array)[0]))
+#define SECONDS_PER_MINUTE 60
+#define SECONDS_PER_HOUR 3600
+#define SECONDS_PER_DAY 86400
+#define TRIG_MAX_ANGLE 0x10000
+#define TRIGANGLE_TO_DEG(angle) (((angle) * 360) / TRIG_MAX_ANGLE)
+#define DEG_TO_TRIGANGLE(angle) (((angle) * TRIG_MAX_ANGLE) / 360)
+#define TZ_LEN 32
+#define PERSIST_DATA_MAX_LENGTH 256
+#define PERSIST_STRING_MAX_LENGTH PERSIST_DATA_MAX_LENGTH
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+// the app's clock and heap are the simulated ones
+time_t host_time(time_t *tloc);
+void *host_malloc(size_t size);
+void *host_calloc(size_t count, size_t size);
+void *host_realloc(void *ptr, size_t size);
+void host_free(void *ptr);
+#if !defined HOST_SDK_IMPL
+#define time(tloc) host_time(tloc)
+#define malloc(size) host_malloc(size)
+#define calloc(count, size) host_calloc(count, size)
+#define realloc(ptr, size) host_realloc(ptr, size)
+#define free(ptr) host_free(ptr)
+#endif
+
+// graphics types
+
+typedef struct GPoint { int16_t x; int16_t y; } GPoint;
+typedef struct GSize { int16_t w; int16_t h; } GSize;
+typedef struct GRect { GPoint origin; GSize size; } GRect;
+#define GPoint(x, y) ((GPoint){ (x), (y) })
+#define GPointZero GPoint(0, 0)
+#define GSize(w, h) ((GSize){ (w), (h) })
+#define GSizeZero GSize(0, 0)
+#define GRect(x, y, w, h) ((GRect){ { (x), (y) }, { (w), (h) } })
+#define GRectZero GRect(0, 0, 0, 0)
+bool grect_equal(const GRect *a, const GRect *b);
+bool gpoint_equal(const GPoint *a, const GPoint *b);
+bool gsize_equal(const GSize *a, const GSize *b);
+
+typedef union GColor8 {
+    uint8_t argb;
+} GColor8;
+typedef GColor8 GColor;
+#define GColorFromHEX(hex) host_color_from_hex(hex)
+#define GColorFromRGB(r, g, b) host_color_from_hex(((r) << 16) | ((g) << 8) | (b))
+GColor8 host_color_from_hex(uint32_t hex);
+#define GColorBlackARGB8 ((uint8_t)0xC0)
+#define GColorWhiteARGB8 ((uint8_t)0xFF)
+#define GColorClearARGB8 ((uint8_t)0x00)
+#define GColorBlack ((GColor8){ .argb = GColorBlackARGB8 })
+#define GColorWhite ((GColor8){ .argb = GColorWhiteARGB8 })
+#define GColorClear ((GColor8){ .argb = GColorClearARGB8 })
+bool gcolor_equal(GColor8 a, GColor8 b);
+
+typedef enum { GTextAlignmentLeft, GTextAlignmentCenter, GTextAlignmentRight } GTextAlignment;
+typedef enum { GTextOverflowModeWordWrap, GTextOverflowModeTrailingEllipsis, GTextOverflowModeFill } GTextOverflowMode;
+typedef enum { GCompOpAssign, GCompOpAssignInverted, GCompOpOr, GCompOpAnd, GCompOpClear, GCompOpSet } GCompOp;
+typedef enum {
+    GBitmapFormat1Bit,
+    GBitmapFormat8Bit,
+    GBitmapFormat1BitPalette,
+    GBitmapFormat2BitPalette,
+    GBitmapFormat4BitPalette,
+    GBitmapFormat8BitCircular,
+} GBitmapFormat;
+#define GCornerNone 0
+
+typedef struct HostFont *GFont;
+typedef struct GContext GContext;
+typedef struct GBitmap GBitmap;
+typedef struct GTextAttributes GTextAttributes;
+typedef struct {
+    uint8_t *data;
+    int16_t min_x;
+    int16_t max_x;
+} GBitmapDataRowInfo;
+
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+GBitmap *gbitmap_create_blank_with_palette(GSize size, GBitmapFormat format, GColor *palette, bool free_on_destroy);
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *parent, GRect sub_rect);
+void gbitmap_destroy(GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+void gbitmap_set_bounds(GBitmap *bitmap, GRect bounds);
+uint8_t *gbitmap_get_data(const GBitmap *bitmap);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+GBitmapFormat gbitmap_get_format(const GBitmap *bitmap);
+void gbitmap_set_palette(GBitmap *bitmap, GColor *palette, bool free_on_destroy);
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y);
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, int corner_mask);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_draw_text(GContext *ctx, const char *text, const GFont font, const GRect box,
+        const GTextOverflowMode overflow_mode, const GTextAlignment alignment, GTextAttributes *text_attributes);
+GSize graphics_text_layout_get_content_size(const char *text, const GFont font, const GRect box,
+        const GTextOverflowMode overflow_mode, const GTextAlignment alignment);
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+
+// fonts and resources
+
+typedef struct HostResource *ResHandle;
+ResHandle resource_get_handle(uint32_t resource_id);
+size_t resource_size(ResHandle handle);
+GFont fonts_get_system_font(const char *font_key);
+GFont fonts_load_custom_font(ResHandle handle);
+void fonts_unload_custom_font(GFont font);
+
+#define FONT_KEY_GOTHIC_14 "RESOURCE_ID_GOTHIC_14"
+#define FONT_KEY_GOTHIC_18 "RESOURCE_ID_GOTHIC_18"
+#define FONT_KEY_GOTHIC_18_BOLD "RESOURCE_ID_GOTHIC_18_BOLD"
+#define FONT_KEY_GOTHIC_24_BOLD "RESOURCE_ID_GOTHIC_24_BOLD"
+#define FONT_KEY_GOTHIC_28_BOLD "RESOURCE_ID_GOTHIC_28_BOLD"
+#define FONT_KEY_ROBOTO_BOLD_SUBSET_49 "RESOURCE_ID_ROBOTO_BOLD_SUBSET_49"
+
+// same order as the media list in package.json
+enum {
+    RESOURCE_ID_FONT_WEATHER_24 = 1,
+    RESOURCE_ID_FONT_WEATHER_16,
+    RESOURCE_ID_FONT_ICONS_20,
+    RESOURCE_ID_FONT_BLOCKO_19,
+    RESOURCE_ID_FONT_BLOCKO_32,
+    RESOURCE_ID_FONT_BLOCKO_64,
+    RESOURCE_ID_FONT_BLOCKO_16,
+    RESOURCE_ID_FONT_BLOCKO_24,
+    RESOURCE_ID_FONT_BLOCKO_56,
+    RESOURCE_ID_FONT_LECO_14,
+    RESOURCE_ID_FONT_LECO_21,
+    RESOURCE_ID_FONT_LECO_47,
+    RESOURCE_ID_FONT_KONSTRUCT_11,
+    RESOURCE_ID_FONT_KONSTRUCT_17,
+    RESOURCE_ID_FONT_KONSTRUCT_33,
+    RESOURCE_ID_FONT_ARCHIVO_18,
+    RESOURCE_ID_FONT_ARCHIVO_28,
+    RESOURCE_ID_FONT_ARCHIVO_56,
+    RESOURCE_ID_FONT_DIN_20,
+    RESOURCE_ID_FONT_DIN_26,
+    RESOURCE_ID_FONT_DIN_58,
+    RESOURCE_ID_FONT_PROTOTYPE_16,
+    RESOURCE_ID_FONT_PROTOTYPE_22,
+    RESOURCE_ID_FONT_PROTOTYPE_48,
+    HOST_NUM_RESOURCES,
+};
+
+// layers and windows
+
+typedef struct Layer Layer;
+typedef struct TextLayer TextLayer;
+typedef struct Window Window;
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+typedef void (*WindowHandler)(Window *window);
+typedef struct {
+    WindowHandler load;
+    WindowHandler appear;
+    WindowHandler disappear;
+    WindowHandler unload;
+} WindowHandlers;
+
+Layer *layer_create(GRect frame);
+Layer *layer_create_with_data(GRect frame, size_t data_size);
+void *layer_get_data(const Layer *layer);
+void layer_destroy(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_mark_dirty(Layer *layer);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_remove_from_parent(Layer *child);
+void layer_set_hidden(Layer *layer, bool hidden);
+bool layer_get_hidden(const Layer *layer);
+void layer_set_frame(Layer *layer, GRect frame);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_bounds(Layer *layer, GRect bounds);
+GRect layer_get_bounds(const Layer *layer);
+GRect layer_get_unobstructed_bounds(const Layer *layer);
+Window *layer_get_window(const Layer *layer);
+
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+const char *text_layer_get_text(TextLayer *text_layer);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment text_alignment);
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode line_mode);
+GSize text_layer_get_content_size(TextLayer *text_layer);
+
+Window *window_create(void);
+void window_destroy(Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+Layer *window_get_root_layer(const Window *window);
+void window_set_background_color(Window *window, GColor background_color);
+void window_stack_push(Window *window, bool animated);
+
+// time and timers
+
+typedef enum {
+    SECOND_UNIT = 1 << 0,
+    MINUTE_UNIT = 1 << 1,
+    HOUR_UNIT = 1 << 2,
+    DAY_UNIT = 1 << 3,
+    MONTH_UNIT = 1 << 4,
+    YEAR_UNIT = 1 << 5,
+} TimeUnits;
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+time_t time_start_of_today(void);
+bool clock_is_24h_style(void);
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer);
+
+size_t heap_bytes_used(void);
+size_t heap_bytes_free(void);
+void app_event_loop(void);
+
+typedef void (*AppFocusHandler)(bool in_focus);
+typedef struct {
+    AppFocusHandler will_focus;
+    AppFocusHandler did_focus;
+} AppFocusHandlers;
+void app_focus_service_subscribe_handlers(AppFocusHandlers handlers);
+void app_focus_service_unsubscribe(void);
+
+// storage
+
+bool persist_exists(const uint32_t key);
+int persist_get_size(const uint32_t key);
+int32_t persist_read_int(const uint32_t key);
+bool persist_read_bool(const uint32_t key);
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size);
+int persist_read_string(const uint32_t key, char *buffer, const size_t buffer_size);
+int persist_write_int(const uint32_t key, const int32_t value);
+int persist_write_bool(const uint32_t key, const bool value);
+int persist_write_data(const uint32_t key, const void *data, const size_t size);
+int persist_write_string(const uint32_t key, const char *cstring);
+int persist_delete(const uint32_t key);
+
+// messaging
+
+typedef enum {
+    TUPLE_BYTE_ARRAY = 0,
+    TUPLE_CSTRING = 1,
+    TUPLE_UINT = 2,
+    TUPLE_INT = 3,
+} TupleType;
+
+typedef struct __attribute__((__packed__)) {
+    uint32_t key;
+    TupleType type:8;
+    uint16_t length;
+    union {
+        uint8_t data[0];
+        char cstring[0];
+        uint8_t uint8;
+        uint16_t uint16;
+        uint32_t uint32;
+        int8_t int8;
+        int16_t int16;
+        int32_t int32;
+    } value[];
+} Tuple;
+
+typedef struct DictionaryIterator {
+    uint8_t *begin;
+    uint8_t *end;
+    uint8_t *limit;
+    Tuple *cursor;
+} DictionaryIterator;
+
+typedef enum {
+    DICT_OK = 0,
+    DICT_NOT_ENOUGH_STORAGE = 1 << 1,
+    DICT_INVALID_ARGS = 1 << 2,
+} DictionaryResult;
+
+Tuple *dict_find(const DictionaryIterator *iter, const uint32_t key);
+Tuple *dict_read_first(DictionaryIterator *iter);
+Tuple *dict_read_next(DictionaryIterator *iter);
+DictionaryResult dict_write_data(DictionaryIterator *iter, const uint32_t key, const uint8_t *data, const uint16_t size);
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, const uint32_t key, const char *cstring);
+DictionaryResult dict_write_int(DictionaryIterator *iter, const uint32_t key, const void *integer, const uint8_t width_bytes, const bool is_signed);
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, const uint32_t key, const uint8_t value);
+DictionaryResult dict_write_uint32(DictionaryIterator *iter, const uint32_t key, const uint32_t value);
+DictionaryResult dict_write_int32(DictionaryIterator *iter, const uint32_t key, const int32_t value);
+
+typedef enum {
+    APP_MSG_OK = 0,
+    APP_MSG_SEND_TIMEOUT = 1 << 1,
+    APP_MSG_SEND_REJECTED = 1 << 2,
+    APP_MSG_NOT_CONNECTED = 1 << 3,
+    APP_MSG_APP_NOT_RUNNING = 1 << 4,
+    APP_MSG_INVALID_ARGS = 1 << 5,
+    APP_MSG_BUSY = 1 << 6,
+    APP_MSG_BUFFER_OVERFLOW = 1 << 7,
+    APP_MSG_ALREADY_RELEASED = 1 << 9,
+    APP_MSG_OUT_OF_MEMORY = 1 << 10,
+} AppMessageResult;
+
+typedef void (*AppMessageInboxReceived)(DictionaryIterator *iterator, void *context);
+typedef void (*AppMessageInboxDropped)(AppMessageResult reason, void *context);
+typedef void (*AppMessageOutboxSent)(DictionaryIterator *iterator, void *context);
+typedef void (*AppMessageOutboxFailed)(DictionaryIterator *iterator, AppMessageResult reason, void *context);
+AppMessageResult app_message_open(const uint32_t size_inbound, const uint32_t size_outbound);
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator);
+AppMessageResult app_message_outbox_send(void);
+void app_message_register_inbox_received(AppMessageInboxReceived received_callback);
+void app_message_register_inbox_dropped(AppMessageInboxDropped dropped_callback);
+void app_message_register_outbox_sent(AppMessageOutboxSent sent_callback);
+void app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback);
+uint32_t app_message_inbox_size_maximum(void);
+uint32_t app_message_outbox_size_maximum(void);
+
+// event services
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+    bool did_vibrate;
+    uint64_t timestamp;
+} AccelData;
+typedef enum { ACCEL_AXIS_X = 0, ACCEL_AXIS_Y = 1, ACCEL_AXIS_Z = 2 } AccelAxisType;
+typedef enum {
+    ACCEL_SAMPLING_10HZ = 10,
+    ACCEL_SAMPLING_25HZ = 25,
+    ACCEL_SAMPLING_50HZ = 50,
+    ACCEL_SAMPLING_100HZ = 100,
+} AccelSamplingRate;
+typedef void (*AccelDataHandler)(AccelData *data, uint32_t num_samples);
+typedef void (*AccelTapHandler)(AccelAxisType axis, int32_t direction);
+void accel_data_service_subscribe(uint32_t samples_per_update, AccelDataHandler handler);
+void accel_data_service_unsubscribe(void);
+int accel_service_set_sampling_rate(AccelSamplingRate rate);
+int accel_service_set_samples_per_update(uint32_t num_samples);
+void accel_tap_service_subscribe(AccelTapHandler handler);
+void accel_tap_service_unsubscribe(void);
+
+typedef struct {
+    uint8_t charge_percent;
+    bool is_charging;
+    bool is_plugged;
+} BatteryChargeState;
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+void battery_state_service_unsubscribe(void);
+BatteryChargeState battery_state_service_peek(void);
+
+typedef void (*ConnectionHandler)(bool connected);
+typedef struct {
+    ConnectionHandler pebble_app_connection_handler;
+    ConnectionHandler pebblekit_connection_handler;
+} ConnectionHandlers;
+void connection_service_subscribe(ConnectionHandlers conn_handlers);
+void connection_service_unsubscribe(void);
+bool connection_service_peek_pebble_app_connection(void);
+bool bluetooth_connection_service_peek(void);
+
+bool quiet_time_is_active(void);
+
+typedef struct {
+    const uint32_t *durations;
+    uint32_t num_segments;
+} VibePattern;
+void vibes_enqueue_custom_pattern(VibePattern pattern);
+void vibes_short_pulse(void);
+void vibes_long_pulse(void);
+void vibes_double_pulse(void);
+
+typedef int32_t AnimationProgress;
+typedef void (*UnobstructedAreaWillChangeHandler)(GRect final_unobstructed_screen_area, void *context);
+typedef void (*UnobstructedAreaChangeHandler)(AnimationProgress progress, void *context);
+typedef void (*UnobstructedAreaDidChangeHandler)(void *context);
+typedef struct {
+    UnobstructedAreaWillChangeHandler will_change;
+    UnobstructedAreaChangeHandler change;
+    UnobstructedAreaDidChangeHandler did_change;
+} UnobstructedAreaHandlers;
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void *context);
+void unobstructed_area_service_unsubscribe(void);
+
+typedef int32_t CompassHeading;
+typedef enum {
+    CompassStatusUnavailable = -1,
+    CompassStatusDataInvalid = 0,
+    CompassStatusCalibrating,
+    CompassStatusCalibrated,
+} CompassStatus;
+typedef struct {
+    CompassHeading magnetic_heading;
+    CompassHeading true_heading;
+    CompassStatus compass_status;
+    bool is_declination_valid;
+} CompassHeadingData;
+typedef void (*CompassHeadingHandler)(CompassHeadingData heading);
+void compass_service_subscribe(CompassHeadingHandler handler);
+void compass_service_unsubscribe(void);
+int compass_service_set_heading_filter(CompassHeading filter);
+int compass_service_peek(CompassHeadingData *data);
+
+// health
+
+typedef enum {
+    HealthMetricStepCount,
+    HealthMetricActiveSeconds,
+    HealthMetricWalkedDistanceMeters,
+    HealthMetricSleepSeconds,
+    HealthMetricSleepRestfulSeconds,
+    HealthMetricRestingKCalories,
+    HealthMetricActiveKCalories,
+    HealthMetricHeartRateBPM,
+    HealthMetricHeartRateRawBPM,
+    HOST_NUM_HEALTH_METRICS,
+} HealthMetric;
+typedef int32_t HealthValue;
+typedef enum {
+    HealthServiceAccessibilityMaskAvailable = 1 << 0,
+    HealthServiceAccessibilityMaskNoPermission = 1 << 1,
+    HealthServiceAccessibilityMaskNotSupported = 1 << 2,
+    HealthServiceAccessibilityMaskNotAvailable = 1 << 3,
+} HealthServiceAccessibilityMask;
+typedef enum {
+    HealthServiceTimeScopeOnce,
+    HealthServiceTimeScopeWeekly,
+    HealthServiceTimeScopeDailyWeekdayOrWeekend,
+    HealthServiceTimeScopeDaily,
+} HealthServiceTimeScope;
+typedef enum {
+    HealthEventSignificantUpdate,
+    HealthEventMovementUpdate,
+    HealthEventSleepUpdate,
+    HealthEventMetricAlert,
+    HealthEventHeartRateUpdate,
+} HealthEventType;
+typedef enum {
+    HealthActivityNone = 0,
+    HealthActivitySleep = 1 << 0,
+    HealthActivityRestfulSleep = 1 << 1,
+    HealthActivityWalk = 1 << 2,
+    HealthActivityRun = 1 << 3,
+    HealthActivityOpenWorkout = 1 << 4,
+} HealthActivity;
+typedef uint32_t HealthActivityMask;
+typedef enum {
+    MeasurementSystemUnknown,
+    MeasurementSystemMetric,
+    MeasurementSystemImperial,
+} MeasurementSystem;
+typedef void (*HealthEventHandler)(HealthEventType event, void *context);
+
+HealthServiceAccessibilityMask health_service_metric_accessible(HealthMetric metric, time_t time_start, time_t time_end);
+HealthServiceAccessibilityMask health_service_metric_averaged_accessible(HealthMetric metric,
+        time_t time_start, time_t time_end, HealthServiceTimeScope scope);
+HealthValue health_service_sum_today(HealthMetric metric);
+HealthValue health_service_sum(HealthMetric metric, time_t time_start, time_t time_end);
+HealthValue health_service_sum_averaged(HealthMetric metric, time_t time_start, time_t time_end, HealthServiceTimeScope scope);
+HealthValue health_service_peek_current_value(HealthMetric metric);
+HealthActivityMask health_service_peek_current_activities(void);
+bool health_service_events_subscribe(HealthEventHandler handler, void *context);
+bool health_service_events_unsubscribe(void);
+MeasurementSystem health_service_get_measurement_system_for_display(HealthMetric metric);
+
+#endif
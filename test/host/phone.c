@@ -0,0 +1,111 @@
+// the phone side of the link: answers the watch's requests like app.js would,
+// after the time a fetch usually takes
+
+#include <pebble.h>
+#include "keys.h"
+#include "host.h"
+#include "phone.h"
+
+#define PHONE_BUFFER 512
+
+static uint8_t phone_level = 70;
+static bool phone_charging;
+static uint32_t phone_requests[PHONE_REQUESTS];
+
+uint32_t phone_request_count(uint8_t request) {
+    return phone_requests[request];
+}
+
+static void write_int16(uint8_t *bytes, int16_t value) {
+    bytes[0] = value & 0xFF;
+    bytes[1] = (value >> 8) & 0xFF;
+}
+
+static void write_int32(uint8_t *bytes, int32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+static void send_weather(void) {
+    uint8_t buffer[PHONE_BUFFER];
+    DictionaryIterator iter;
+    host_dict_init(&iter, buffer, sizeof(buffer));
+
+    time_t now = time(NULL);
+    int16_t temp = 12 + (now / SECONDS_PER_HOUR) % 8;
+    int32_t sunrise = (int32_t)(now - now % SECONDS_PER_DAY + 6 * SECONDS_PER_HOUR + 40 * SECONDS_PER_MINUTE);
+    int32_t sunset = sunrise + 13 * SECONDS_PER_HOUR;
+
+    #if defined HOST_LEGACY_WEATHER
+    dict_write_int32(&iter, KEY_TEMP, temp);
+    dict_write_int32(&iter, KEY_MAX, temp + 4);
+    dict_write_int32(&iter, KEY_MIN, temp - 5);
+    dict_write_int32(&iter, KEY_WEATHER, 3);
+    dict_write_int32(&iter, KEY_SPEED, 14);
+    dict_write_int32(&iter, KEY_DIRECTION, 225);
+    dict_write_int32(&iter, KEY_SUNRISE, sunrise);
+    dict_write_int32(&iter, KEY_SUNSET, sunset);
+    #else
+    uint8_t payload[20] = { 1, 3 };
+    write_int16(payload + 2, temp);
+    write_int16(payload + 4, temp + 4);
+    write_int16(payload + 6, temp - 5);
+    write_int16(payload + 8, 14);
+    write_int16(payload + 10, 225);
+    write_int32(payload + 12, sunrise);
+    write_int32(payload + 16, sunset);
+    dict_write_data(&iter, KEY_WEATHERDATA, payload, sizeof(payload));
+    #endif
+
+    host_deliver_inbox(PHONE_FETCH_MS, buffer, host_dict_size(&iter));
+}
+
+static void send_crypto(void) {
+    uint8_t buffer[PHONE_BUFFER];
+    DictionaryIterator iter;
+    host_dict_init(&iter, buffer, sizeof(buffer));
+    time_t now = time(NULL);
+    char price[16];
+    snprintf(price, sizeof(price), "%d", (int)(61000 + now / SECONDS_PER_MINUTE % 500));
+    dict_write_cstring(&iter, KEY_CRYPTOPRICE, price);
+    snprintf(price, sizeof(price), "%d", (int)(2400 + now / SECONDS_PER_MINUTE % 50));
+    dict_write_cstring(&iter, KEY_CRYPTOPRICEB, price);
+    host_deliver_inbox(PHONE_FETCH_MS, buffer, host_dict_size(&iter));
+}
+
+static void send_phone_battery(void) {
+    uint8_t buffer[PHONE_BUFFER];
+    DictionaryIterator iter;
+    host_dict_init(&iter, buffer, sizeof(buffer));
+    dict_write_int32(&iter, KEY_PHONEBATTERY_LEVEL, phone_level);
+    dict_write_int32(&iter, KEY_PHONEBATTERY_CHARGING, phone_charging);
+    host_deliver_inbox(PHONE_FETCH_MS / 4, buffer, host_dict_size(&iter));
+    if (phone_level > 5) {
+        phone_level--;
+    }
+}
+
+void phone_on_message(DictionaryIterator *iter) {
+    if (dict_find(iter, KEY_REQUESTWEATHER)) {
+        phone_requests[PHONE_WEATHER]++;
+        send_weather();
+    }
+    if (dict_find(iter, KEY_REQUESTCRYPTO)) {
+        phone_requests[PHONE_CRYPTO]++;
+        send_crypto();
+    }
+    if (dict_find(iter, KEY_REQUESTPHONEBATTERY)) {
+        phone_requests[PHONE_BATTERY]++;
+        send_phone_battery();
+    }
+    // revisions before the config report have no key for it
+    #if defined KEY_CONFIGDONE
+    Tuple *config = dict_find(iter, KEY_CONFIGDONE);
+    if (config) {
+        // the watch says which config it holds, 0 when none came from a phone
+        phone_requests[PHONE_CONFIG]++;
+        host_log(APP_LOG_LEVEL_DEBUG, "watch holds config %d", (int)config->value->int32);
+    }
+    #endif
+}
@@ -0,0 +1,17 @@
+#ifndef __TIMEBOXED_HOST_PHONE_
+#define __TIMEBOXED_HOST_PHONE_
+
+#include <pebble.h>
+
+#define PHONE_FETCH_MS 2000
+
+#define PHONE_WEATHER 0
+#define PHONE_CRYPTO 1
+#define PHONE_BATTERY 2
+#define PHONE_CONFIG 3
+#define PHONE_REQUESTS 4
+
+void phone_on_message(DictionaryIterator *iter);
+uint32_t phone_request_count(uint8_t request);
+
+#endif
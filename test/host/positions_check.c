@@ -0,0 +1,110 @@
+// compares the position tables in src/positions.c with the switch functions
+// they replaced (legacy/positions.c) for every font, alignment, slot, item and
+// mode, on every screen height the unobstructed area can leave. the first
+// difference fails the run.
+
+#include <pebble.h>
+#include "keys.h"
+#include "positions.h"
+#include "positions_legacy.h"
+
+#define NUM_FONTS 8
+#define NUM_SLOTS 6
+#define NUM_ITEMS 30
+#define MIN_HEIGHT 100
+
+static const GTextAlignment alignments[] = { GTextAlignmentLeft, GTextAlignmentCenter, GTextAlignmentRight };
+static const char *text_names[] = { "hours", "date", "bluetooth", "quiettime", "updates" };
+
+// the old functions left the position undefined for items the platform
+// cannot show, so those are not compared
+static bool legacy_has_item(int item) {
+    switch (item) {
+        case STEPS_ITEM:
+        case DIST_ITEM:
+        case CAL_ITEM:
+        case SLEEP_ITEM:
+        case DEEP_ITEM:
+        case ACTIVE_ITEM:
+        case HEART_ITEM:
+        case HEARTICON_ITEM:
+            #if defined(PBL_HEALTH)
+            return true;
+            #else
+            return false;
+            #endif
+        case CUSTOMTEXT_ITEM:
+        case PHONEBATTERY_ITEM:
+        case CRYPTO_ITEM:
+        case TIMEZONEB_ITEM:
+            #if !defined PBL_PLATFORM_APLITE
+            return true;
+            #else
+            return false;
+            #endif
+    }
+    return true;
+}
+
+static bool same_point(GPoint a, GPoint b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+static int check_text(int font, int align, int width, int height) {
+    struct TextPositions now, before;
+    get_text_positions(font, alignments[align], &now, width, height);
+    legacy_get_text_positions(font, alignments[align], &before, width, height);
+    GPoint *a = &now.hours, *b = &before.hours;
+    for (int i = 0; i < (int)ARRAY_LENGTH(text_names); ++i) {
+        if (!same_point(a[i], b[i])) {
+            fprintf(stderr, "%s for font %d, alignment %d, %dx%d: %d,%d but %d,%d before\n",
+                    text_names[i], font, align, width, height, a[i].x, a[i].y, b[i].x, b[i].y);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int check_item(int slot, int item, int mode, int font, int width, int height) {
+    GPoint now = get_pos_for_item(slot, item, mode, font, width, height);
+    GPoint before = legacy_get_pos_for_item(slot, item, mode, font, width, height);
+    if (!same_point(now, before)) {
+        fprintf(stderr, "item %d in slot %d, mode %d, font %d, %dx%d: %d,%d but %d,%d before\n",
+                item, slot, mode, font, width, height, now.x, now.y, before.x, before.y);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int width = PBL_IF_ROUND_ELSE(180, 144);
+    int full_height = PBL_IF_ROUND_ELSE(180, 168);
+    int checked = 0;
+
+    for (int height = MIN_HEIGHT; height <= full_height; ++height) {
+        for (int font = 0; font < NUM_FONTS; ++font) {
+            for (int align = 0; align < (int)ARRAY_LENGTH(alignments); ++align) {
+                if (check_text(font, align, width, height)) {
+                    return 1;
+                }
+                checked++;
+            }
+            for (int mode = MODE_NORMAL; mode <= MODE_SIMPLE; ++mode) {
+                for (int slot = -1; slot < NUM_SLOTS; ++slot) {
+                    for (int item = 0; item < NUM_ITEMS; ++item) {
+                        if (!legacy_has_item(item)) {
+                            continue;
+                        }
+                        if (check_item(slot, item, mode, font, width, height)) {
+                            return 1;
+                        }
+                        checked++;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("the tables and the old functions agree on all %d positions\n", checked);
+    return 0;
+}
@@ -0,0 +1,10 @@
+// the position functions from before the tables, renamed so they can be linked
+// next to the ones in src/
+
+#include "positions_legacy.h"
+
+#define create_point legacy_create_point
+#define get_text_positions legacy_get_text_positions
+#define get_slot_positions legacy_get_slot_positions
+#define get_pos_for_item legacy_get_pos_for_item
+#include "legacy/positions.c"
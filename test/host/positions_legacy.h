@@ -0,0 +1,12 @@
+#ifndef __TIMEBOXED_HOST_POSITIONS_LEGACY_
+#define __TIMEBOXED_HOST_POSITIONS_LEGACY_
+
+#include <pebble.h>
+#include "positions.h"
+
+GPoint legacy_create_point(int x, int y);
+GPoint legacy_get_pos_for_item(int slot, int item, int mode, int font, int width, int height);
+void legacy_get_text_positions(int selected_font, GTextAlignment alignment, struct TextPositions* positions, int width, int height);
+GPoint legacy_get_slot_positions(int mode, int slot, int width, int height, int font);
+
+#endif
@@ -0,0 +1,39 @@
+#include <pebble.h>
+#include "keys.h"
+#include "scenario.h"
+
+void scenario_seed_config(void) {
+    // written the way the config page did before the settings record, which
+    // every revision of the watchface still reads
+    persist_write_int(KEY_CONFIGS, FLAG_WEATHER | FLAG_HEALTH | FLAG_SLEEP | FLAG_BLUETOOTH |
+            FLAG_TIMEZONES | FLAG_TAP | FLAG_CELSIUS);
+    persist_write_int(KEY_FONTTYPE, LECO_FONT);
+    persist_write_int(KEY_WEATHERTIME, 30);
+    persist_write_int(KEY_CRYPTOTIME, 15);
+    persist_write_int(KEY_TAPTIME, 7);
+
+    persist_write_int(KEY_SLOTA, MODULE_WEATHER);
+    persist_write_int(KEY_SLOTB, MODULE_FORECAST);
+    persist_write_int(KEY_SLOTC, MODULE_STEPS);
+    persist_write_int(KEY_SLOTD, MODULE_BATTERY);
+    persist_write_int(KEY_SLOTE, MODULE_TIMEZONE);
+    persist_write_int(KEY_SLOTF, MODULE_CRYPTO);
+
+    persist_write_int(KEY_SLEEPSLOTA, MODULE_SLEEP);
+    persist_write_int(KEY_SLEEPSLOTB, MODULE_DEEP);
+    persist_write_int(KEY_SLEEPSLOTC, MODULE_NONE);
+    persist_write_int(KEY_SLEEPSLOTD, MODULE_NONE);
+    persist_write_int(KEY_SLEEPSLOTE, MODULE_NONE);
+    persist_write_int(KEY_SLEEPSLOTF, MODULE_NONE);
+
+    persist_write_int(KEY_TAPSLOTA, MODULE_HEART);
+    persist_write_int(KEY_TAPSLOTB, MODULE_DIST);
+    persist_write_int(KEY_TAPSLOTC, MODULE_CAL);
+    persist_write_int(KEY_TAPSLOTD, MODULE_ACTIVE);
+    persist_write_int(KEY_TAPSLOTE, MODULE_NONE);
+    persist_write_int(KEY_TAPSLOTF, MODULE_NONE);
+
+    persist_write_string(KEY_TIMEZONESCODE, "NYC");
+    persist_write_int(KEY_TIMEZONES, -4);
+    persist_write_int(KEY_TIMEZONESMINUTES, 0);
+}
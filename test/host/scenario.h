@@ -0,0 +1,23 @@
+#ifndef __TIMEBOXED_HOST_SCENARIO_
+#define __TIMEBOXED_HOST_SCENARIO_
+
+#include <pebble.h>
+
+// monday 12 october 2026, 00:00 utc
+#define SCENARIO_START 1791763200
+
+#if defined PBL_PLATFORM_APLITE
+#define SCENARIO_PLATFORM "aplite"
+#elif defined PBL_PLATFORM_CHALK
+#define SCENARIO_PLATFORM "chalk"
+#elif defined PBL_PLATFORM_DIORITE
+#define SCENARIO_PLATFORM "diorite"
+#else
+#define SCENARIO_PLATFORM "basalt"
+#endif
+
+// a typical configured watch: weather, forecast, steps, battery, a second
+// timezone and a crypto price in the six slots, sleep and tap states set up
+void scenario_seed_config(void);
+
+#endif
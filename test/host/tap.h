@@ -0,0 +1,36 @@
+#ifndef __TIMEBOXED_HOST_TAP_
+#define __TIMEBOXED_HOST_TAP_
+
+#include <pebble.h>
+
+// everything the tap detector in accel.c keeps between batches
+struct TapState {
+    int pass_x, pass_y, pass_z;
+    int last_x, last_y, last_z;
+    bool begin_tap, mid_tap, end_tap, neg;
+    int mid_tap_count, end_tap_count;
+    bool show_tap_mode;
+};
+
+// copies the detector's statics; only usable in a file that includes accel.c
+#define TAP_STATE_COPY(state) do { \
+    (state)->pass_x = lastPassX; (state)->pass_y = lastPassY; (state)->pass_z = lastPassZ; \
+    (state)->last_x = lastX; (state)->last_y = lastY; (state)->last_z = lastZ; \
+    (state)->begin_tap = begin_tap; (state)->mid_tap = mid_tap; \
+    (state)->end_tap = end_tap; (state)->neg = neg; \
+    (state)->mid_tap_count = mid_tap_count; (state)->end_tap_count = end_tap_count; \
+    (state)->show_tap_mode = show_tap_mode; \
+} while (0)
+
+// the detector in src/
+void tap_current_handler(AccelData *data, uint32_t num_samples);
+void tap_current_reset(void);
+void tap_current_state(struct TapState *state);
+bool tap_current_quiet(AccelData *data, uint32_t num_samples);
+
+// the one from before quiet batches were skipped, in legacy/
+void tap_legacy_handler(AccelData *data, uint32_t num_samples);
+void tap_legacy_reset(void);
+void tap_legacy_state(struct TapState *state);
+
+#endif
@@ -0,0 +1,21 @@
+// the tap detector in src/accel.c, built into this file so the replay can
+// read its state and ask whether a batch is quiet
+
+#include "tap.h"
+
+#define accel_data_handler tap_current_handler
+#define reset_tap_handler tap_current_reset
+#define tap_mode_visible tap_current_mode_visible
+#define wrist_mode_visible tap_current_wrist_visible
+#define reset_wrist_handler tap_current_reset_wrist
+#define shake_data_handler tap_current_shake
+#define init_accel_service tap_current_init
+#include "accel.c"
+
+void tap_current_state(struct TapState *state) {
+    TAP_STATE_COPY(state);
+}
+
+bool tap_current_quiet(AccelData *data, uint32_t num_samples) {
+    return is_quiet_batch(data, num_samples);
+}
@@ -0,0 +1,16 @@
+// the tap detector from before quiet batches were skipped, built the same way
+
+#include "tap.h"
+
+#define accel_data_handler tap_legacy_handler
+#define reset_tap_handler tap_legacy_reset
+#define tap_mode_visible tap_legacy_mode_visible
+#define wrist_mode_visible tap_legacy_wrist_visible
+#define reset_wrist_handler tap_legacy_reset_wrist
+#define shake_data_handler tap_legacy_shake
+#define init_accel_service tap_legacy_init
+#include "legacy/accel.c"
+
+void tap_legacy_state(struct TapState *state) {
+    TAP_STATE_COPY(state);
+}
@@ -0,0 +1,294 @@
+// replays labelled accelerometer traces through the tap detector and reports
+// how many of the taps it finds (recall) and how many of its detections were
+// taps (precision). every batch also goes through the detector from before
+// quiet batches were skipped, and the two must end every batch in the same
+// state; the first difference fails the run.
+//
+// the traces are synthetic: a wrist at rest, walking, typing, turning and
+// under vibration, with flicks and knocks of various strengths mixed in.
+
+#include <pebble.h>
+#include <math.h>
+#include "tap.h"
+
+#define RATE 25
+#define BATCH 25
+#define MAX_SAMPLES (600 * RATE)
+#define MAX_TAPS 128
+// the face shows the tap modules for a few seconds and ignores the sensor meanwhile
+#define TAP_DISPLAY_BATCHES 3
+
+struct Recording {
+    AccelData samples[MAX_SAMPLES];
+    int count;
+    int taps[MAX_TAPS];
+    int num_taps;
+};
+
+struct Trace {
+    const char *name;
+    void (*generate)(struct Recording *recording);
+};
+
+struct Detector {
+    void (*handler)(AccelData *data, uint32_t num_samples);
+    void (*reset)(void);
+    void (*state)(struct TapState *state);
+    int display;
+};
+
+// the detector's callbacks into the rest of the face
+void redraw_screen(Window *watchface) {
+}
+
+int get_tap_timeout() {
+    return TAP_DISPLAY_BATCHES;
+}
+
+bool is_tap_enabled() {
+    return true;
+}
+
+bool is_wrist_enabled() {
+    return false;
+}
+
+static uint32_t seed;
+
+static int random_int(int low, int high) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return low + (int)(seed % (uint32_t)(high - low + 1));
+}
+
+static int noise(int amount) {
+    return (random_int(-amount, amount) + random_int(-amount, amount)) / 2;
+}
+
+static void rest(struct Recording *recording, int seconds, int amount) {
+    recording->count = seconds * RATE;
+    for (int i = 0; i < recording->count; ++i) {
+        recording->samples[i] = (AccelData) {
+            .x = noise(amount), .y = -30 + noise(amount), .z = -1000 + noise(amount),
+        };
+    }
+}
+
+static void walk(struct Recording *recording, int seconds) {
+    recording->count = seconds * RATE;
+    for (int i = 0; i < recording->count; ++i) {
+        double t = (double)i / RATE;
+        recording->samples[i] = (AccelData) {
+            .x = (int16_t)(150 * sin(2 * M_PI * 0.9 * t)) + noise(25),
+            .y = -30 + (int16_t)(80 * cos(2 * M_PI * 0.9 * t)) + noise(25),
+            .z = -1000 + (int16_t)(220 * sin(2 * M_PI * 1.8 * t)) + noise(25),
+        };
+    }
+}
+
+// a flick: the wrist jolts one way and snaps back; a knock only jolts
+static void tap(struct Recording *recording, int at, int strength, bool flick) {
+    int sign = random_int(0, 1) ? 1 : -1;
+    recording->samples[at].z += sign * strength;
+    if (flick) {
+        recording->samples[at + 1].z -= sign * strength;
+    }
+    recording->taps[recording->num_taps++] = at;
+}
+
+static void tap_every(struct Recording *recording, int seconds, int low, int high) {
+    for (int at = seconds * RATE / 2; at < recording->count - RATE && recording->num_taps < MAX_TAPS; at += seconds * RATE) {
+        tap(recording, at + random_int(0, RATE / 2), random_int(low, high), random_int(0, 2) > 0);
+    }
+}
+
+static void desk(struct Recording *recording) {
+    rest(recording, 600, 6);
+}
+
+static void taps(struct Recording *recording) {
+    rest(recording, 300, 6);
+    tap_every(recording, 10, 250, 600);
+}
+
+static void soft_taps(struct Recording *recording) {
+    rest(recording, 300, 6);
+    tap_every(recording, 10, 100, 250);
+}
+
+static void walking(struct Recording *recording) {
+    walk(recording, 600);
+}
+
+static void walking_taps(struct Recording *recording) {
+    walk(recording, 360);
+    tap_every(recording, 12, 400, 700);
+}
+
+static void typing(struct Recording *recording) {
+    rest(recording, 300, 10);
+    for (int at = 0; at < recording->count; at += random_int(RATE / 3, RATE)) {
+        recording->samples[at].z += random_int(40, 140);
+    }
+}
+
+static void turning(struct Recording *recording) {
+    rest(recording, 300, 8);
+    // raise the wrist to look at the face and lower it again every 8 seconds
+    for (int start = RATE; start + 55 < recording->count; start += 8 * RATE) {
+        for (int i = 0; i < 55; ++i) {
+            int lift = i < 15 ? i : i < 40 ? 15 : 55 - i;
+            recording->samples[start + i].z += lift * 800 / 15;
+            recording->samples[start + i].x += lift * 600 / 15;
+        }
+    }
+}
+
+static void vibrating(struct Recording *recording) {
+    rest(recording, 300, 6);
+    for (int start = 10 * RATE; start + RATE < recording->count; start += 20 * RATE) {
+        for (int i = start; i < start + RATE; ++i) {
+            recording->samples[i].did_vibrate = true;
+            recording->samples[i].z += noise(300);
+        }
+    }
+}
+
+static const struct Trace traces[] = {
+    { "desk", desk },
+    { "taps", taps },
+    { "soft taps", soft_taps },
+    { "walking", walking },
+    { "walking + taps", walking_taps },
+    { "typing", typing },
+    { "turning", turning },
+    { "vibrating", vibrating },
+};
+
+static struct Detector current = { tap_current_handler, tap_current_reset, tap_current_state };
+static struct Detector legacy = { tap_legacy_handler, tap_legacy_reset, tap_legacy_state };
+
+// hides the tap modules again once they have been shown long enough
+static void tick(struct Detector *detector) {
+    if (detector->display > 0 && --detector->display == 0) {
+        detector->reset();
+    }
+}
+
+// feeds one batch and returns whether it set off a tap
+static bool feed(struct Detector *detector, AccelData *batch) {
+    struct TapState before;
+    detector->state(&before);
+    detector->handler(batch, BATCH);
+    struct TapState after;
+    detector->state(&after);
+    if (!before.show_tap_mode && after.show_tap_mode) {
+        detector->display = TAP_DISPLAY_BATCHES;
+        return true;
+    }
+    return false;
+}
+
+static bool same_state(struct TapState *a, struct TapState *b) {
+    return a->pass_x == b->pass_x && a->pass_y == b->pass_y && a->pass_z == b->pass_z &&
+        a->last_x == b->last_x && a->last_y == b->last_y && a->last_z == b->last_z &&
+        a->begin_tap == b->begin_tap && a->mid_tap == b->mid_tap && a->end_tap == b->end_tap &&
+        a->neg == b->neg && a->mid_tap_count == b->mid_tap_count &&
+        a->end_tap_count == b->end_tap_count && a->show_tap_mode == b->show_tap_mode;
+}
+
+static void print_state(const char *name, struct TapState *state) {
+    fprintf(stderr, "  %-7s pass %d,%d,%d last %d,%d,%d tap %d%d%d neg %d counts %d,%d shown %d\n", name,
+            state->pass_x, state->pass_y, state->pass_z, state->last_x, state->last_y, state->last_z,
+            state->begin_tap, state->mid_tap, state->end_tap, state->neg,
+            state->mid_tap_count, state->end_tap_count, state->show_tap_mode);
+}
+
+static void print_ratio(int part, int whole) {
+    if (whole) {
+        printf("  %8.1f%%", 100.0 * part / whole);
+    } else {
+        printf("  %9s", "-");
+    }
+}
+
+static struct Recording recording;
+
+int main(int argc, char **argv) {
+    int total_taps = 0, total_found = 0, total_false = 0, total_batches = 0, total_quiet = 0;
+
+    // settle both filters on a still wrist first
+    seed = 1;
+    rest(&recording, 1, 0);
+    feed(&current, recording.samples);
+    feed(&legacy, recording.samples);
+
+    printf("%-16s %8s %6s %6s %6s %10s %9s %7s\n", "trace", "batches", "taps", "found", "false", "precision", "recall", "quiet");
+    for (int t = 0; t < (int)ARRAY_LENGTH(traces); ++t) {
+        memset(&recording, 0, sizeof(recording));
+        seed = 2463534242u + t;
+        traces[t].generate(&recording);
+
+        bool matched[MAX_TAPS] = { false };
+        int found = 0, false_taps = 0, quiet = 0;
+        int batches = recording.count / BATCH;
+        for (int b = 0; b < batches; ++b) {
+            AccelData batch[BATCH];
+            memcpy(batch, recording.samples + b * BATCH, sizeof(batch));
+            tick(&current);
+            tick(&legacy);
+            if (!current.display && tap_current_quiet(batch, BATCH)) {
+                quiet++;
+            }
+            bool detected = feed(&current, batch);
+            memcpy(batch, recording.samples + b * BATCH, sizeof(batch));
+            feed(&legacy, batch);
+
+            struct TapState now, before;
+            current.state(&now);
+            legacy.state(&before);
+            if (!same_state(&now, &before) || current.display != legacy.display) {
+                fprintf(stderr, "%s, batch %d: the detector left a different state than before\n", traces[t].name, b);
+                print_state("current", &now);
+                print_state("legacy", &before);
+                return 1;
+            }
+
+            if (!detected) {
+                continue;
+            }
+            // a tap counts if it was detected in its own batch or the next one
+            bool hit = false;
+            for (int i = 0; i < recording.num_taps && !hit; ++i) {
+                int tap_batch = recording.taps[i] / BATCH;
+                if (!matched[i] && b >= tap_batch && b <= tap_batch + 1) {
+                    matched[i] = hit = true;
+                }
+            }
+            if (hit) {
+                found++;
+            } else {
+                false_taps++;
+            }
+        }
+
+        printf("%-16s %8d %6d %6d %6d", traces[t].name, batches, recording.num_taps, found, false_taps);
+        print_ratio(found, found + false_taps);
+        print_ratio(found, recording.num_taps);
+        printf("  %5.0f%%\n", 100.0 * quiet / batches);
+
+        total_taps += recording.num_taps;
+        total_found += found;
+        total_false += false_taps;
+        total_batches += batches;
+        total_quiet += quiet;
+    }
+
+    printf("%-16s %8d %6d %6d %6d", "all", total_batches, total_taps, total_found, total_false);
+    print_ratio(total_found, total_found + total_false);
+    print_ratio(total_found, total_taps);
+    printf("  %5.0f%%\n", 100.0 * total_quiet / total_batches);
+    printf("\nthe old and new handlers agree on all %d batches\n", total_batches);
+    return 0;
+}
@@ -0,0 +1,120 @@
+'use strict';
+
+var assert = require('assert');
+var harness = require('./harness');
+
+var CONFIG = {
+    hoursColor: '0xFFFFFF',
+    bgColor: '0x000000',
+    slotA: '1',
+    slotB: '4',
+    fontType: '2',
+    weatherTime: '30',
+    customTextAText: 'Grüße',
+};
+
+function configure(phone, config) {
+    phone.emit('webviewclosed', { response: JSON.stringify(config) });
+}
+
+function sentKeys(phone) {
+    var keys = [];
+    phone.messages.forEach(function(message) {
+        keys = keys.concat(Object.keys(message));
+    });
+    return keys;
+}
+
+async function settle(phone) {
+    var count = -1;
+    while (count !== phone.messages.length) {
+        count = phone.messages.length;
+        await harness.wait(30);
+    }
+}
+
+module.exports = {
+    'only changed settings are sent, tagged with a generation': async function() {
+        var phone = harness.createApp();
+        configure(phone, CONFIG);
+        await settle(phone);
+        assert.strictEqual(phone.messages.length, 1);
+        var generation = phone.messages[0].KEY_CONFIGDONE;
+        assert.ok(generation > 0, 'generation ' + generation);
+        assert.strictEqual(phone.messages[0].KEY_HOURSCOLOR, 0xffffff);
+
+        phone.messages.length = 0;
+        configure(phone, Object.assign({}, CONFIG, { slotA: '2' }));
+        await settle(phone);
+        assert.deepStrictEqual(sentKeys(phone).sort(), ['KEY_CONFIGDONE', 'KEY_SLOTA']);
+        assert.notStrictEqual(phone.messages[0].KEY_CONFIGDONE, generation);
+
+        phone.messages.length = 0;
+        configure(phone, Object.assign({}, CONFIG, { slotA: '2' }));
+        await settle(phone);
+        assert.strictEqual(phone.messages.length, 0);
+    },
+
+    'another watch on the same phone gets the full config': async function() {
+        var storage = {};
+        var first = harness.createApp({ storage: storage, watchToken: 'first' });
+        configure(first, CONFIG);
+        await settle(first);
+
+        var second = harness.createApp({ storage: storage, watchToken: 'second' });
+        configure(second, CONFIG);
+        await settle(second);
+        assert.strictEqual(sentKeys(second).length, Object.keys(CONFIG).length + 1);
+
+        var again = harness.createApp({ storage: storage, watchToken: 'first' });
+        configure(again, CONFIG);
+        await settle(again);
+        assert.strictEqual(again.messages.length, 0);
+    },
+
+    'a watch without our config gets all of it again': async function() {
+        var phone = harness.createApp();
+        configure(phone, CONFIG);
+        await settle(phone);
+        var generation = phone.messages[0].KEY_CONFIGDONE;
+
+        // the watch reports what it holds when it starts
+        phone.messages.length = 0;
+        phone.emit('appmessage', { payload: { KEY_CONFIGDONE: generation } });
+        await settle(phone);
+        assert.strictEqual(phone.messages.length, 0);
+
+        // reinstalled: nothing stored
+        phone.emit('appmessage', { payload: { KEY_CONFIGDONE: 0 } });
+        await settle(phone);
+        assert.strictEqual(sentKeys(phone).length, Object.keys(CONFIG).length + 1);
+        assert.strictEqual(phone.messages[phone.messages.length - 1].KEY_CONFIGDONE, generation);
+
+        // and once that is acknowledged the same report is quiet again
+        phone.messages.length = 0;
+        phone.emit('appmessage', { payload: { KEY_CONFIGDONE: generation } });
+        await settle(phone);
+        assert.strictEqual(phone.messages.length, 0);
+    },
+
+    'chunks fit the inbox counting UTF-8 bytes': async function() {
+        var config = {};
+        for (var i = 0; i < 12; ++i) {
+            // 3 bytes per character on the wire, one code unit in JS
+            config['customText' + i] = new Array(40).join('€');
+        }
+        var phone = harness.createApp({ platform: 'aplite' });
+        configure(phone, config);
+        await settle(phone);
+
+        assert.ok(phone.messages.length > 1, 'split into ' + phone.messages.length);
+        phone.messages.forEach(function(message) {
+            var size = 1;
+            Object.keys(message).forEach(function(key) {
+                var value = message[key];
+                size += 7 + (typeof value === 'string' ? Buffer.byteLength(value) + 1 : 4);
+            });
+            assert.ok(size <= phone.app.INBOX_SIZE_APLITE, 'chunk of ' + size + ' bytes');
+        });
+    },
+};
@@ -0,0 +1,145 @@
+'use strict';
+
+var assert = require('assert');
+var harness = require('./harness');
+var server = require('./server');
+
+var CRYPTO = /^min-api\.cryptocompare\.com\/data\/pricemulti/;
+
+function pairs(storage) {
+    storage.cryptoFrom = 'BTC';
+    storage.cryptoTo = 'USD';
+    storage.cryptoMarket = 'Coinbase';
+    storage.cryptoMulti = 'false';
+    storage.cryptoFromB = 'ETH';
+    storage.cryptoToB = 'USD';
+    storage.cryptoMarketB = 'Kraken';
+    storage.cryptoMultiB = 'false';
+    // the config page always saves every multiplier
+    storage.cryptoMultiC = 'false';
+    storage.cryptoMultiD = 'false';
+    return storage;
+}
+
+async function withServer(routes, test) {
+    var fixtures = await server.start(routes);
+    try {
+        await test(fixtures);
+    } finally {
+        await fixtures.close();
+    }
+}
+
+module.exports = {
+    'prices go out as each market answers': async function() {
+        await withServer([
+            { match: /e=Coinbase/, fixture: 'crypto-coinbase.json' },
+            { match: /e=Kraken/, fixture: 'crypto-kraken.json', delay: 300 },
+        ], async function(fixtures) {
+            var phone = harness.createApp({ server: fixtures.url, storage: pairs({}) });
+            phone.emit('appmessage', { payload: { KEY_REQUESTCRYPTO: 1 } });
+
+            await harness.waitFor(function() {
+                return phone.messages.length === 1;
+            }, 'the first market');
+            assert.deepStrictEqual(phone.messages[0], { KEY_CRYPTOPRICE: '61234.5' });
+
+            await harness.waitFor(function() {
+                return phone.messages.length === 2;
+            }, 'the slow market');
+            assert.deepStrictEqual(phone.messages[1], { KEY_CRYPTOPRICEB: '2412.3' });
+            assert.strictEqual(fixtures.count(CRYPTO), 2);
+        });
+    },
+
+    'a market that hangs times out without holding up the others': async function() {
+        await withServer([
+            { match: /e=Coinbase/, fixture: 'crypto-coinbase.json' },
+            { match: /e=Kraken/, hang: true },
+        ], async function(fixtures) {
+            var phone = harness.createApp({ server: fixtures.url, storage: pairs({}) });
+            phone.app.XHR_TIMEOUT = 100;
+            phone.emit('appmessage', { payload: { KEY_REQUESTCRYPTO: 1 } });
+
+            await harness.waitFor(function() {
+                return phone.logs.indexOf('Error requesting crypto for Kraken') !== -1;
+            }, 'the timeout');
+            assert.deepStrictEqual(phone.messages, [{ KEY_CRYPTOPRICE: '61234.5' }]);
+        });
+    },
+
+    'an error is sent when every market times out': async function() {
+        await withServer([{ match: CRYPTO, hang: true }], async function(fixtures) {
+            var phone = harness.createApp({ server: fixtures.url, storage: pairs({}) });
+            phone.app.XHR_TIMEOUT = 100;
+            phone.emit('appmessage', { payload: { KEY_REQUESTCRYPTO: 1 } });
+
+            await harness.waitFor(function() {
+                return phone.messages.length === 1;
+            }, 'the error');
+            assert.deepStrictEqual(phone.messages[0], { KEY_ERROR: true });
+        });
+    },
+
+    'prices that arrive while a message is in flight are merged': async function() {
+        await withServer([
+            { match: /e=Coinbase/, fixture: 'crypto-coinbase.json' },
+            { match: /e=Kraken/, fixture: 'crypto-kraken.json' },
+        ], async function(fixtures) {
+            var phone = harness.createApp({ server: fixtures.url, storage: pairs({}) });
+            phone.emit('appmessage', { payload: { KEY_REQUESTCRYPTO: 1 } });
+            await harness.waitFor(function() {
+                return fixtures.count(CRYPTO) === 2 && phone.logs.indexOf('Got crypto for Kraken') !== -1 &&
+                    phone.logs.indexOf('Got crypto for Coinbase') !== -1;
+            }, 'both markets');
+            await harness.wait(50);
+
+            var prices = {};
+            phone.messages.forEach(function(message) {
+                Object.keys(message).forEach(function(key) {
+                    prices[key] = message[key];
+                });
+            });
+            assert.deepStrictEqual(prices, { KEY_CRYPTOPRICE: '61234.5', KEY_CRYPTOPRICEB: '2412.3' });
+
+            // a second request within the ttl is answered from the cache in one message
+            phone.messages.length = 0;
+            phone.emit('appmessage', { payload: { KEY_REQUESTCRYPTO: 1 } });
+            await harness.wait(20);
+            assert.deepStrictEqual(phone.messages, [prices]);
+            assert.strictEqual(fixtures.count(CRYPTO), 2);
+        });
+    },
+
+    'a request after a restart within the ttl makes no request': async function() {
+        await withServer([
+            { match: /e=Coinbase/, fixture: 'crypto-coinbase.json' },
+            { match: /e=Kraken/, fixture: 'crypto-kraken.json' },
+        ], async function(fixtures) {
+            var storage = pairs({});
+            var phone = harness.createApp({ server: fixtures.url, storage: storage });
+            phone.emit('appmessage', { payload: { KEY_REQUESTCRYPTO: 1 } });
+            await harness.waitFor(function() {
+                return fixtures.count(CRYPTO) === 2 && phone.logs.indexOf('Got crypto for Kraken') !== -1 &&
+                    phone.logs.indexOf('Got crypto for Coinbase') !== -1;
+            }, 'both markets');
+
+            // the js is restarted, and the watch asks again when the face comes back
+            var restarted = harness.createApp({ server: fixtures.url, storage: storage });
+            restarted.advance(3 * 60 * 1000);
+            restarted.emit('appmessage', { payload: { KEY_REQUESTCRYPTO: 1 } });
+            await harness.waitFor(function() {
+                return restarted.messages.length === 1;
+            }, 'the cached prices');
+            assert.deepStrictEqual(restarted.messages[0], { KEY_CRYPTOPRICE: '61234.5', KEY_CRYPTOPRICEB: '2412.3' });
+            assert.strictEqual(fixtures.count(CRYPTO), 2);
+
+            // the next scheduled refresh, 5 minutes at the shortest, downloads them again
+            restarted.advance(2 * 60 * 1000);
+            restarted.emit('appmessage', { payload: { KEY_REQUESTCRYPTO: 1 } });
+            await harness.waitFor(function() {
+                return fixtures.count(CRYPTO) === 4;
+            }, 'a new download');
+        });
+    },
+};
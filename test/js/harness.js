@@ -0,0 +1,224 @@
+// runs src/js/app.js the way PebbleKit JS does, in one global scope with
+// Pebble, localStorage, navigator and XMLHttpRequest provided by the phone.
+// here they are fakes: messages to the watch are recorded and acked, and every
+// request goes to the local fixture server instead.
+'use strict';
+
+var fs = require('fs');
+var http = require('http');
+var path = require('path');
+var vm = require('vm');
+var Module = require('module');
+
+var APP = path.join(__dirname, '../../src/js/app.js');
+var APP_SOURCE = fs.readFileSync(APP, 'utf8');
+
+function createXhr(server) {
+    function FakeXMLHttpRequest() {
+        this.status = 0;
+        this.responseText = '';
+        this.timeout = 0;
+    }
+
+    FakeXMLHttpRequest.prototype.open = function(type, url) {
+        // http(s)://host/path?query is served as http://server/host/path?query
+        var target = new URL(url);
+        this.method = type;
+        this.url = server + '/' + target.host + target.pathname + target.search;
+    };
+
+    FakeXMLHttpRequest.prototype.send = function() {
+        var xhr = this;
+        var finished = false;
+        var finish = function(handler) {
+            if (finished) {
+                return;
+            }
+            finished = true;
+            clearTimeout(timer);
+            if (handler) {
+                handler.call(xhr);
+            }
+        };
+        var request = http.request(xhr.url, { method: xhr.method }, function(res) {
+            var body = '';
+            res.setEncoding('utf8');
+            res.on('data', function(chunk) {
+                body += chunk;
+            });
+            res.on('end', function() {
+                xhr.status = res.statusCode;
+                xhr.responseText = body;
+                finish(xhr.onload);
+            });
+        });
+        var timer = xhr.timeout ? setTimeout(function() {
+            request.destroy();
+            finish(xhr.ontimeout);
+        }, xhr.timeout) : null;
+        request.on('error', function() {
+            finish(xhr.onerror);
+        });
+        request.end();
+    };
+
+    return FakeXMLHttpRequest;
+}
+
+// options:
+//   server      base url of the fixture server
+//   platform    watch platform, basalt by default
+//   watchToken  what Pebble.getWatchToken() answers
+//   position    {latitude, longitude, accuracy}; location fails without one
+//   storage     localStorage contents to start from
+//   nack        function(message) returning true to refuse a message
+//   verbose     print the app's log
+function createApp(options) {
+    options = options || {};
+    var listeners = {};
+    var messages = [];
+    var logs = [];
+    var clock = { offset: 0 };
+    var storage = options.storage || {};
+    var fixes = { count: 0 };
+
+    var Pebble = {
+        platform: 'pebble',
+        addEventListener: function(name, callback) {
+            listeners[name] = callback;
+        },
+        sendAppMessage: function(data, success, failure) {
+            var message = JSON.parse(JSON.stringify(data));
+            messages.push(message);
+            var refused = options.nack && options.nack(message);
+            setTimeout(function() {
+                if (refused) {
+                    if (failure) {
+                        failure({ data: data }, 'NACK');
+                    }
+                } else if (success) {
+                    success({ data: data });
+                }
+            }, 5);
+        },
+        getActiveWatchInfo: function() {
+            return { platform: options.platform || 'basalt' };
+        },
+        getWatchToken: function() {
+            return options.watchToken || 'watch';
+        },
+        openURL: function() {},
+    };
+
+    var navigator = {
+        geolocation: {
+            getCurrentPosition: function(success, failure) {
+                fixes.count++;
+                setTimeout(function() {
+                    if (options.position) {
+                        success({ coords: options.position, timestamp: Date.now() });
+                    } else {
+                        failure({ code: 1, message: 'denied' });
+                    }
+                }, 1);
+            },
+        },
+    };
+
+    var context = vm.createContext({
+        Pebble: Pebble,
+        navigator: navigator,
+        localStorage: storage,
+        XMLHttpRequest: createXhr(options.server),
+        require: Module.createRequire(APP),
+        setTimeout: setTimeout,
+        clearTimeout: clearTimeout,
+        setInterval: setInterval,
+        clearInterval: clearInterval,
+        encodeURIComponent: encodeURIComponent,
+        console: {
+            log: function() {
+                var line = Array.prototype.join.call(arguments, ' ');
+                logs.push(line);
+                if (options.verbose) {
+                    console.log('  app: ' + line);
+                }
+            },
+        },
+        __clock: clock,
+    });
+    // lets a test move the app's clock forward without waiting
+    vm.runInContext(
+        '(function() { var now = Date.now; Date.now = function() { return now() + __clock.offset; }; })();',
+        context
+    );
+    vm.runInContext(APP_SOURCE, context, { filename: APP });
+
+    return {
+        app: context,
+        messages: messages,
+        logs: logs,
+        storage: storage,
+        fixes: fixes,
+        emit: function(name, event) {
+            listeners[name](event || {});
+        },
+        advance: function(ms) {
+            clock.offset += ms;
+        },
+    };
+}
+
+// reads back the KEY_WEATHERDATA bytes the way update_weather_from_payload does
+function unpackWeather(bytes) {
+    var offset = 1;
+    var read = function(size) {
+        var value = 0;
+        for (var i = 0; i < size; i++) {
+            value |= bytes[offset++] << (8 * i);
+        }
+        // sign extend the 16 bit fields
+        return size === 2 && value & 0x8000 ? value - 0x10000 : value;
+    };
+    return {
+        version: bytes[0],
+        condition: read(1),
+        temp: read(2),
+        max: read(2),
+        min: read(2),
+        speed: read(2),
+        direction: read(2),
+        sunrise: read(4),
+        sunset: read(4),
+    };
+}
+
+function wait(ms) {
+    return new Promise(function(resolve) {
+        setTimeout(resolve, ms);
+    });
+}
+
+// polls until check() is true, failing after a second by default
+function waitFor(check, what, timeout) {
+    var deadline = Date.now() + (timeout || 1000);
+    return new Promise(function(resolve, reject) {
+        var poll = function() {
+            if (check()) {
+                resolve();
+            } else if (Date.now() > deadline) {
+                reject(new Error('timed out waiting for ' + what));
+            } else {
+                setTimeout(poll, 5);
+            }
+        };
+        poll();
+    });
+}
+
+module.exports = {
+    createApp: createApp,
+    unpackWeather: unpackWeather,
+    wait: wait,
+    waitFor: waitFor,
+};
@@ -0,0 +1,101 @@
+'use strict';
+
+var assert = require('assert');
+var harness = require('./harness');
+var server = require('./server');
+
+var DARKSKY = /^api\.darksky\.net\/forecast\//;
+var LONDON = { latitude: 51.5012, longitude: -0.1241, accuracy: 20 };
+var MINUTE = 60 * 1000;
+
+function darkSky() {
+    return { weatherProvider: '3', forecastKey: 'key', useCelsius: 'false' };
+}
+
+function weatherMessages(phone) {
+    return phone.messages.filter(function(message) {
+        return message.KEY_WEATHERDATA;
+    });
+}
+
+// requests the weather and waits for the answer, from the cache or not
+async function requestWeather(phone) {
+    var count = weatherMessages(phone).length;
+    phone.emit('appmessage', { payload: { KEY_REQUESTWEATHER: 1 } });
+    await harness.waitFor(function() {
+        return weatherMessages(phone).length === count + 1;
+    }, 'a weather answer');
+}
+
+function counter(phone, name) {
+    return parseInt(phone.storage[name], 10) || 0;
+}
+
+async function withPhone(test) {
+    var fixtures = await server.start([{ match: DARKSKY, fixture: 'darksky.json' }]);
+    try {
+        var position = Object.assign({}, LONDON);
+        var phone = harness.createApp({ server: fixtures.url, storage: darkSky(), position: position });
+        await test(phone, position, fixtures);
+    } finally {
+        await fixtures.close();
+    }
+}
+
+module.exports = {
+    'a fresh fix is reused while we stay put': async function() {
+        await withPhone(async function(phone, position) {
+            await requestWeather(phone);
+            var stored = phone.storage.lastPosition;
+
+            // a few hundred metres of drift is within the radius
+            phone.advance(20 * MINUTE);
+            position.latitude += 0.003;
+            await requestWeather(phone);
+
+            assert.strictEqual(phone.storage.lastPosition, stored);
+            assert.ok(phone.logs.some(function(line) {
+                return line.indexOf('Reusing position from') === 0;
+            }), 'the last fix was not reused');
+        });
+    },
+
+    'a fix beyond the radius is used as the new position': async function() {
+        await withPhone(async function(phone, position, fixtures) {
+            await requestWeather(phone);
+
+            phone.advance(20 * MINUTE);
+            position.latitude += 0.05;
+            await requestWeather(phone);
+
+            // the coarse fix is taken as it is, without asking for another one
+            assert.strictEqual(phone.fixes.count, 2);
+            assert.strictEqual(JSON.parse(phone.storage.lastPosition).latitude, position.latitude);
+            assert.ok(phone.logs.some(function(line) {
+                return /^Moved \d+m, using the new fix$/.test(line);
+            }), 'the move was not noticed');
+            // and the weather follows it into the next cell
+            assert.strictEqual(fixtures.count(DARKSKY), 2);
+        });
+    },
+
+    'full and coarse fixes are counted': async function() {
+        await withPhone(async function(phone, position) {
+            await requestWeather(phone);
+            assert.deepStrictEqual([counter(phone, 'positionFixes'), counter(phone, 'positionCoarseFixes')], [1, 0]);
+
+            phone.advance(20 * MINUTE);
+            await requestWeather(phone);
+            phone.advance(20 * MINUTE);
+            position.latitude += 0.05;
+            await requestWeather(phone);
+            assert.deepStrictEqual([counter(phone, 'positionFixes'), counter(phone, 'positionCoarseFixes')], [1, 2]);
+
+            // once the last fix is too old a full one is taken again
+            phone.advance(2 * 60 * MINUTE);
+            await requestWeather(phone);
+            assert.deepStrictEqual([counter(phone, 'positionFixes'), counter(phone, 'positionCoarseFixes')], [2, 2]);
+            assert.strictEqual(phone.fixes.count, 4);
+        });
+    },
+};
@@ -0,0 +1,218 @@
+'use strict';
+
+var assert = require('assert');
+var harness = require('./harness');
+var server = require('./server');
+
+var DARKSKY = /^api\.darksky\.net\/forecast\//;
+var OPENWEATHER = /^api\.openweathermap\.org\/data\/2\.5\/weather/;
+var OPENWEATHER_FORECAST = /^api\.openweathermap\.org\/data\/3\.0\/onecall/;
+var WUNDERGROUND = /^api\.wunderground\.com\/api\//;
+var YAHOO_LOCATION = /^gws2\.maps\.yahoo\.com\/findlocation/;
+var YAHOO = /^query\.yahooapis\.com\/v1\/public\/yql/;
+
+var LONDON = { latitude: 51.5012, longitude: -0.1241, accuracy: 20 };
+
+var ROUTES = {
+    darksky: [{ match: DARKSKY, fixture: 'darksky.json' }],
+    openweathermap: [
+        { match: OPENWEATHER, fixture: 'openweathermap-current.json' },
+        { match: OPENWEATHER_FORECAST, fixture: 'openweathermap-onecall.json' },
+    ],
+    wunderground: [{ match: WUNDERGROUND, fixture: 'wunderground.json' }],
+    yahoo: [
+        { match: YAHOO_LOCATION, fixture: 'yahoo-findlocation.json' },
+        { match: YAHOO, fixture: 'yahoo.json' },
+    ],
+};
+
+// what each fixture normalises to, in fahrenheit and mph
+var DARKSKY_RECORD = {
+    condition: 6, temp: 59, max: 64, min: 50, speed: 8, direction: 225,
+    sunrise: 1791787200, sunset: 1791825600,
+};
+var OPENWEATHER_RECORD = {
+    condition: 3, temp: 62, max: 66, min: 50, speed: 9, direction: 200,
+    sunrise: 1791787260, sunset: 1791825540,
+};
+
+// wunderground and yahoo only give a local time of day for the sun
+function today(hours, minutes) {
+    var time = new Date();
+    time.setHours(hours);
+    time.setMinutes(minutes);
+    return parseInt(time.getTime() / 1000, 10);
+}
+
+function settings(provider, storage) {
+    storage = storage || {};
+    storage.weatherProvider = '' + provider;
+    storage.useCelsius = storage.useCelsius || 'false';
+    return storage;
+}
+
+function routes() {
+    var all = [];
+    for (var i = 0; i < arguments.length; i++) {
+        all = all.concat(arguments[i]);
+    }
+    return all;
+}
+
+// requests the weather once and collects what is sent for a while after the
+// first answer, before the server goes away
+async function fetchWeather(routeList, storage, prepare, linger) {
+    var fixtures = await server.start(routeList);
+    try {
+        var phone = harness.createApp({ server: fixtures.url, storage: storage, position: LONDON });
+        if (prepare) {
+            prepare(phone);
+        }
+        phone.emit('appmessage', { payload: { KEY_REQUESTWEATHER: 1 } });
+        await harness.waitFor(function() {
+            return phone.messages.length > 0;
+        }, 'an answer', 2000);
+        await harness.wait(linger || 100);
+        phone.fixtures = fixtures;
+        return phone;
+    } finally {
+        await fixtures.close();
+    }
+}
+
+function weather(phone) {
+    assert.strictEqual(phone.messages.length, 1, JSON.stringify(phone.messages));
+    assert.ok(phone.messages[0].KEY_WEATHERDATA, 'not weather: ' + JSON.stringify(phone.messages[0]));
+    var record = harness.unpackWeather(phone.messages[0].KEY_WEATHERDATA);
+    assert.strictEqual(record.version, 1);
+    delete record.version;
+    return record;
+}
+
+function assertSun(record, sunrise, sunset) {
+    assert.ok(Math.abs(record.sunrise - sunrise) < 60, 'sunrise ' + record.sunrise + ' vs ' + sunrise);
+    assert.ok(Math.abs(record.sunset - sunset) < 60, 'sunset ' + record.sunset + ' vs ' + sunset);
+    delete record.sunrise;
+    delete record.sunset;
+}
+
+module.exports = {
+    'dark sky is normalised': async function() {
+        var phone = await fetchWeather(ROUTES.darksky, settings(3, { forecastKey: 'key' }));
+        assert.deepStrictEqual(weather(phone), DARKSKY_RECORD);
+
+        phone = await fetchWeather(ROUTES.darksky, settings(3, { forecastKey: 'key', useCelsius: 'true' }));
+        var record = weather(phone);
+        assert.deepStrictEqual([record.temp, record.max, record.min], [15, 18, 10]);
+    },
+
+    'openweathermap is normalised': async function() {
+        var phone = await fetchWeather(ROUTES.openweathermap, settings(0, { openWeatherKey: 'key' }));
+        assert.deepStrictEqual(weather(phone), OPENWEATHER_RECORD);
+        assert.strictEqual(phone.fixtures.count(OPENWEATHER_FORECAST), 1);
+
+        phone = await fetchWeather(ROUTES.openweathermap, settings(0, { openWeatherKey: 'key', useCelsius: 'true' }));
+        var record = weather(phone);
+        assert.deepStrictEqual([record.temp, record.max, record.min], [17, 19, 10]);
+    },
+
+    'openweathermap without a forecast still answers': async function() {
+        var phone = await fetchWeather(
+            [{ match: OPENWEATHER, fixture: 'openweathermap-current.json' },
+                { match: OPENWEATHER_FORECAST, status: 401, body: '{"cod":401,"message":"no plan"}' }],
+            settings(0, { openWeatherKey: 'key' })
+        );
+        var record = weather(phone);
+        assert.deepStrictEqual([record.temp, record.max, record.min], [62, 0, 0]);
+    },
+
+    'weather underground is normalised': async function() {
+        var phone = await fetchWeather(ROUTES.wunderground, settings(1, { weatherKey: 'key' }));
+        var record = weather(phone);
+        assertSun(record, today(6, 41), today(17, 39));
+        assert.deepStrictEqual(record, { condition: 4, temp: 58, max: 63, min: 48, speed: 11, direction: 250 });
+    },
+
+    'yahoo is normalised': async function() {
+        var phone = await fetchWeather(ROUTES.yahoo, settings(2));
+        var record = weather(phone);
+        assertSun(record, today(6, 42), today(17, 38));
+        assert.deepStrictEqual(record, { condition: 5, temp: 58, max: 62, min: 47, speed: 7, direction: 240 });
+        assert.strictEqual(phone.storage['51.5012,-0.1241'], '44418');
+    },
+
+    'the backup joins when the primary misses the deadline': async function() {
+        var started = Date.now();
+        var phone = await fetchWeather(
+            routes([{ match: DARKSKY, hang: true }], ROUTES.openweathermap),
+            settings(3, { forecastKey: 'key', openWeatherKey: 'key' }),
+            function(phone) {
+                phone.app.WEATHER_FAILOVER_DEADLINE = 100;
+            }
+        );
+        assert.deepStrictEqual(weather(phone), OPENWEATHER_RECORD);
+        assert.ok(Date.now() - started < 1000);
+        assert.notStrictEqual(phone.logs.indexOf('Failing over to OpenWeatherMap'), -1);
+    },
+
+    'a failing primary fails over without waiting for the deadline': async function() {
+        var started = Date.now();
+        var phone = await fetchWeather(
+            routes([{ match: DARKSKY, status: 500, body: 'upstream error' }], ROUTES.openweathermap),
+            settings(3, { forecastKey: 'key', openWeatherKey: 'key' })
+        );
+        assert.deepStrictEqual(weather(phone), OPENWEATHER_RECORD);
+        assert.ok(Date.now() - started < 1000);
+        var stats = JSON.parse(phone.storage.weatherStats);
+        assert.deepStrictEqual([stats[3].requests, stats[3].errors], [1, 1]);
+        assert.deepStrictEqual([stats[0].requests, stats[0].errors], [1, 0]);
+    },
+
+    'keyless yahoo is the backup of last resort': async function() {
+        var phone = await fetchWeather(
+            routes([{ match: DARKSKY, status: 500, body: '' }], ROUTES.yahoo),
+            settings(3, { forecastKey: 'key' })
+        );
+        assert.strictEqual(weather(phone).condition, 5);
+        assert.strictEqual(phone.fixtures.count(OPENWEATHER), 0);
+    },
+
+    'an error is sent when every provider fails': async function() {
+        var phone = await fetchWeather(
+            [{ match: DARKSKY, status: 500, body: '' }, { match: OPENWEATHER, status: 500, body: '' }],
+            settings(3, { forecastKey: 'key', openWeatherKey: 'key' })
+        );
+        assert.deepStrictEqual(phone.messages, [{ KEY_ERROR: true }]);
+        // one backup only, yahoo is not tried as well
+        assert.strictEqual(phone.fixtures.count(YAHOO), 0);
+        assert.strictEqual(phone.storage.weatherCache, undefined);
+    },
+
+    'a late primary still answers when the backup fails': async function() {
+        var phone = await fetchWeather(
+            [{ match: DARKSKY, fixture: 'darksky.json', delay: 300 }, { match: OPENWEATHER, status: 500, body: '' }],
+            settings(3, { forecastKey: 'key', openWeatherKey: 'key' }),
+            function(phone) {
+                phone.app.WEATHER_FAILOVER_DEADLINE = 100;
+            }
+        );
+        assert.deepStrictEqual(weather(phone), DARKSKY_RECORD);
+    },
+
+    'an answer after the backup won is dropped': async function() {
+        var phone = await fetchWeather(
+            routes([{ match: DARKSKY, fixture: 'darksky.json', delay: 300 }], ROUTES.openweathermap),
+            settings(3, { forecastKey: 'key', openWeatherKey: 'key' }),
+            function(phone) {
+                phone.app.WEATHER_FAILOVER_DEADLINE = 100;
+            },
+            400
+        );
+        assert.deepStrictEqual(weather(phone), OPENWEATHER_RECORD);
+        // the late one is still counted for the provider stats
+        assert.strictEqual(JSON.parse(phone.storage.weatherStats)[3].errors, 0);
+        var cache = JSON.parse(phone.storage.weatherCache);
+        assert.deepStrictEqual(Object.keys(cache), ['3:f:2575,-6']);
+        assert.strictEqual(cache['3:f:2575,-6'].record.temp, OPENWEATHER_RECORD.temp);
+    },
+};
@@ -0,0 +1,43 @@
+// runs every *.test.js in this directory. a test file exports its tests as
+// named async functions; any that throws fails the run.
+//
+//   node test/js/run.js [filter]
+'use strict';
+
+var fs = require('fs');
+var path = require('path');
+
+var filter = process.argv[2] || '';
+
+async function main() {
+    var failed = 0;
+    var passed = 0;
+    var files = fs.readdirSync(__dirname).filter(function(name) {
+        return /\.test\.js$/.test(name);
+    }).sort();
+
+    for (var i = 0; i < files.length; ++i) {
+        var tests = require(path.join(__dirname, files[i]));
+        var names = Object.keys(tests);
+        for (var j = 0; j < names.length; ++j) {
+            var name = files[i].replace(/\.test\.js$/, '') + ': ' + names[j];
+            if (name.indexOf(filter) === -1) {
+                continue;
+            }
+            try {
+                await tests[names[j]]();
+                passed++;
+                console.log('ok - ' + name);
+            } catch (ex) {
+                failed++;
+                console.log('not ok - ' + name);
+                console.log('  ' + (ex.stack || ex).toString().split('\n').join('\n  '));
+            }
+        }
+    }
+
+    console.log('\n' + passed + ' passed, ' + failed + ' failed');
+    process.exit(failed ? 1 : 0);
+}
+
+main();
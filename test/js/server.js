@@ -0,0 +1,64 @@
+// a local stand-in for the weather and price APIs. each route matches
+// "host/path?query" and answers with a fixture from fixtures/, a status, a
+// delay, or never. every request is recorded so tests can count downloads.
+'use strict';
+
+var fs = require('fs');
+var http = require('http');
+var path = require('path');
+
+var FIXTURES = path.join(__dirname, 'fixtures');
+
+function fixture(name) {
+    return fs.readFileSync(path.join(FIXTURES, name), 'utf8');
+}
+
+// routes: [{ match: RegExp, fixture: 'file.json', body: '...', status: 200,
+//            delay: ms, hang: true }], the first match wins
+function start(routes) {
+    var requests = [];
+    var server = http.createServer(function(req, res) {
+        var target = req.url.slice(1);
+        requests.push(target);
+        var route = routes.filter(function(route) {
+            return route.match.test(target);
+        })[0];
+        if (!route) {
+            res.writeHead(404);
+            res.end('no fixture for ' + target);
+            return;
+        }
+        if (route.hang) {
+            return;
+        }
+        setTimeout(function() {
+            res.writeHead(route.status || 200, { 'Content-Type': 'application/json' });
+            res.end(route.fixture ? fixture(route.fixture) : route.body || '');
+        }, route.delay || 0);
+    });
+
+    return new Promise(function(resolve) {
+        server.listen(0, '127.0.0.1', function() {
+            resolve({
+                url: 'http://127.0.0.1:' + server.address().port,
+                requests: requests,
+                count: function(pattern) {
+                    return requests.filter(function(target) {
+                        return pattern.test(target);
+                    }).length;
+                },
+                close: function() {
+                    server.closeAllConnections();
+                    return new Promise(function(done) {
+                        server.close(done);
+                    });
+                },
+            });
+        });
+    });
+}
+
+module.exports = {
+    start: start,
+    fixture: fixture,
+};
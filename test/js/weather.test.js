@@ -0,0 +1,151 @@
+'use strict';
+
+var assert = require('assert');
+var harness = require('./harness');
+var server = require('./server');
+
+var DARKSKY = /^api\.darksky\.net\/forecast\//;
+var LONDON = { latitude: 51.5012, longitude: -0.1241, accuracy: 20 };
+
+function darkSky(storage) {
+    storage.weatherProvider = '3';
+    storage.forecastKey = 'key';
+    storage.useCelsius = 'false';
+    // a full fix on every request, so each one goes through the cache key
+    storage.positionMaxAge = '0';
+    return storage;
+}
+
+function requestWeather(phone) {
+    phone.emit('appmessage', { payload: { KEY_REQUESTWEATHER: 1 } });
+}
+
+function weatherMessages(phone) {
+    return phone.messages.filter(function(message) {
+        return message.KEY_WEATHERDATA;
+    });
+}
+
+async function withServer(routes, test) {
+    var fixtures = await server.start(routes);
+    try {
+        await test(fixtures);
+    } finally {
+        await fixtures.close();
+    }
+}
+
+module.exports = {
+    'a second request within the ttl is answered from the cache': async function() {
+        await withServer([{ match: DARKSKY, fixture: 'darksky.json' }], async function(fixtures) {
+            var phone = harness.createApp({ server: fixtures.url, storage: darkSky({}), position: LONDON });
+            requestWeather(phone);
+            await harness.waitFor(function() {
+                return weatherMessages(phone).length === 1;
+            }, 'the first answer');
+
+            phone.advance(14 * 60 * 1000);
+            requestWeather(phone);
+            await harness.waitFor(function() {
+                return weatherMessages(phone).length === 2;
+            }, 'the cached answer');
+
+            assert.strictEqual(fixtures.count(DARKSKY), 1);
+            assert.deepStrictEqual(weatherMessages(phone)[1], weatherMessages(phone)[0]);
+            assert.notStrictEqual(phone.logs.indexOf('Weather cache hit: 3:f:2575,-6'), -1);
+        });
+    },
+
+    'an expired entry is downloaded again': async function() {
+        await withServer([{ match: DARKSKY, fixture: 'darksky.json' }], async function(fixtures) {
+            var phone = harness.createApp({ server: fixtures.url, storage: darkSky({}), position: LONDON });
+            requestWeather(phone);
+            await harness.waitFor(function() {
+                return weatherMessages(phone).length === 1;
+            }, 'the first answer');
+
+            phone.advance(15 * 60 * 1000);
+            requestWeather(phone);
+            await harness.waitFor(function() {
+                return weatherMessages(phone).length === 2;
+            }, 'the second answer');
+            assert.strictEqual(fixtures.count(DARKSKY), 2);
+
+            // the configured ttl overrides the default
+            phone.storage.weatherCacheTtl = '60';
+            phone.advance(30 * 60 * 1000);
+            requestWeather(phone);
+            await harness.waitFor(function() {
+                return weatherMessages(phone).length === 3;
+            }, 'the third answer');
+            assert.strictEqual(fixtures.count(DARKSKY), 2);
+        });
+    },
+
+    'positions in the same cell share an entry': async function() {
+        var phone = harness.createApp();
+        var key = function(latitude, longitude, provider, useCelsius) {
+            return phone.app.getWeatherCacheKey(
+                { coords: { latitude: latitude, longitude: longitude } },
+                provider === undefined ? 3 : provider,
+                useCelsius || false,
+                ''
+            );
+        };
+        // cells are 0.02 degrees, about 2km north to south
+        assert.strictEqual(key(51.5012, -0.1241), '3:f:2575,-6');
+        assert.strictEqual(key(51.5049, -0.1299), key(51.5012, -0.1241));
+        assert.notStrictEqual(key(51.5112, -0.1241), key(51.5012, -0.1241));
+        assert.notStrictEqual(key(51.5012, -0.1241, 0), key(51.5012, -0.1241));
+        assert.notStrictEqual(key(51.5012, -0.1241, 3, true), key(51.5012, -0.1241));
+        // an override location is its own cell
+        assert.strictEqual(phone.app.getWeatherCacheKey(null, 3, true, 'London'), '3:c:London');
+
+        await withServer([{ match: DARKSKY, fixture: 'darksky.json' }], async function(fixtures) {
+            var position = Object.assign({}, LONDON);
+            var phone = harness.createApp({ server: fixtures.url, storage: darkSky({}), position: position });
+            requestWeather(phone);
+            await harness.waitFor(function() {
+                return weatherMessages(phone).length === 1;
+            }, 'the first answer');
+
+            position.latitude += 0.003;
+            requestWeather(phone);
+            await harness.waitFor(function() {
+                return weatherMessages(phone).length === 2;
+            }, 'an answer for the same cell');
+            assert.strictEqual(fixtures.count(DARKSKY), 1);
+
+            position.latitude += 0.05;
+            requestWeather(phone);
+            await harness.waitFor(function() {
+                return weatherMessages(phone).length === 3;
+            }, 'an answer for the next cell');
+            assert.strictEqual(fixtures.count(DARKSKY), 2);
+        });
+    },
+
+    'a request while one is in flight does not download again': async function() {
+        await withServer([{ match: DARKSKY, fixture: 'darksky.json', delay: 200 }], async function(fixtures) {
+            var phone = harness.createApp({ server: fixtures.url, storage: darkSky({}), position: LONDON });
+            requestWeather(phone);
+            await harness.wait(50);
+            requestWeather(phone);
+            await harness.waitFor(function() {
+                return weatherMessages(phone).length === 1;
+            }, 'the answer');
+            await harness.wait(50);
+
+            assert.strictEqual(fixtures.count(DARKSKY), 1);
+            assert.strictEqual(weatherMessages(phone).length, 1);
+            assert.notStrictEqual(phone.logs.indexOf('Weather request already in flight: 3:f:2575,-6'), -1);
+
+            // once answered the next request is a cache hit, not blocked
+            requestWeather(phone);
+            await harness.waitFor(function() {
+                return weatherMessages(phone).length === 2;
+            }, 'the cached answer');
+            assert.strictEqual(fixtures.count(DARKSKY), 1);
+        });
+    },
+};